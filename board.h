@@ -0,0 +1,230 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Board-Profile  ·  Pin-Belegung und Port-Tabellen zur Compile-Zeit
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Ausgewählt über das Chip-Makro von XC8 (bzw. -D beim Host-Build):
+ *
+ *   _16F84A    LEDs a–g = RB0–RB6, Taster RB7        Auto-Sleep
+ *              RC-Kalibrierung (BOARD_RC_CAL, abschaltbar: -DBOARD_RC_CAL=0)
+ *              Roll-Profile voll / sofort (BOARD_PROF_LITE, 1K Flash)
+ *   _16F1825   LEDs a–f = RC0–RC5, g = RA5, Taster RA4   Auto-Sleep + PWM
+ *              DICE_N = 2/3: Würfel-Auswahl RA0–RA2 (Multiplex)
+ *              Ereignis-Protokoll (BOARD_TRACE, abschaltbar: -DBOARD_TRACE=0)
+ *              Touch-Taste an RA2 statt Taster (BOARD_TOUCH, -DBOARD_TOUCH=1,
+ *              dann ohne Ereignis-Protokoll)
+ *              Roll-Profile (BOARD_PROFILES, abschaltbar: -DBOARD_PROFILES=0)
+ *
+ *  Die Würfelbilder sind nur einmal beschrieben (FACE_1 … FACE_6 über die
+ *  logischen LED-Bits). Jedes Profil legt per Makro fest, welcher Teil
+ *  eines Musters in welches Port-Register gehört; daraus entstehen beim
+ *  Übersetzen fertige Port-Werte je Seite. led_out(Seite) ist damit
+ *  reines Tabelle-Laden + Speichern (16F1825: LATC und LATA, 16F84A:
+ *  PORTB), ohne Maske und ohne Bit-Schieberei zur Laufzeit.
+ *
+ *  Seiten-Index: 0 … 5 = Würfelzahl 1 … 6, FACE_OFF = alle LEDs aus,
+ *  FACE_LOW = Batterie-Warnung (16F1825).
+ *  led_die(k, Seite) zeigt Würfel k (ohne Multiplex = led_out).
+ *
+ *  Daten-EEPROM: EE_SIZE Bytes, ee_read()/ee_write() byteweise (die
+ *  Register heißen je Chip anders, der Ring darüber ist gemeinsam).
+ *
+ *  Vor diesem Header: _XTAL_FREQ, #include <xc.h>, <stdint.h>
+ *  Vor der ersten Benutzung von MS(): TICK_US (Timer0-Tick der Firmware)
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef BOARD_H
+#define BOARD_H
+
+// ─── Logische LED-Bits (Würfel-Layout) ───────────────────────────────
+//  [A] [B]         ● ●
+//  [C] [D] [E]     ● ● ●
+//  [F]     [G]     ●   ●
+#define LED_A  (1u<<0)   // oben links
+#define LED_B  (1u<<1)   // oben rechts
+#define LED_C  (1u<<2)   // mitte links
+#define LED_D  (1u<<3)   // Zentrum (Auge)
+#define LED_E  (1u<<4)   // mitte rechts
+#define LED_F  (1u<<5)   // unten links
+#define LED_G  (1u<<6)   // unten rechts
+
+// ─── Würfelmuster ─────────────────────────────────────────────────────
+#define FACE_1  (LED_D)                                          // ⚀ Zentrum
+#define FACE_2  (LED_B | LED_F)                                  // ⚁ Diagonale
+#define FACE_3  (LED_B | LED_D | LED_F)                          // ⚂ Diagonale + Mitte
+#define FACE_4  (LED_A | LED_B | LED_F | LED_G)                  // ⚃ vier Ecken
+#define FACE_5  (LED_A | LED_B | LED_D | LED_F | LED_G)          // ⚄ Ecken + Mitte
+#define FACE_6  (LED_A | LED_B | LED_C | LED_E | LED_F | LED_G)  // ⚅ alle außer Mitte
+#define FACE_BAT (LED_C | LED_E)                                 // ─ ─ Batterie-Warnung (keine Würfelzahl)
+
+#define FACE_OFF  6u                     // Index: alle LEDs aus
+#define FACE_LOW  7u                     // Index: Batterie fast leer
+
+// Tabelle über alle Seiten + „aus“ + Warnung, abgebildet mit dem
+// Port-Makro PORT
+#define FACE_TABLE(PORT)  { PORT(FACE_1), PORT(FACE_2), PORT(FACE_3), \
+                            PORT(FACE_4), PORT(FACE_5), PORT(FACE_6), \
+                            PORT(0u), PORT(FACE_BAT) }
+
+#if defined(_16F84A)
+// ─── Profil PIC16F84A: alles auf PORTB ───────────────────────────────
+#if defined(DICE_N) && DICE_N != 1
+#error "Mehrere Würfel nur mit PIC16F1825 (Timer2-Multiplex)"
+#endif
+#if defined(BOARD_TRACE) && BOARD_TRACE
+#error "Ereignis-Protokoll nur mit PIC16F1825 (68 Byte RAM reichen nicht)"
+#endif
+#if defined(BOARD_TOUCH) && BOARD_TOUCH
+#error "Touch-Taste nur mit PIC16F1825 (CPS-Modul)"
+#endif
+//  RB0–RB6 = a–g (Bit = logisches Bit), RB7 = Taster-Eingang.
+//  Ganzes PORTB schreiben: Bit 7 landet nur im Ausgangs-Latch des
+//  Eingangs RB7 → kein PORTB-Lesen mehr in show() (RMW, RBIF-Verlust).
+#define BOARD_SLEEP     1                // Auto-Sleep, Wake über RB-Change (RB7)
+#define BOARD_PWM       0                // LEDs nur an/aus
+#define BOARD_TRACE     0                // kein RAM für den Ring
+#define BOARD_TOUCH     0                // kein CPS-Modul
+#ifndef BOARD_RC_CAL
+#define BOARD_RC_CAL    1                // Prüfplatz: 1 kHz an RA4 (abschaltbar: =0)
+#endif
+#ifndef BOARD_PROFILES
+#define BOARD_PROFILES  1                // abschaltbar: -DBOARD_PROFILES=0
+#endif
+#define BOARD_PROF_LITE 1                // nur voll / sofort, ohne ANIM_PROFILE
+#define PORTB_OF(p)     ((uint8_t)(p))
+
+static const uint8_t DICE_PORTB[8] = FACE_TABLE(PORTB_OF);
+
+#define BTN_IS_LOW()    (!(PORTB & (1u<<7)))
+
+#define DICE_N          1u
+#define led_die(k, f)   led_out(f)
+
+static void led_out(uint8_t f) {
+    PORTB = DICE_PORTB[f];
+}
+
+// ─── Daten-EEPROM: 64 Byte ────────────────────────────────────────────
+#define EE_SIZE         64u
+
+static uint8_t ee_read(uint8_t a) {
+    EEADR = a;
+    EECON1bits.RD = 1;
+    return EEDATA;
+}
+
+// 55/AA + WR als lückenlose Befehlsfolge (kein Interrupt dazwischen),
+// dann warten bis WR = 0 (~4 ms). Nur mit GIE = 1 aufrufen.
+static void ee_write(uint8_t a, uint8_t v) {
+    EEADR  = a;
+    EEDATA = v;
+    EECON1bits.WREN = 1;
+    GIE    = 0;
+    EECON2 = 0x55u;
+    EECON2 = 0xAAu;
+    EECON1bits.WR = 1;
+    GIE    = 1;
+    EECON1bits.WREN = 0;
+    while (EECON1bits.WR) continue;
+}
+
+#elif defined(_16F1825)
+// ─── Profil PIC16F1825: LATC + LATA5 ─────────────────────────────────
+//  a–f = RC0–RC5 (Bit = logisches Bit), g = RA5 ← anderer Port!
+//  LATA gehört allein LED g: RA0–RA2 sind LOW-Ausgänge ([FIX-8]),
+//  RA3/RA4 Eingänge → ganzes LATA schreiben statt LATA5 per RMW.
+#define BOARD_SLEEP     1                // Auto-Sleep, Wake über IOC (RA4)
+#define BOARD_PWM       1                // Helligkeit über Timer2
+#define BOARD_RC_CAL    0                // HFINTOSC ab Werk kalibriert
+#ifndef BOARD_TOUCH
+#define BOARD_TOUCH     0                // 1: Touch-Fläche an RA2 (CPS2) statt Taster RA4
+#endif
+#ifndef BOARD_TRACE                      // mit Touch ab Werk aus: ~2040 von 2048 Wörtern
+#define BOARD_TRACE     (!BOARD_TOUCH)   // Ereignis-Protokoll im EEPROM (Byte 64 …)
+#endif
+#ifndef BOARD_PROFILES
+#define BOARD_PROFILES  1                // Roll-Profile voll / kurz / sofort
+#endif
+#define BOARD_PROF_LITE 0                // dazu kurz und ANIM_PROFILE
+#define LATC_OF(p)      ((uint8_t)((p) & 0x3Fu))
+#define LATA_OF(p)      ((uint8_t)(((p) & LED_G) ? (1u<<5) : 0u))
+
+static const uint8_t DICE_LATC[8] = FACE_TABLE(LATC_OF);
+static const uint8_t DICE_LATA[8] = FACE_TABLE(LATA_OF);
+
+#if BOARD_TOUCH
+#define BTN_IS_LOW()    (touch_on)       // Detektor in main_1825.c (Hysterese)
+#else
+#define BTN_IS_LOW()    (!PORTAbits.RA4)
+#endif
+
+// [FIX-1] LATx statt PORTx (kein RMW)
+static void led_out(uint8_t f) {
+    LATC = DICE_LATC[f];
+    LATA = DICE_LATA[f];
+}
+
+// ─── Mehrere Würfel: Multiplex über RA0–RA2 (-DDICE_N=2 oder 3) ──────
+//  Segmente a–g aller Würfel parallel an RC0–RC5/RA5 (Vorwiderstände
+//  wie gehabt), je Würfel die gemeinsame Kathode über einen N-MOSFET
+//  (2N7002, BSS138) nach GND, Gate an RAk: HIGH = Würfel k an. Ein Pin
+//  allein dürfte die ~64 mA von 6 LEDs nicht aufnehmen (max. 25 mA).
+//  Es leuchtet immer nur ein Würfel; led_out() wählt alle ab.
+#ifndef DICE_N
+#define DICE_N          1u
+#endif
+#if DICE_N < 1 || DICE_N > 3
+#error "DICE_N: 1 … 3 Würfel (Auswahl über RA0–RA2)"
+#endif
+#if BOARD_TOUCH && DICE_N > 2
+#error "Touch-Fläche an RA2 belegt die Auswahl von Würfel 3 (DICE_N ≤ 2)"
+#endif
+
+#if DICE_N > 1
+static const uint8_t MUX_SEL[3] = { 1u<<0, 1u<<1, 1u<<2 };
+
+// Erst abwählen, dann Segmente, dann Würfel k: kein Geisterbild des
+// neuen Musters auf dem alten Würfel
+static void led_die(uint8_t k, uint8_t f) {
+    LATA = 0x00u;
+    LATC = DICE_LATC[f];
+    LATA = (uint8_t)(DICE_LATA[f] | MUX_SEL[k]);
+}
+#else
+#define led_die(k, f)   led_out(f)
+#endif
+
+// ─── Daten-EEPROM: 256 Byte ───────────────────────────────────────────
+// EECON1 ganz schreiben: EEPGD = CFGS = 0 wählt das Daten-EEPROM
+// (nicht Flash/Config) — spart die beiden Bit-Befehle je Zugriff.
+#define EE_SIZE         256u
+
+static uint8_t ee_read(uint8_t a) {
+    EEADRL = a;
+    EECON1 = 0x01u;                  // RD
+    return EEDATL;
+}
+
+// 55/AA + WR als lückenlose Befehlsfolge (kein Interrupt dazwischen),
+// dann warten bis WR = 0 (~4 ms). Nur mit GIE = 1 aufrufen.
+static void ee_write(uint8_t a, uint8_t v) {
+    EEADRL = a;
+    EEDATL = v;
+    EECON1 = 0x04u;                  // WREN
+    INTCONbits.GIE = 0;
+    EECON2 = 0x55u;
+    EECON2 = 0xAAu;
+    EECON1bits.WR  = 1;
+    INTCONbits.GIE = 1;
+    EECON1bits.WREN = 0;
+    while (EECON1bits.WR) continue;
+}
+
+#else
+#error "Kein Board-Profil für diesen Chip (16F84A oder 16F1825)"
+#endif
+
+// ─── Zeitbasis: ms → Timer0-Ticks zur Compile-Zeit ───────────────────
+#define MS(ms)  ((uint16_t)(((ms) * 1000UL + TICK_US / 2u) / TICK_US))
+
+#endif
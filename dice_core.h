@@ -0,0 +1,709 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Würfel-Kern  ·  gemeinsam für PIC16F84A und PIC16F1825
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Taster-Entprellung, Zufallsgenerator, Zustände, die Animationen
+ *  (Tabellen + Abspieler) und der EEPROM-Ring — einmal für beide Chips.
+ *  Unterschiede stehen im Board-Profil (board.h) bzw. in den
+ *  Strom-Funktionen der jeweiligen Firmware (main.c / main_1825.c).
+ *
+ *  Wird genau einmal je Firmware eingebunden (wie ein .c, ohne eigenes
+ *  Objekt: XC8 sieht alles in einer Übersetzungseinheit). Vorher muss
+ *  die Firmware bereitstellen:
+ *    board.h (DICE_N Würfel), TICK_US
+ *    show(seite) für alle Würfel, show_die(k, seite) für Würfel k
+ *    BOARD_PWM = 1: set_brightness(stufe), BRIGHT_FULL/FAST/MID/SLOW
+ *    BOARD_TRACE = 1: TRACE_TICK() in der ISR, TRACE_FLUSH() vor SLEEP
+ *    BOARD_PROFILES = 1: prof_sel/prof_next() in step()
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef DICE_CORE_H
+#define DICE_CORE_H
+
+// ─── Tick-Zähler ──────────────────────────────────────────────────────
+// tmr0_count zählt Timer0-Überläufe (1 Tick = TICK_US) nur, solange der
+// Kern läuft (Zeitstempel der Taster-Ereignisse, Entropiequelle).
+volatile uint8_t tmr0_count = 0;
+
+// ─── Ereignis-Protokoll (BOARD_TRACE) ────────────────────────────────
+// Für Geräte aus dem Feld („wacht nicht auf“, „bleibt wach“, „würfelt
+// doppelt“): ISR und Hauptschleife schreiben Ereignisse in einen Ring
+// im RAM, enter_sleep() kopiert die neuen ins EEPROM (trace_flush).
+// Auslesen: EEPROM mit dem Programmer sichern, host/trace_dump.c
+// zeigt Zeitleiste und Latenzen.
+// Eintrag = 3 Byte:  0 ev: Runde (Bit 7) | Code (Bit 6…3) | Arg (Bit 2…0)
+//                    1/2 trace_t (Ticks, 16 Bit)
+// trace_t läuft in der ISR mit tmr0_count mit, wait_next() trägt die
+// Schlafzeit (16F1825: Timer1) nach → dieselbe Uhr wie now (fester Versatz);
+// im Auto-Sleep steht sie wie now.
+// Kosten je Ereignis: feste Befehlsfolge ohne Schleife (3 Byte ablegen,
+// Index maskieren, Zähler sättigen), aus der Hauptschleife dazu GIE
+// aus/an. XC8 legt trace_isr() für ISR und Hauptschleife je einmal an.
+#if BOARD_TRACE
+enum {
+    TR_BOOT,        // Einschalten
+    TR_EDGE,        // erste Tasterflanke (ISR)      Arg: 1 = LOW (Druck)
+    TR_PRESS,       // Druck entprellt               Arg: IOC-Flanken (≤ 7)
+    TR_RELEASE,     // Loslassen entprellt           Arg: IOC-Flanken
+    TR_REJECT,      // Störimpuls verworfen          Arg: IOC-Flanken
+    TR_LONG,        // LONG_TICKS gedrückt
+    TR_FRAME,       // erster Roll-Frame sichtbar
+    TR_ROLL,        // Wurf fertig                   Arg: Würfel 0 (0 … 5)
+    TR_SLEEP,       // Auto-Sleep (vor dem Kopieren ins EEPROM)
+    TR_WAKE,        // nach dem SLEEP                Arg: 1 = Abtastung läuft
+    TR_SHOW,        // letzte Zahl nach dem Wake     Arg: Würfel 0
+    TR_LOST,        // RAM-Ring übergelaufen         Arg: verloren (≤ 7)
+    TR_PROFILE      // Roll-Profil gewechselt        Arg: neues Profil (0 … 2)
+};                  // Code 15 = leerer Platz (EEPROM 0xFF)
+// IOC-Flanken: IOCAF4-Treffer während der Abtastung seit dem vorigen
+// Taster-Eintrag (Prellen; beim Loslassen zählt dessen Flanke mit).
+// TRACE_N: eine Sitzung mit zwei Würfen braucht ~20 Einträge.
+
+#define TRACE_N      32u                 // Einträge im RAM (Zweierpotenz)
+#define TR_EV(c, a)  ((uint8_t)(((c) << 3) | (a)))
+
+volatile uint16_t trace_t;               // Uhr der Einträge (ISR bzw. GIE = 0)
+static uint8_t    trace_buf[TRACE_N][3];
+static uint8_t    trace_w;               // nächster Platz
+static uint8_t    trace_new;             // seit trace_flush(), sättigt bei 255
+static uint8_t    trace_bounce;          // IOC-Flanken (nur ISR)
+
+// Aus der ISR (oder mit GIE = 0)
+static void trace_isr(uint8_t ev) {
+    uint8_t *p = trace_buf[trace_w];
+
+    p[0]    = ev;
+    p[1]    = (uint8_t)trace_t;
+    p[2]    = (uint8_t)(trace_t >> 8);
+    trace_w = (trace_w + 1u) & (TRACE_N - 1u);
+    if (trace_new != 0xFFu) trace_new++;
+}
+
+// Aus der Hauptschleife
+static void trace(uint8_t ev) {
+    INTCONbits.GIE = 0;
+    trace_isr(ev);
+    INTCONbits.GIE = 1;
+}
+
+#define TRACE(c, a)      trace(TR_EV(c, a))
+#define TRACE_ISR(c, a)  trace_isr(TR_EV(c, a))
+#define TRACE_TICK(n)    (trace_t += (n))
+#define TRACE_EDGE(low)  (trace_bounce = 0, trace_isr(TR_EV(TR_EDGE, (low) ? 1u : 0u)))
+#define TRACE_BOUNCE()   (trace_bounce += trace_bounce < 7u)
+#define TRACE_BTN(c)     (trace_isr(TR_EV(c, trace_bounce)), trace_bounce = 0)
+#else
+#define TRACE(c, a)      ((void)0)
+#define TRACE_ISR(c, a)  ((void)0)
+#define TRACE_TICK(n)    ((void)0)
+#define TRACE_EDGE(low)  ((void)0)
+#define TRACE_BOUNCE()   ((void)0)
+#define TRACE_BTN(c)     ((void)0)
+#endif
+
+// ─── Taster: Flanken-Interrupt + integrierende Entprellung ───────────
+// Eine Flanke (16F84A RBIF, 16F1825 IOCAF4) startet in der ISR die
+// Abtastung, die Tick-Phase beginnt neu (TMR0 = 0). Ab dann tastet
+// jeder Timer0-Tick den Taster ab:
+//   LOW → btn_integ+1, HIGH → btn_integ−1          (0 … BTN_REL)
+//   losgelassen, btn_integ = BTN_PRESS → EV_PRESS, btn_integ = BTN_REL
+//   gedrückt,    btn_integ = 0         → EV_RELEASE
+//   gedrückt seit LONG_TICKS           → EV_LONG (einmal je Druck)
+// Drücken zählt nach 1 Tick LOW, Loslassen erst nach BTN_REL Ticks HIGH
+// (Nachprellen). Ist alles ruhig, endet die Abtastung (16F1825: der
+// Kern darf schlafen, die nächste Flanke weckt ihn).
+#define BTN_PRESS    2u
+#define BTN_REL      MS(15)
+#define LONG_TICKS   MS(800)
+// Nach dem Wake erst so lange ohne Abtastung → Störimpuls. Ein prellender
+// Weck-Druck wird zuerst verworfen und startet mit der nächsten Flanke
+// neu — das darf keinen Wurf auslösen.
+#define WAKE_QUIET   MS(20)
+
+#define EV_PRESS     0x01u
+#define EV_RELEASE   0x02u
+#define EV_LONG      0x04u
+
+volatile uint8_t btn_events;         // ISR setzt, Hauptschleife löscht (BCF = atomar)
+volatile uint8_t btn_t_press;        // Zeitstempel: tmr0_count beim Ereignis
+volatile uint8_t btn_t_release;
+volatile uint8_t btn_t_long;
+volatile uint8_t btn_t0;             // TMR0 an der ersten Flanke (Entropie)
+volatile uint8_t btn_busy;           // 1 = Abtastung läuft
+static uint8_t   btn_level;          // entprellt: 1 = gedrückt (nur ISR)
+static uint8_t   btn_integ;
+static uint16_t  btn_hold;           // Ticks seit EV_PRESS (nur ISR)
+
+// ─── Entprell-Schritt (nur aus der ISR) ──────────────────────────────
+static void btn_sample(uint8_t low) {
+    if (low)            { if (btn_integ < BTN_REL) btn_integ++; }
+    else if (btn_integ)   btn_integ--;
+
+    if (!btn_level) {
+        if (btn_integ >= BTN_PRESS) {
+            btn_level     = 1;
+            btn_integ     = BTN_REL;
+            btn_hold      = 0;
+            btn_t_press   = tmr0_count;
+            btn_events   |= EV_PRESS;
+            TRACE_BTN(TR_PRESS);
+        } else if (!btn_integ) {
+            btn_busy = 0;                    // Störimpuls verworfen
+            TRACE_BTN(TR_REJECT);
+        }
+    } else if (!btn_integ) {
+        btn_level     = 0;
+        btn_t_release = tmr0_count;
+        btn_events   |= EV_RELEASE;
+        btn_busy      = 0;
+        TRACE_BTN(TR_RELEASE);
+    } else if (btn_hold < LONG_TICKS) {
+        if (++btn_hold == LONG_TICKS) {
+            btn_t_long  = tmr0_count;
+            btn_events |= EV_LONG;
+            TRACE_ISR(TR_LONG, 0u);
+        }
+    } else if (btn_integ == BTN_REL) {
+        btn_busy = 0;                        // ruhig gedrückt, LONG gemeldet
+    }
+}
+
+// ─── Zufallsgenerator: Entropie-Pool + xorshift16 ────────────────────
+// Der 16-Bit-Zustand rng_s ist zugleich der Entropie-Pool:
+//   rng_mix(e)   Entropiebyte einXORen, dann ein xorshift-Schritt
+// Quellen je Wurf:
+//   - TMR0 live an der ersten Tasterflanke (btn_t0, Bruchteil eines Ticks;
+//     16F1825: XOR TMR1L, freilaufend aus LFINTOSC)
+//   - Zeitpunkt des Drucks auf der Tick-Uhr now
+//   - Druckdauer in Ticks beim Loslassen
+// Gezogen wird erst am Ende der Animation → die Druckdauer des aktuellen
+// Wurfs ist dann meist schon eingemischt (PROF_NOW: gezogen im Tick des
+// Drucks, seine Dauer zählt für den nächsten Wurf).
+// 1–6 ohne Modulo-Verzerrung: je xorshift-Schritt die obersten 3 Bit,
+// 0…5 annehmen, 6/7 verwerfen (im Mittel 4/3 Schritte). Höchstens
+// RNG_STEPS Schritte → Laufzeit begrenzt; alle verworfen → 6/7 & 3 (kommt
+// nicht vor). Über alle 65535 Zustände (host/rng_test.c): je Augenzahl
+// 10922 oder 10923 Zustände, ungünstigster Zustand 8 Schritte.
+// Kein Modulo, auch nicht im Rest: __lwmod kostet am 16F84A ~31 Wörter.
+#define RNG_STEPS  10u
+#define RNG_SEED   0xACE1u
+
+static uint16_t rng_s = RNG_SEED;
+
+static uint16_t rng_next(void) {
+    rng_s ^= rng_s << 7;             // xorshift16 (7, 9, 8): Periode 65535
+    rng_s ^= rng_s >> 9;
+    rng_s ^= rng_s << 8;
+    return rng_s;
+}
+
+static void rng_mix(uint8_t e) {
+    rng_s ^= e;
+    if (!rng_s) rng_s = RNG_SEED;    // 0 ist Fixpunkt von xorshift
+    rng_next();
+}
+
+static uint8_t rng_roll(void) {
+    uint8_t k, v;
+
+    for (k = 0; k < RNG_STEPS; k++) {
+        v = (uint8_t)(rng_next() >> 8) >> 5;   // Bit 15…13: High-Byte, SWAP
+        if (v < 6u) return v;
+    }
+    return v & 3u;
+}
+
+// ─── Ablaufsteuerung: Zustände statt Warteschleifen ──────────────────
+// Die Hauptschleife ruft step() einmal je Tick (16F1825: bzw. nach
+// jedem SLEEP) auf; jeder Zustand prüft nur, ob sein Termin erreicht ist.
+//   STARTUP   Einschalt-Animation (ANIM_STARTUP)
+//   ROLLING   Roll-Frames, je Termin einer    ┐ ANIM_ROLL… des Profils
+//   BLINK     Ergebnis, Pause, Blinken        ┘
+//   IDLE      wartet auf Taster (LEDs aus; ohne BOARD_SLEEP: „1“)
+//   SHOW      Ergebnis, wartet auf Taster (16F1825: blendet aus)
+//   SLEEP     nur BOARD_SLEEP: enter_sleep() bis Taster-Wake
+//   WAKE      nur BOARD_SLEEP: letzte Zahl, Weck-Druck würfelt nicht
+// Jedes EV_PRESS startet aus jedem Zustand sofort einen neuen Wurf –
+// auch mitten in Animation oder Blinken. Ausnahme STARTUP: dort wählt
+// ein langer Druck das Roll-Profil (prof_next), ein kurzer würfelt beim
+// Loslassen.
+// Die Animations-Zustände stehen vorn → ANIMATING() ist ein Vergleich.
+enum state { ST_STARTUP, ST_ROLLING, ST_BLINK, ST_IDLE, ST_SHOW, ST_SLEEP, ST_WAKE };
+
+#define ANIMATING()  (state <= ST_BLINK)
+
+static uint8_t  state = ST_STARTUP;
+static uint16_t now;                 // Ticks, läuft über → nur Differenzen!
+static uint8_t  t_seen;              // tmr0_count, bis zu dem now nachgeführt ist
+static uint16_t due;                 // nächster Termin der Animation
+static uint8_t  face[DICE_N];        // zuletzt gezeigte Zufallsseite je Würfel
+static uint8_t  result[DICE_N];
+#if BOARD_SLEEP
+static uint16_t idle_since;          // letzte Aktivität (Tastendruck/Wake)
+static uint8_t  last_result[DICE_N]; // Letzte gewürfelte Zahl merken (EEPROM)
+#endif
+
+// ─── Animationen: Tabellen im Programmspeicher ───────────────────────
+// Ein Byte je Eintrag (XC8: ein RETLW = ein Flash-Wort):
+//   0fff fddd   FRAME   Seite f zeigen, dann Dauer ANIM_DUR[d] warten
+//                       f: 0 … 5, FACE_OFF, FACE_LOW, A_RND (Zufallsseite),
+//                          A_RES, A_PROF (Profil als 1 … 3 Augen)
+//   1000 nnnn   LOOP    Block bis NEXT n× (1 … 15), nicht geschachtelt
+//   1001 0000   NEXT
+//   1010 llll   BRIGHT  Helligkeit l (0 = BRIGHT_FULL) ab dem nächsten
+//                       FRAME, nach dessen show(); nur BOARD_PWM
+//   1011 0000   ROLL    result[k] = rng_roll() je Würfel
+//   1100 ssss   STATE   state = s (Abschnitt, z. B. ROLLING → BLINK)
+//   1111 1111   END
+// Neue Animationsstile kosten nur Tabellenbytes: der Abspieler bleibt.
+// Ein FRAME gilt für alle DICE_N Würfel: A_RND/A_RES je Würfel eigen.
+#define A_RND        8u                  // nächste Zufallsseite (1–5 weiter)
+#define A_RES        9u                  // gewürfeltes Ergebnis
+#define A_PROF      10u                  // aktives Roll-Profil
+
+#define A_FRAME(f, d)  ((uint8_t)(((f) << 3) | (d)))
+#define A_LOOP(n)      ((uint8_t)(0x80u | (n)))
+#define A_NEXT         0x90u
+#define A_ROLL         0xB0u
+#define A_STATE(s)     ((uint8_t)(0xC0u | (s)))
+#define A_END          0xFFu
+#if BOARD_PWM
+#define A_BRIGHT(l)    (uint8_t)(0xA0u | ((l) & 0x0Fu)),
+#else
+#define A_BRIGHT(l)                      // ohne PWM: kein Tabellenbyte
+#endif
+
+// Dauern (Index d) in Ticks, zur Compile-Zeit umgerechnet. Ein Byte je
+// Dauer: ≤ 250 ms (16F1825: 244 Ticks); längere Pausen = dieselbe Seite
+// mehrfach (show() derselben Seite ändert nichts an den LEDs).
+enum { D40, D90, D160, D100, D200, D140, D250 };
+static const uint8_t ANIM_DUR[7] = {
+    MS(40), MS(90), MS(160), MS(100), MS(200), MS(140), MS(250)
+};
+
+// ─── Roll-Profile ─────────────────────────────────────────────────────
+// Je Profil eine Wurf-Tabelle, der Abspieler bleibt derselbe. Jede
+// beginnt mit ROLLING und schaltet mit dem Ergebnis auf BLINK.
+//   PROF_FULL   24 Frames schnell → langsam, 500 ms, 3× Blinken  ~3,6 s
+//   PROF_SHORT  9 Frames (6 schnell, 3 mittel), Ergebnis ohne Blinken
+//   PROF_NOW    Ergebnis sofort, im Tick des Drucks
+// Gewählt wird per langem Druck während der Einschalt-Animation (oder
+// Taster beim Einschalten halten), gespeichert im EEPROM-Ring.
+// BOARD_PROF_LITE (16F84A, 1K Flash): nur voll/sofort, ohne
+// ANIM_PROFILE — der Wechsel beendet die Einschalt-Animation und zeigt
+// 1 bzw. 2 Augen bis zum nächsten Druck oder Sleep.
+// Ohne BOARD_PROFILES: nur PROF_FULL, ein Druck in STARTUP würfelt
+// sofort, Würfe wieder 24 Bit.
+#if BOARD_PROF_LITE
+enum { PROF_FULL, PROF_NOW, PROF_N };
+#else
+enum { PROF_FULL, PROF_SHORT, PROF_NOW, PROF_N };
+#endif
+
+#if BOARD_PROFILES
+static uint8_t profile = PROF_FULL;
+static uint8_t prof_sel;             // 1 = Druck in STARTUP: lang → Profil, kurz → Wurf
+#endif
+
+// Voll: schnell → langsam gedimmt, Ergebnis, 3× Blinken
+static const uint8_t ANIM_ROLL[] = {
+    A_BRIGHT(BRIGHT_FAST) A_LOOP(8), A_FRAME(A_RND, D40),  A_NEXT,
+    A_BRIGHT(BRIGHT_MID)  A_LOOP(8), A_FRAME(A_RND, D90),  A_NEXT,
+    A_BRIGHT(BRIGHT_SLOW) A_LOOP(8), A_FRAME(A_RND, D160), A_NEXT,
+    A_ROLL, A_BRIGHT(BRIGHT_FULL)
+    A_STATE(ST_BLINK), A_FRAME(A_RES, D250), A_FRAME(A_RES, D250),  // 500 ms Pause
+    A_LOOP(3), A_FRAME(FACE_OFF, D100), A_FRAME(A_RES, D200), A_NEXT,
+    A_END
+};
+
+#if BOARD_PROFILES
+#if !BOARD_PROF_LITE
+// Kurz: 6 × 40 + 3 × 90 ms gedimmt, dann das Ergebnis
+static const uint8_t ANIM_ROLL_SHORT[] = {
+    A_BRIGHT(BRIGHT_FAST) A_LOOP(6), A_FRAME(A_RND, D40),  A_NEXT,
+    A_BRIGHT(BRIGHT_MID)  A_LOOP(3), A_FRAME(A_RND, D90),  A_NEXT,
+    A_ROLL, A_BRIGHT(BRIGHT_FULL)
+    A_STATE(ST_BLINK), A_FRAME(A_RES, D100),
+    A_END
+};
+#endif
+
+// Sofort: nur das Ergebnis
+static const uint8_t ANIM_ROLL_NOW[] = {
+    A_ROLL, A_BRIGHT(BRIGHT_FULL)
+    A_STATE(ST_BLINK), A_FRAME(A_RES, D40),
+    A_END
+};
+
+#if !BOARD_PROF_LITE
+static const uint8_t *const ANIM_ROLLS[PROF_N] = {
+    ANIM_ROLL, ANIM_ROLL_SHORT, ANIM_ROLL_NOW
+};
+
+// Profil gewechselt: 1/2/3 Augen zweimal zeigen, dann wie nach dem Start
+static const uint8_t ANIM_PROFILE[] = {
+    A_BRIGHT(BRIGHT_FULL)
+    A_LOOP(2), A_FRAME(FACE_OFF, D100), A_FRAME(A_PROF, D250), A_NEXT,
+    A_FRAME(FACE_OFF, D100),
+    A_END
+};
+#endif
+#endif
+
+// Einschalten: alle 6 Seiten, „1“ lang, kurz aus
+static const uint8_t ANIM_STARTUP[] = {
+    A_FRAME(0, D140), A_FRAME(1, D140), A_FRAME(2, D140),
+    A_FRAME(3, D140), A_FRAME(4, D140), A_FRAME(5, D140),
+    A_FRAME(0, D200), A_FRAME(0, D200), A_FRAME(FACE_OFF, D200),
+    A_END
+};
+
+// ─── Abspieler ────────────────────────────────────────────────────────
+static const uint8_t *anim_p;        // nächster Eintrag
+static const uint8_t *anim_loop;     // Anfang des LOOP-Blocks
+static uint8_t        anim_n;        // verbleibende Durchläufe
+
+// Einträge bis einschließlich des nächsten FRAME ausführen und dessen
+// Termin setzen (ab Termin, nicht ab jetzt → keine Drift).
+// Rückgabe 0: END erreicht.
+static uint8_t anim_step(void) {
+    uint8_t op, f, k, g;
+#if BOARD_PWM
+    uint8_t level = 0;
+#endif
+
+    for (;;) {
+        op = *anim_p++;
+        if (!(op & 0x80u)) break;                // FRAME
+        switch (op & 0xF0u) {
+        case 0x80u: anim_n = op & 0x0Fu; anim_loop = anim_p; break;
+        case 0x90u: if (--anim_n) anim_p = anim_loop;         break;
+#if BOARD_PWM
+        case 0xA0u: level = (op & 0x0Fu) ? (op & 0x0Fu) : BRIGHT_FULL; break;
+#endif
+        case 0xB0u: for (k = 0; k < DICE_N; k++) result[k] = rng_roll(); break;
+        case 0xC0u: state  = op & 0x0Fu;                      break;
+        default:    return 0;                                 // END
+        }
+    }
+    f = op >> 3;
+    for (k = 0; k < DICE_N; k++) {
+        g = f;
+        if (g == A_RND) {    // nie zweimal dieselbe Seite hintereinander
+            g = (uint8_t)rng_next();                 // 0 … 255 → 0 … 4: g · 5 / 256
+            g = (uint8_t)(((uint16_t)g + ((uint16_t)g << 2)) >> 8);
+            g = (uint8_t)(face[k] + 1u + g);         // 1 … 5 weiter
+            if (g >= 6u) g -= 6u;
+            face[k] = g;
+        } else if (g == A_RES)
+            g = result[k];
+#if BOARD_PROFILES && !BOARD_PROF_LITE
+        else if (g == A_PROF)
+            g = profile;
+#endif
+        show_die(k, g);                      // erst die Seite, dann dimmen:
+    }
+#if BOARD_PWM                                // sonst blitzt die alte auf
+    if (level) set_brightness(level);
+#endif
+    due += ANIM_DUR[op & 0x07u];
+    return 1;
+}
+
+// Animation ab jetzt abspielen, erster Frame im selben Tick
+static void anim_start(const uint8_t *a, uint8_t st) {
+    anim_p = a;
+    due    = now;
+    state  = st;
+    anim_step();
+}
+
+#if BOARD_SLEEP
+// ─── Persistenz: EEPROM-Ring mit Folgenummern ────────────────────────
+// Letzte Zahl, RNG-Zustand und Wurfzähler überstehen den Batteriewechsel.
+// Geschrieben wird nur in enter_sleep() und nur nach neuen Würfen (ein
+// Eintrag je Sitzung, ~32 ms bei LEDs aus) — nie im Wurf selbst.
+// Das EEPROM ist ein Ring aus EE_SLOTS Einträgen zu je 8 Byte; jeder
+// Eintrag geht in den nächsten Platz (Platz = seq mod EE_SLOTS) → jedes
+// Byte wird nur bei jedem EE_SLOTS-ten Speichern beschrieben.
+//   0 seq   1 Ergebnis   2/3 rng_s   4–6 Würfe   7 Prüfsumme
+// Würfe: 22 Bit (läuft nach ~4 Mio. über), Byte 6 Bit 7/6 = Roll-Profil
+// (ohne BOARD_PROFILES: 24 Bit).
+// Ergebnis bei DICE_N Würfeln: r0 + 6·r1 + 36·r2 (< 6^DICE_N ≤ 216).
+// Abriss (Strom weg beim Schreiben): Bytes 7 … 1 zuerst, seq zuletzt.
+// Bis seq steht, trägt der Platz die alte (älteste) Folgenummer und
+// verliert gegen den Vorgänger; ein zerrissenes seq-Byte ändert genau
+// ein Byte → Prüfsumme falsch. Nach dem Einschalten gilt also immer
+// der alte oder der neue Stand, nie eine Mischung (host/ee_test.c).
+// Neuester Eintrag: größte seq im 8-Bit-Kreis (Abstand < 128, da
+// EE_SLOTS ≤ 32). Leeres EEPROM (0xFF) oder 0x00 → Prüfsumme falsch.
+// BOARD_TRACE: die oberen drei Viertel gehören dem Ereignis-Protokoll
+// (je Sitzung ~12 Einträge statt eines Ring-Eintrags → beide Teile
+// verschleißen ähnlich schnell, siehe host/ee_test.c).
+// BOARD_RC_CAL: die obere Hälfte hält die RC-Kalibrierung (main.c),
+// geschrieben nur am Prüfplatz → 4 Plätze im Ring.
+#define EE_REC       8u
+#if BOARD_TRACE
+#define EE_RING_END  (EE_SIZE / 4u)
+#elif BOARD_RC_CAL
+#define EE_RING_END  (EE_SIZE / 2u)
+#else
+#define EE_RING_END  EE_SIZE
+#endif
+#define EE_SLOTS     (EE_RING_END / EE_REC)  // 16F84A: 8 (mit Kalibrierung 4), 16F1825: 8 (ohne Protokoll 32)
+#define EE_SUM_SEED  0xA5u
+#define EE_RES_MAX   (DICE_N == 1u ? 6u : DICE_N == 2u ? 36u : 216u)
+
+enum { EE_SEQ, EE_RESULT, EE_RNG_LO, EE_RNG_HI, EE_ROLLS0, EE_ROLLS1, EE_ROLLS2, EE_CHECK };
+#if BOARD_PROF_LITE
+#define EE_PROF_SH   7u                  // Profil in EE_ROLLS2, Bit 7 (Bit 6 bleibt 0)
+#else
+#define EE_PROF_SH   6u                  // Profil in EE_ROLLS2, Bit 7/6
+#endif
+#define EE_ROLLS_HI  0x3Fu               // Würfe Bit 21…16
+
+static uint8_t ee_rec[EE_REC];       // neuester Eintrag (RAM-Abbild)
+static uint8_t ee_dirty;             // 1 = Würfe seit dem letzten Speichern
+
+static uint8_t ee_pack(void) {
+#if DICE_N > 1
+    uint8_t k = DICE_N, v = 0;
+    while (k--) v = (uint8_t)(v * 6u + last_result[k]);
+    return v;
+#else
+    return last_result[0];
+#endif
+}
+
+static uint8_t ee_sum(void) {
+    uint8_t k, s = EE_SUM_SEED;
+    for (k = 0; k < EE_CHECK; k++) s += ee_rec[k];
+    return s;
+}
+
+static void ee_fetch(uint8_t slot) {
+    uint8_t k, a = (uint8_t)(slot * EE_REC);
+    for (k = 0; k < EE_REC; k++) ee_rec[k] = ee_read((uint8_t)(a + k));
+}
+
+// ─── Beim Einschalten: neuesten gültigen Eintrag übernehmen ──────────
+static void ee_load(void) {
+    uint8_t slot, seq = 0, best = 0xFFu;
+
+    for (slot = 0; slot < EE_SLOTS; slot++) {
+        ee_fetch(slot);
+        if (ee_rec[EE_CHECK] != ee_sum()) continue;                    // leer/zerrissen
+        if ((ee_rec[EE_SEQ] & (EE_SLOTS - 1u)) != slot) continue;      // falscher Platz
+        if (best != 0xFFu && (int8_t)(ee_rec[EE_SEQ] - seq) <= 0) continue;
+        seq  = ee_rec[EE_SEQ];
+        best = slot;
+    }
+    if (best == 0xFFu) {                     // nichts gespeichert: Werkszustand
+        for (slot = 0; slot < EE_REC; slot++) ee_rec[slot] = 0;
+        ee_rec[EE_SEQ] = 0xFFu;              // erster Eintrag: seq 0, Platz 0
+        return;
+    }
+    ee_fetch(best);
+    if (ee_rec[EE_RESULT] < EE_RES_MAX) {
+#if DICE_N > 1
+        seq = ee_rec[EE_RESULT];
+        for (slot = 0; slot < DICE_N; slot++) {
+            best = 0;                        // seq / 6, seq % 6 ohne Division
+            while (seq >= 6u) { seq -= 6u; best++; }
+            last_result[slot] = seq;
+            seq = best;
+        }
+#else
+        last_result[0] = ee_rec[EE_RESULT];
+#endif
+    }
+    rng_s = (uint16_t)(ee_rec[EE_RNG_HI] << 8) | ee_rec[EE_RNG_LO];
+    if (!rng_s) rng_s = RNG_SEED;            // 0 ist Fixpunkt von xorshift
+#if BOARD_PROFILES
+    profile = ee_rec[EE_ROLLS2] >> EE_PROF_SH;
+#if !BOARD_PROF_LITE
+    if (profile >= PROF_N) profile = PROF_FULL;
+#endif
+#endif
+}
+
+// ─── Vor dem SLEEP: Stand als nächsten Eintrag schreiben ─────────────
+// Unveränderte Bytes (Zähler-High) werden nicht neu geschrieben.
+static void ee_save(void) {
+    uint8_t k, a;
+
+    if (!ee_dirty) return;
+    ee_rec[EE_SEQ]++;
+    ee_rec[EE_RESULT] = ee_pack();
+    ee_rec[EE_RNG_LO] = (uint8_t)rng_s;
+    ee_rec[EE_RNG_HI] = (uint8_t)(rng_s >> 8);
+#if BOARD_PROFILES
+    ee_rec[EE_ROLLS2] = (uint8_t)((ee_rec[EE_ROLLS2] & EE_ROLLS_HI) | (profile << EE_PROF_SH));
+#endif
+    ee_rec[EE_CHECK]  = ee_sum();
+    a = (uint8_t)((ee_rec[EE_SEQ] & (EE_SLOTS - 1u)) * EE_REC);
+    for (k = EE_REC; k--; )                  // seq (k = 0) zuletzt
+        if (ee_read((uint8_t)(a + k)) != ee_rec[k]) ee_write((uint8_t)(a + k), ee_rec[k]);
+    ee_dirty = 0;
+}
+#endif
+
+#if BOARD_TRACE
+// ─── Ereignis-Protokoll im EEPROM: TRACE_EE Plätze ab EE_TRACE_AT ────
+#define EE_TRACE_AT  EE_RING_END
+// Geschrieben der Reihe nach im Kreis, ohne Zeiger-Byte (das würde bei
+// jedem Kopieren neu geschrieben): Bit 7 von ev ist die Runde und
+// wechselt bei jedem Umlauf → der Kopf ist der erste Platz, dessen
+// Runde von Platz 0 abweicht; weicht keiner ab, ist es Platz 0.
+// Zeit zuerst, ev zuletzt: ein abgerissener Eintrag behält meist die
+// alte Runde und gilt als alt; falsch ist höchstens dieser eine.
+// Je Sitzung (Weck-Druck, Wurf, Sleep) ~12 Einträge = 36 Byte ≈ 150 ms
+// bei LEDs aus; unveränderte Bytes werden nicht neu geschrieben.
+#define TRACE_EE   ((EE_SIZE - EE_TRACE_AT) / 3u)    // 16F1825: 64
+#define TR_LAP     0x80u
+
+static uint8_t trace_ee;             // nächster Platz im EEPROM
+static uint8_t trace_lap;            // Runde des nächsten Eintrags (0/TR_LAP)
+
+// Beim Einschalten: Kopf suchen
+static void trace_load(void) {
+    uint8_t k, lap0 = ee_read(EE_TRACE_AT) & TR_LAP;
+
+    for (k = 1; k < TRACE_EE; k++)
+        if ((ee_read((uint8_t)(EE_TRACE_AT + 3u * k)) & TR_LAP) != lap0) break;
+    if (k < TRACE_EE) { trace_ee = k; trace_lap = lap0; }
+    else              { trace_ee = 0; trace_lap = lap0 ^ TR_LAP; }
+}
+
+static void trace_put_ee(uint8_t ev, uint8_t lo, uint8_t hi) {
+    uint8_t a = (uint8_t)(EE_TRACE_AT + 3u * trace_ee);
+
+    ev = (uint8_t)((ev & (uint8_t)~TR_LAP) | trace_lap);
+    if (ee_read((uint8_t)(a + 1u)) != lo) ee_write((uint8_t)(a + 1u), lo);
+    if (ee_read((uint8_t)(a + 2u)) != hi) ee_write((uint8_t)(a + 2u), hi);
+    if (ee_read(a) != ev)                 ee_write(a, ev);
+    if (++trace_ee == TRACE_EE) { trace_ee = 0; trace_lap ^= TR_LAP; }
+}
+
+// ─── Vor dem SLEEP: neue Einträge aus dem RAM ins EEPROM ─────────────
+// Mehr als TRACE_N neue → die ältesten sind überschrieben, statt ihrer
+// steht TR_LOST (Zeit des ältesten erhaltenen Eintrags) im Protokoll.
+// Ereignisse während des Kopierens (ISR) bleiben fürs nächste Mal.
+static void trace_flush(void) {
+    uint8_t n, r;
+    uint8_t *p;
+
+    INTCONbits.GIE = 0;
+    n         = trace_new;
+    r         = trace_w;
+    trace_new = 0;
+    INTCONbits.GIE = 1;
+    if (n > TRACE_N) {
+        n -= TRACE_N;
+        trace_put_ee(TR_EV(TR_LOST, n < 7u ? n : 7u), trace_buf[r][1], trace_buf[r][2]);
+        n = TRACE_N;
+    }
+    r = (uint8_t)(r - n) & (TRACE_N - 1u);
+    while (n--) {
+        p = trace_buf[r];
+        trace_put_ee(p[0], p[1], p[2]);
+        r = (r + 1u) & (TRACE_N - 1u);
+    }
+}
+
+#define TRACE_LOAD()     trace_load()
+#define TRACE_FLUSH()    trace_flush()
+#else
+#define TRACE_LOAD()     ((void)0)
+#define TRACE_FLUSH()    ((void)0)
+#endif
+
+// ─── Würfeln abgeschlossen (nach dem 3. Blinken) ─────────────────────
+static void finish_roll(void) {
+#if BOARD_SLEEP
+    uint8_t k;
+
+    for (k = 0; k < DICE_N; k++) last_result[k] = result[k];   // für Wake-Up
+    if (!++ee_rec[EE_ROLLS0] && !++ee_rec[EE_ROLLS1]) ++ee_rec[EE_ROLLS2];
+    ee_dirty = 1;
+#endif
+    TRACE(TR_ROLL, result[0]);
+    state = ST_SHOW;
+}
+
+#if BOARD_SLEEP
+// ─── Nach dem Wake: letzte Zahlen zeigen ─────────────────────────────
+static void show_last(void) {
+    uint8_t k;
+    for (k = 0; k < DICE_N; k++) show_die(k, last_result[k]);
+}
+#endif
+
+// ─── Einschalt-Animation beendet ──────────────────────────────────────
+// [FIX-7] Mit Auto-Sleep endet sie mit LEDs AUS (Stromsparen); ohne
+// Sleep (BOARD_SLEEP = 0) bleibt die Bereit-Anzeige „1“ an.
+static void startup_done(void) {
+#if BOARD_SLEEP
+    idle_since = now;                        // Auto-Sleep ab jetzt
+#else
+    show(0);                                 // Bereit-Anzeige: "1"
+#endif
+    state = ST_IDLE;
+}
+
+// ─── Termin erreicht: nächster Frame oder Ende der Animation ─────────
+static void anim_due(void) {
+    if (anim_step()) return;
+    if (state == ST_STARTUP) startup_done();
+    else                     finish_roll();
+}
+
+// ─── Neuer Wurf: erster Frame im selben Tick ─────────────────────────
+// pressed_at: Zeitpunkt des Drucks auf der Tick-Uhr
+static void start_roll(uint16_t pressed_at) {
+    rng_mix(btn_t0);                         // Phase im Tick beim Druck
+    rng_mix((uint8_t)pressed_at);            // Zeitpunkt, tick-genau
+#if BOARD_SLEEP
+    idle_since = pressed_at;                 // Activity → Sleep-Timer zurück
+#endif
+#if BOARD_PROFILES && BOARD_PROF_LITE
+    anim_start(profile ? ANIM_ROLL_NOW : ANIM_ROLL, ST_ROLLING);  // ohne Zeigertabelle
+#elif BOARD_PROFILES
+    anim_start(ANIM_ROLLS[profile], ST_ROLLING);
+#else
+    anim_start(ANIM_ROLL, ST_ROLLING);
+#endif
+    TRACE(TR_FRAME, 0u);
+}
+
+#if BOARD_PROFILES
+// ─── Nächstes Roll-Profil (langer Druck während STARTUP) ─────────────
+// Zeigt das Profil mit ANIM_PROFILE; die Einschalt-Animation endet
+// damit, eine weitere Geste darin schaltet erneut weiter.
+// BOARD_PROF_LITE: Profil als Augenzahl stehen lassen, fertig.
+static void prof_next(void) {
+#if BOARD_PROF_LITE
+    profile ^= 1u;                           // voll ↔ sofort
+#else
+    profile = (uint8_t)(profile + 1u < PROF_N ? profile + 1u : PROF_FULL);
+#endif
+#if BOARD_SLEEP
+    ee_dirty = 1;                            // beim nächsten Sleep speichern
+#endif
+    TRACE(TR_PROFILE, profile);
+#if BOARD_PROF_LITE
+    startup_done();
+    show(profile);                           // 1 Auge = voll, 2 = sofort
+#else
+    anim_start(ANIM_PROFILE, ST_STARTUP);
+#endif
+}
+#endif
+
+// ─── Einschalt-Animation starten (läuft über step()) ─────────────────
+static void startup_seq(void) {
+    anim_start(ANIM_STARTUP, ST_STARTUP);
+}
+
+#endif
@@ -0,0 +1,276 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  btn_test  ·  Taster-Regressionen rund um Auto-Sleep und Wake
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Übersetzt main.c bzw. main_1825.c unverändert gegen die Simulation
+ *  (wie dice_sim) und spielt feste Fälle ab dem Auto-Sleep-Entscheid
+ *  durch: einmal einschalten, einmal würfeln, bis step() ST_SLEEP setzt
+ *  — jeder Fall läuft in einem eigenen fork() von diesem Stand.
+ *
+ *  1. Weck-Druck prellt [FIX-10]: Impuls 5 … 300 µs, 1 … 8 ms offen,
+ *     dann 150 ms gedrückt. Der Impuls weckt und wird als Störimpuls
+ *     verworfen (evtl. schon beim ersten Abtasten), die zweite Flanke
+ *     entprellt neu — beides ist der Weck-Druck und würfelt nicht. Ein
+ *     sauberer Druck danach würfelt genau einmal. (Nicht bei Touch.)
+ *  2. Druck beim Einschlafen [FIX-11]: Druck 0 … 296 ms nach dem
+ *     Entscheid, kurz oder 400 ms. Der Kern bleibt wach und zeigt die
+ *     letzte Zahl, ohne weitere Flanke und ohne zu würfeln.
+ *  3. Schlaf hält: ohne Druck hält der erste SLEEP, auch wenn im Takt
+ *     davor ein Timer-Flag kommt (sim.on_sleep setzt es).
+ *  4. Scan-Fenster [FIX-12] (nur Touch): läuft die Tick-Phase beim
+ *     Weiterstellen nach touch_scan() über, holt TMR0IF den Tick nach.
+ *
+ *  Build (16F1825 auch mit -DDICE_N=2|3 oder -DBOARD_TOUCH=1):
+ *    gcc -O2 -D_16F84A  -Ihost -o btn_test_84a  host/btn_test.c host/sim.c
+ *    gcc -O2 -D_16F1825 -Ihost -o btn_test_1825 host/btn_test.c host/sim.c
+ *
+ *  Rückgabe: 0 = alle Fälle ok, 1 = Fehler
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (static-Funktionen direkt aufrufbar) ─────────
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u        // 4,7 kΩ + 100 pF
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u             // folgt OSCCON
+#endif
+#undef main
+
+
+#define BOOT_MS   3000u         // Einschalt-Animation vorbei, Leerlauf
+#define ASLEEP_MS 1000u         // nach dem Entscheid: EEPROM geschrieben, SLEEP
+#define ROLL_MS   8000u         // Druck → Ergebnis + Blinken, alle Profile
+#define WRITE_MS  300u          // enter_sleep(): EEPROM + Protokoll, reichlich
+
+#if BOARD_TOUCH
+#define HOLD_MS   150u          // > Scan-Raster (wach ~16 ms, Auto-Sleep ~64 ms)
+#define CALM_MS   300u          // Loslassen erkannt, entprellt
+#else
+#define HOLD_MS   5u            // Druck + Loslassen enden im Schreiben (16F84A ~32 ms)
+#define CALM_MS   100u
+#endif
+
+static const char *const ST_NAME[] = {
+    "STARTUP", "ROLLING", "BLINK", "IDLE", "SHOW", "SLEEP", "WAKE"
+};
+
+// ─── Ablauf: step()/wait_next() mit Zählern ──────────────────────────
+static uint8_t  rolls0, presses;
+static uint64_t t_lit;              // letztes Muster ≠ aus
+
+static void on_frame(uint64_t t_ns, uint8_t leds) {
+    if (leds) t_lit = t_ns;
+}
+
+static uint8_t rolls(void) {
+    return (uint8_t)(ee_rec[EE_ROLLS0] - rolls0);
+}
+
+static void call_loop(void) {
+    for (;;) {
+        if (btn_events & EV_PRESS) presses++;         // step() löscht es gleich
+        step();
+        wait_next();
+    }
+}
+
+static void call_to_sleep(void) {
+    for (;;) {
+        step();
+        if (state == ST_SLEEP) return;
+        wait_next();
+    }
+}
+
+// Nach Abbruch in wait_next(): GIE = 0 und (16F1825) TMR1IE = 1 zurück
+static void after_abort(void) {
+    sim.reg[SIM_INTCON] |= 0x80u;
+#if defined(_16F1825)
+    sim.reg[SIM_PIE1] &= (uint8_t)~0x01u;   // ISR kennt TMR1IF nicht
+#endif
+}
+
+static void boot(void) {
+    sim_reset(FW_FOSC);
+    sim_attach_isr(isr);
+    sim.on_frame = on_frame;
+    sim.warp     = 1;
+    sim_run(fw_main, SIM_MS(BOOT_MS));
+    after_abort();
+}
+
+// Würfeln (neue Daten → enter_sleep() schreibt), bis zum Auto-Sleep-
+// Entscheid; der Druck setzt die Tick-Phase (TMR0 = 0 an der Flanke)
+static int to_sleep(uint64_t phase_ns) {
+    sim_press(sim.now_ns + SIM_MS(10) + phase_ns, SIM_MS(60));
+    return sim_run(call_to_sleep, sim.now_ns + SIM_MS(60000));
+}
+
+// Ein Fall im Kind: Exit-Code 0 = ok
+static int run_case(int (*fn)(unsigned), unsigned arg) {
+    pid_t pid;
+    int   st;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        st = fn(arg);
+        fflush(stdout);
+        _exit(st);
+    }
+    return pid < 0 || waitpid(pid, &st, 0) < 0 || !WIFEXITED(st) || WEXITSTATUS(st);
+}
+
+static void begin(void) {
+    rolls0  = ee_rec[EE_ROLLS0];
+    presses = 0;
+}
+
+#if !BOARD_TOUCH
+static const unsigned PULSE_US[4] = { 5u, 20u, 100u, 300u };
+
+// ─── 1. Weck-Druck prellt ─────────────────────────────────────────────
+static int wake_bounce(unsigned k) {
+    uint64_t t = sim.now_ns + SIM_MS(ASLEEP_MS);
+    unsigned pulse_us = PULSE_US[k % 4u], gap_ms = 1u << (k / 4u);
+    uint8_t  woke;
+
+    begin();
+    sim_button(t, 1u);
+    sim_button(t += pulse_us * 1000u, 0u);
+    sim_button(t += SIM_MS(gap_ms), 1u);
+    sim_button(t += SIM_MS(150), 0u);
+    sim_run(call_loop, t + SIM_MS(ROLL_MS));  // ein Wurf wäre jetzt gezählt
+    after_abort();
+    woke = rolls();
+    sim_press(sim.now_ns + SIM_MS(10), SIM_MS(60));
+    sim_run(call_loop, sim.now_ns + SIM_MS(ROLL_MS));
+    printf("  Impuls %3u µs, Lücke %u ms: Würfe nach Weck-Druck %u (soll 0), "
+           "nach Druck %u (soll 1), Drücke %u (soll 2)  %s\n",
+           pulse_us, gap_ms, woke, rolls(), presses,
+           !woke && rolls() == 1u && presses == 2u ? "ok" : "FEHLER");
+    return woke || rolls() != 1u || presses != 2u;
+}
+#endif
+
+// ─── 2. Druck beim Einschlafen ────────────────────────────────────────
+// Druck o ms nach dem Entscheid, kurz (endet noch im Schreiben) oder
+// lang; nach dem Loslassen und dem Schreiben muss der Kern wach sein
+// und die letzte Zahl zeigen — ohne weitere Flanke.
+static int sleep_press(unsigned k) {
+    uint64_t o = SIM_MS(k / 2u * 8u), hold = SIM_MS(k & 1u ? 400u : HOLD_MS);
+    uint64_t t = sim.now_ns + o, end = o + hold > SIM_MS(WRITE_MS) ? o + hold : SIM_MS(WRITE_MS);
+    uint8_t  ok;
+
+    begin();
+    sim_press(t, hold);
+    sim_run(call_loop, sim.now_ns + end + SIM_MS(CALM_MS));
+    ok = state == ST_SHOW && !btn_busy && t_lit > t && presses == 1u && !rolls();
+    printf("  %3u ms, %3u ms gedrückt: %-6s Drücke %u, Würfe %u, LEDs %s  %s\n",
+           (unsigned)(o / 1000000u), (unsigned)(hold / 1000000u),
+           state < sizeof ST_NAME / sizeof ST_NAME[0] ? ST_NAME[state] : "?",
+           presses, rolls(), t_lit > t ? "an" : "aus", ok ? "ok" : "FEHLER");
+    return !ok;
+}
+
+// ─── 3. Schlaf hält ───────────────────────────────────────────────────
+// Ohne Druck muss der erste SLEEP nach dem Entscheid halten, auch wenn
+// Timer0 (und Timer2: gedrosselter Tastgrad läuft weiter) genau im
+// letzten Takt davor überläuft — bei GIE = 0 bliebe das Flag stehen und
+// machte SLEEP zum NOP (→ WAKE, SHOW, nächster Timeout). Das Fenster
+// ist wenige Tcy breit: der Test setzt die Flags beim ersten SLEEP
+// selbst, die Phase des Wurf-Drucks verschiebt die Ticks dazu.
+#define PHASES  16u
+
+static void timer_flags(void) {
+    sim.reg[SIM_INTCON] |= 0x04u;                     // TMR0IF
+#if defined(_16F1825)
+    sim.reg[SIM_PIR1]   |= 0x02u;                     // TMR2IF
+#endif
+    sim.on_sleep = NULL;                              // nur beim ersten SLEEP
+}
+
+static int sleep_holds(unsigned k) {
+    uint64_t sleeps;
+
+    if (to_sleep((uint64_t)k * 62500u)) return 1;
+    sleeps       = sim.sleeps;
+    sim.on_sleep = timer_flags;
+    sim_run(call_loop, sim.now_ns + SIM_MS(2000));
+    if (state == ST_SLEEP && (BOARD_TOUCH || sim.sleeps == sleeps + 1u))   // Touch: WDT-Scans
+        return 0;
+    printf("  Phase %5.1f µs: %s nach %llu SLEEP  FEHLER\n", k * 62.5,
+           state < sizeof ST_NAME / sizeof ST_NAME[0] ? ST_NAME[state] : "?",
+           (unsigned long long)(sim.sleeps - sleeps));
+    return 1;
+}
+
+#if BOARD_TOUCH
+// ─── 4. Scan-Fenster [FIX-12] ─────────────────────────────────────────
+// touch_scan() leiht Timer0 und stellt die Tick-Phase danach um das
+// Fenster weiter. Jede Start-Phase 0 … 255, beide Takte: läuft sie über,
+// muss TMR0IF den Tick nachholen (und sonst nicht gesetzt sein).
+static unsigned scan_bad;
+
+static void call_scans(void) {
+    static const uint8_t P[2] = { CLK_HF, CLK_MF };
+    unsigned k, t;
+    uint8_t  g;
+
+    INTCONbits.GIE = 0;
+    for (k = 0; k < 2u; k++) {
+        clk_set(P[k]);
+        g = P[k] == CLK_HF ? TOUCH_GATE_US / 4u : TOUCH_GATE_US / 8u;
+        for (t = 0; t < 256u; t++) {
+            INTCONbits.TMR0IF = 0;
+            TMR0 = (uint8_t)t;
+            (void)touch_scan();
+            if ((t + g > 255u) != INTCONbits.TMR0IF) scan_bad++;
+        }
+    }
+}
+
+static int scan_wrap(unsigned k) {
+    (void)k;
+    sim_run(call_scans, sim.now_ns + SIM_MS(1000));
+    printf("Scan-Fenster (2 × 256 Phasen): %u Fehler\n", scan_bad);
+    return scan_bad != 0;
+}
+#endif
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(void) {
+    unsigned k, n, bad = 0;
+
+    boot();
+    printf("# %s  btn_test  Würfel %u\n", FW_NAME, (unsigned)DICE_N);
+    for (k = n = 0; k < PHASES; k++) n += (unsigned)run_case(sleep_holds, k);
+    printf("Schlaf hält (%u Phasen): %u Fehler\n", PHASES, n);
+    bad += n;
+    if (to_sleep(0u)) {
+        fprintf(stderr, "Auto-Sleep nicht erreicht\n");
+        return 1;
+    }
+#if BOARD_TOUCH
+    bad += (unsigned)run_case(scan_wrap, 0u);
+#else
+    printf("Weck-Druck prellt\n");
+    for (k = 0; k < 16u; k++) bad += (unsigned)run_case(wake_bounce, k);
+#endif
+    printf("Druck beim Einschlafen (ms nach dem Entscheid)\n");
+    for (k = 0; k < 2u * (WRITE_MS / 8u); k++) bad += (unsigned)run_case(sleep_press, k);
+    printf("%s\n", bad ? "FEHLER" : "ok");
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,335 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  dice_energy  ·  Energie pro Wurf / Startup / Idle-Fenster
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Lässt die Firmware in der Host-Simulation laufen und ordnet die
+ *  Energie (energy.h) den Phasen zu. Die Phasen kommen aus den
+ *  Firmware-Funktionen selbst (gcc -finstrument-functions):
+ *
+ *    STARTUP  startup_seq()      Eintritt → Rücksprung startup_done()
+ *    ROLL     start_roll()       Eintritt → Rücksprung finish_roll()
+ *    SLEEP    enter_sleep()      Eintritt → Rücksprung
+ *    IDLE     alles dazwischen   (Ergebnis-Anzeige, Taster-Polling)
+ *
+ *  Zeit bis zum Ergebnis: start_roll() → erstes rng_roll() (Tabelle:
+ *  ROLL, danach der Ergebnis-Frame). -P wählt das Roll-Profil
+ *  (0 voll, 1 kurz, 2 sofort; 16F84A: 0 voll, 1 sofort) wie nach der
+ *  Geste beim Einschalten.
+ *
+ *  16F1825: die VDD-Messung vdd_check() (FVR + ADC) zählt zusätzlich
+ *  (Anzahl, Ø µs, Ø Tcy, Ø µAs); -v gibt die Batteriespannung auch der
+ *  Simulation vor und bestimmt damit den LED-Tastgrad.
+ *
+ *  Build:
+ *    gcc -O2 -D_16F1825 -Ihost -finstrument-functions \
+ *        -finstrument-functions-exclude-file-list=sim.c,energy.c \
+ *        -o dice_energy_1825 host/dice_energy.c host/sim.c host/energy.c
+ *    (16F84A: -D_16F84A, Ausgabe dice_energy_84a)
+ *
+ *  Aufruf:
+ *    dice_energy [-t ms] [-p ms:halten_ms]... [-r Ω] [-v V] [-f hz]
+ *                [-n Würfe/Tag] [-c mAh] [-P profil]
+ *                [--max-roll-uas X] [--max-startup-uas X] [--max-idle-ua X]
+ *                [--max-result-ms X]
+ *
+ *  Ausgabe: JSON auf stdout. Exit-Code 1, wenn ein Budget überschritten
+ *  ist → im Build als Regressionsschranke verwendbar.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+#include "energy.h"
+
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u
+#define FW_CAP   2500.0         // 3× AA
+#define FW_SHOW  led_out        // show() ist dort nur ein Makro
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u
+#define FW_CAP   1200.0         // 2× AAA
+#define FW_SHOW  show
+#endif
+#undef main
+#if !BOARD_PROFILES
+static uint8_t profile;         // Firmware ohne Roll-Profile: immer PROF_FULL
+#endif
+
+#define NO_INSTR  __attribute__((no_instrument_function))
+#define MAX_WIN   256
+
+// ─── Phasen ───────────────────────────────────────────────────────────
+enum phase { PH_IDLE, PH_STARTUP, PH_ROLL, PH_SLEEP, PH_COUNT };
+static const char *const PH_NAME[PH_COUNT] = { "idle", "startup", "roll", "sleep" };
+
+struct window {
+    enum phase    ph;
+    enum phase    next;         // Folgephase (IDLE → SLEEP = Timeout)
+    double        ms;
+    struct energy e;
+    unsigned      shows;
+};
+
+static struct window win[MAX_WIN];
+static unsigned      n_win;
+static enum phase    phase = PH_IDLE;
+static uint64_t      ph_t0;
+static struct energy ph_e0;
+static unsigned      ph_shows;
+
+// Zeit bis zum Ergebnis je Wurf
+static unsigned      res_n;
+static double        res_ms, res_max;
+static int           res_wait;            // 1 = Wurf läuft, noch kein rng_roll()
+
+#if defined(_16F1825)
+// VDD-Messung: läuft innerhalb anderer Phasen, eigene Summe
+static unsigned      vm_n;
+static uint64_t      vm_ns, vm_tcy, vm_t0, vm_c0;
+static double        vm_uas;
+static struct energy vm_e0;
+#endif
+
+static NO_INSTR void phase_switch(enum phase next) {
+    struct energy now = energy_total();
+
+    if (n_win < MAX_WIN && sim.now_ns > ph_t0) {
+        win[n_win].ph    = phase;
+        win[n_win].next  = next;
+        win[n_win].ms    = (sim.now_ns - ph_t0) / 1e6;
+        win[n_win].e     = energy_diff(now, ph_e0);
+        win[n_win].shows = ph_shows;
+        n_win++;
+    }
+    phase    = next;
+    ph_t0    = sim.now_ns;
+    ph_e0    = now;
+    ph_shows = 0;
+}
+
+NO_INSTR void __cyg_profile_func_enter(void *fn, void *site) {
+    (void)site;
+    if      (fn == (void *)FW_SHOW)        ph_shows++;
+    else if (fn == (void *)startup_seq)    phase_switch(PH_STARTUP);
+    else if (fn == (void *)start_roll) {
+        phase_switch(PH_ROLL);
+        res_wait = 1;
+    } else if (fn == (void *)rng_roll && res_wait) {
+        double ms = (sim.now_ns - ph_t0) / 1e6;
+        res_wait = 0;
+        res_n++;
+        res_ms += ms;
+        if (ms > res_max) res_max = ms;
+    }
+#if BOARD_SLEEP
+    else if (fn == (void *)enter_sleep)    phase_switch(PH_SLEEP);
+#endif
+#if defined(_16F1825)
+    else if (fn == (void *)vdd_check) {
+        vm_t0 = sim.now_ns;
+        vm_c0 = sim.cycles;
+        vm_e0 = energy_total();
+    }
+#endif
+}
+
+NO_INSTR void __cyg_profile_func_exit(void *fn, void *site) {
+    (void)site;
+    if (fn == (void *)startup_done || fn == (void *)finish_roll)
+        phase_switch(PH_IDLE);
+#if BOARD_SLEEP
+    else if (fn == (void *)enter_sleep)
+        phase_switch(PH_IDLE);
+#endif
+#if defined(_16F1825)
+    else if (fn == (void *)vdd_check) {
+        vm_n++;
+        vm_ns  += sim.now_ns - vm_t0;
+        vm_tcy += sim.cycles - vm_c0;
+        vm_uas += energy_uas(energy_diff(energy_total(), vm_e0));
+    }
+#endif
+}
+
+static NO_INSTR void on_frame(uint64_t t_ns, uint8_t leds) {
+    energy_frame(t_ns, leds);
+}
+
+// ─── JSON-Ausgabe ─────────────────────────────────────────────────────
+static NO_INSTR void print_energy(const char *key, double ms, struct energy e) {
+    printf("\"%s\":{\"ms\":%.3f,\"uas\":%.3f,\"led_uas\":%.3f,\"cpu_uas\":%.3f,\"sleep_uas\":%.3f,"
+           "\"pull_uas\":%.3f}",
+           key, ms, energy_uas(e), e.led_uas, e.cpu_uas, e.sleep_uas, e.pull_uas);
+}
+
+static NO_INSTR void print_list(enum phase ph) {
+    unsigned k, first = 1;
+    printf("\"%ss\":[", PH_NAME[ph]);
+    for (k = 0; k < n_win; k++) {
+        if (win[k].ph != ph) continue;
+        printf("%s{\"ms\":%.3f,\"uas\":%.3f,\"led_uas\":%.3f,\"cpu_uas\":%.3f,"
+               "\"sleep_uas\":%.3f,\"shows\":%u,\"until\":\"%s\"}",
+               first ? "" : ",", win[k].ms, energy_uas(win[k].e),
+               win[k].e.led_uas, win[k].e.cpu_uas, win[k].e.sleep_uas,
+               win[k].shows, PH_NAME[win[k].next]);
+        first = 0;
+    }
+    printf("]");
+}
+
+struct stats { unsigned n; double ms, uas, max_uas; };
+
+static NO_INSTR struct stats collect(enum phase ph, int only_to_sleep) {
+    struct stats s = { 0, 0.0, 0.0, 0.0 };
+    unsigned k;
+    for (k = 0; k < n_win; k++) {
+        double u;
+        if (win[k].ph != ph) continue;
+        if (only_to_sleep && win[k].next != PH_SLEEP) continue;
+        u = energy_uas(win[k].e);
+        s.n++;
+        s.ms  += win[k].ms;
+        s.uas += u;
+        if (u > s.max_uas) s.max_uas = u;
+    }
+    return s;
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int NO_INSTR main(int argc, char **argv) {
+    struct energy_model m;
+    struct energy       total;
+    struct stats        roll, idle, idle_to, slp, start;
+    uint64_t t_end   = SIM_MS(70000);
+    uint32_t fosc    = FW_FOSC;
+    double   per_day = 10.0, cap = FW_CAP;
+    double   max_roll = 0.0, max_start = 0.0, max_idle = 0.0, max_res = 0.0;
+    double   base_ua, day_uas, cycle_s;
+    int      scripted = 0, fail = 0, i;
+
+    energy_default(&m);
+    for (i = 1; i < argc; i++)
+        if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            fosc = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    sim_reset(fosc);
+
+    for (i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) goto usage;
+        if      (!strcmp(a, "-t")) t_end = SIM_MS(strtoull(argv[++i], NULL, 10));
+        else if (!strcmp(a, "-r")) m.r_led = atof(argv[++i]);
+        else if (!strcmp(a, "-v")) m.vdd = atof(argv[++i]);
+        else if (!strcmp(a, "-f")) i++;
+        else if (!strcmp(a, "-n")) per_day = atof(argv[++i]);
+        else if (!strcmp(a, "-c")) cap = atof(argv[++i]);
+        else if (!strcmp(a, "--max-roll-uas"))    max_roll  = atof(argv[++i]);
+        else if (!strcmp(a, "--max-startup-uas")) max_start = atof(argv[++i]);
+        else if (!strcmp(a, "--max-idle-ua"))     max_idle  = atof(argv[++i]);
+        else if (!strcmp(a, "--max-result-ms"))   max_res   = atof(argv[++i]);
+        else if (!strcmp(a, "-P")) {
+            profile = (uint8_t)strtoul(argv[++i], NULL, 10);
+            if (profile >= (BOARD_PROFILES ? PROF_N : 1u)) goto usage;
+        }
+        else if (!strcmp(a, "-p")) {
+            unsigned long at, hold;
+            if (sscanf(argv[++i], "%lu:%lu", &at, &hold) != 2) goto usage;
+            sim_press(SIM_MS(at), SIM_MS(hold));
+            scripted = 1;
+        } else goto usage;
+    }
+    if (!scripted) {                    // Default: drei Würfe, dann Ruhe
+        sim_press(SIM_MS(3000),  SIM_MS(100));
+        sim_press(SIM_MS(12000), SIM_MS(100));
+        sim_press(SIM_MS(21000), SIM_MS(100));
+    }
+
+    sim_attach_isr(isr);
+    sim.on_frame = on_frame;
+    sim.on_clock = energy_sample;       // Kernstrom je Taktprofil, FVR/ADC, Pull-up
+#if defined(_16F1825)
+    sim.vdd_mv   = (uint16_t)(m.vdd * 1000.0 + 0.5);
+#endif
+    energy_init(&m);
+    sim_run(fw_main, t_end);
+    phase_switch(PH_IDLE);
+    total = energy_total();
+
+    start   = collect(PH_STARTUP, 0);
+    roll    = collect(PH_ROLL, 0);
+    idle    = collect(PH_IDLE, 0);
+    idle_to = collect(PH_IDLE, 1);
+    slp     = collect(PH_SLEEP, 0);
+
+    // Hochrechnung: n Würfe/Tag, danach Idle-Timeout bis SLEEP;
+    // ohne SLEEP (16F84A) läuft der Rest des Tages im Idle-Strom.
+    cycle_s = roll.n ? roll.ms / roll.n / 1e3 : 0.0;
+    day_uas = roll.n ? per_day * roll.uas / roll.n : 0.0;
+    if (idle_to.n) {
+        cycle_s += idle_to.ms / idle_to.n / 1e3;
+        day_uas += per_day * idle_to.uas / idle_to.n;
+        base_ua  = m.i_sleep_ua;
+    } else {
+        base_ua  = idle.ms > 0.0 ? idle.uas / (idle.ms / 1e3) : 0.0;
+    }
+    day_uas += (86400.0 - per_day * cycle_s) * base_ua;
+
+    printf("{\"chip\":\"%s\",\"fosc_hz\":%u,\"vdd\":%.2f,\"r_led\":%.1f,"
+           "\"i_led_ma\":%.3f,\"i_sleep_ua\":%.3f,",
+           FW_NAME, sim.fosc_hz, m.vdd, m.r_led, energy_led_ma(), m.i_sleep_ua);
+    print_energy("total", total.t_s * 1e3, total);
+    printf(",\"avg_ua\":%.3f,", total.t_s > 0.0 ? energy_uas(total) / total.t_s : 0.0);
+    printf("\"startup_uas\":%.3f,\"roll_avg_uas\":%.3f,\"roll_max_uas\":%.3f,"
+           "\"roll_avg_ms\":%.3f,\"idle_timeout_avg_uas\":%.3f,\"sleep_uas\":%.3f,",
+           start.uas, roll.n ? roll.uas / roll.n : 0.0, roll.max_uas,
+           roll.n ? roll.ms / roll.n : 0.0,
+           idle_to.n ? idle_to.uas / idle_to.n : 0.0, slp.uas);
+    printf("\"profile\":%u,\"result_avg_ms\":%.3f,\"result_max_ms\":%.3f,",
+           (unsigned)profile, res_n ? res_ms / res_n : 0.0, res_max);
+    print_list(PH_STARTUP); printf(",");
+    print_list(PH_ROLL);    printf(",");
+    print_list(PH_IDLE);    printf(",");
+    print_list(PH_SLEEP);
+#if defined(_16F1825)
+    if (vm_n)
+        printf(",\"vdd_check\":{\"n\":%u,\"us\":%.1f,\"tcy\":%.1f,\"uas\":%.4f}",
+               vm_n, vm_ns / 1e3 / vm_n, (double)vm_tcy / vm_n, vm_uas / vm_n);
+#endif
+    printf(",\"projection\":{\"rolls_per_day\":%.1f,\"capacity_mah\":%.0f,"
+           "\"uas_per_day\":%.1f,\"days\":%.1f}}\n",
+           per_day, cap, day_uas, day_uas > 0.0 ? cap * 3.6e6 / day_uas : 0.0);
+
+    // ─── Budgets ──────────────────────────────────────────────────────
+    if (max_roll > 0.0 && roll.max_uas > max_roll) {
+        fprintf(stderr, "BUDGET: Wurf %.1f µAs > %.1f µAs\n", roll.max_uas, max_roll);
+        fail = 1;
+    }
+    if (max_start > 0.0 && start.uas > max_start) {
+        fprintf(stderr, "BUDGET: Startup %.1f µAs > %.1f µAs\n", start.uas, max_start);
+        fail = 1;
+    }
+    if (max_idle > 0.0 && idle.ms > 0.0 && idle.uas / (idle.ms / 1e3) > max_idle) {
+        fprintf(stderr, "BUDGET: Idle %.1f µA > %.1f µA\n",
+                idle.uas / (idle.ms / 1e3), max_idle);
+        fail = 1;
+    }
+    if (max_res > 0.0 && res_max > max_res) {
+        fprintf(stderr, "BUDGET: Zeit bis Ergebnis %.1f ms > %.1f ms\n", res_max, max_res);
+        fail = 1;
+    }
+    return fail;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-t ms] [-p ms:halten_ms]... [-r ohm] [-v volt] [-f hz]\n"
+                    "          [-n wuerfe_pro_tag] [-c mah] [-P profil]\n"
+                    "          [--max-roll-uas X] [--max-startup-uas X] [--max-idle-ua X]\n"
+                    "          [--max-result-ms X]\n",
+            argv[0]);
+    return 2;
+}
@@ -0,0 +1,414 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  dice_life  ·  Batterielaufzeit aus Nutzungsmodellen (Zeitraffer)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Lässt die unveränderte Firmware über Wochen bis Jahre Gerätezeit
+ *  laufen, getrieben von einem Nutzungsmodell, und rechnet die Energie
+ *  (energy.h) auf die Batterielaufzeit hoch.
+ *
+ *  Zeitraffer: SLEEP springt ohnehin bis zum nächsten Weck-Ereignis,
+ *  dazu sim.warp — die NOP-Warteschleifen auf den nächsten Timer-Tick
+ *  laufen in einem Schritt. Wach bleibt nur die Arbeit je Tick (ISR,
+ *  step(), beim 16F1825 die PWM-Interrupts beim Ausblenden).
+ *  Richtwert „daily“, 365 Tage je Batterie: 16F84A ~4 s, 16F1825 ~22 s
+ *  Rechenzeit.
+ *
+ *  Modelle (-m):
+ *    daily  n Würfe am Tag (-n, Default 10), zufällig zwischen 8 und 22 Uhr
+ *    night  daily + jeden 7. Tag Spieleabend: 19–22 Uhr alle 20–90 s ein Wurf
+ *    stuck  daily + alle 30 Tage klemmt der Taster 8 h (Tasche, Schublade)
+ *  Je Wurf ein Druck von 80–250 ms. Ist der Würfel schon aus (letzter
+ *  Druck länger als SLEEP_TIMEOUT + Wurfdauer her), drückt der Nutzer
+ *  erst zum Wecken und 0,5–1,5 s später zum Würfeln.
+ *
+ *  Zustände: gezählt wird beim Eintritt in wait_next() (gcc
+ *  -finstrument-functions) — der Abschnitt bis zum nächsten Eintritt
+ *  gehört zum Zustand, in dem gewartet wird; „Sleep“ enthält
+ *  enter_sleep() mit dem EEPROM-Schreiben und die verschlafene Zeit.
+ *
+ *  Batterien: je ein eigener Lauf (fork) mit der Spannung des Packs,
+ *  beim 16F1825 also mit dem passenden LED-Tastgrad (vdd_check):
+ *    3×AA  2500 mAh, 4,5 V   (16F84A; 16F1825 mit gekürztem Tastgrad)
+ *    2×AAA 1200 mAh, 3,0 V   (16F1825; 16F84A nur als PIC16LF84A)
+ *  Laufzeit ohne und mit Selbstentladung (-k %/Jahr, Default 2 — Alkali).
+ *  Vorwiderstand: LED-Ladung ∝ I_LED, aus demselben Lauf umgerechnet.
+ *  SLEEP_TIMEOUT ist eine Konstante der Firmware → je Wert ein Build:
+ *    -DSLEEP_TIMEOUT='MS(5000)'   (16F1825 höchstens MS(32000))
+ *
+ *  Build:
+ *    gcc -O2 -D_16F1825 -Ihost -finstrument-functions \
+ *        -finstrument-functions-exclude-file-list=sim.c,energy.c \
+ *        -o dice_life_1825 host/dice_life.c host/sim.c host/energy.c
+ *    (16F84A: -D_16F84A, Ausgabe dice_life_84a)
+ *
+ *  Aufruf:
+ *    dice_life [-m daily|night|stuck] [-d tage] [-n würfe/tag] [-s seed]
+ *              [-P profil] [-k %/jahr]
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "sim.h"
+#include "energy.h"
+
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u
+#define FW_PACK  0u             // 3× AA
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u
+#define FW_PACK  1u             // 2× AAA
+#endif
+#undef main
+#if !BOARD_PROFILES
+static uint8_t profile;         // Firmware ohne Roll-Profile: immer PROF_FULL
+#endif
+
+#define NO_INSTR  __attribute__((no_instrument_function))
+#define DAY_MS    86400000ull
+#define HOUR_MS   3600000ull
+
+// ─── Batterien ────────────────────────────────────────────────────────
+struct pack { const char *name; double mah, vdd; };
+
+static const struct pack PACKS[2] = {
+    { "3×AA  2500 mAh", 2500.0, 4.5 },
+    { "2×AAA 1200 mAh", 1200.0, 3.0 },
+};
+
+// ─── Zustände (enum state) ────────────────────────────────────────────
+#define N_STATE  7u
+static const char *const ST_NAME[N_STATE] = {
+    "Startup", "Wurf", "Blinken", "Idle", "Anzeige", "Sleep", "Wecken",
+};
+
+// Ergebnis eines Laufs (Kind → Eltern über eine Pipe)
+struct result {
+    struct energy by[N_STATE];
+    double        days, wall_s, led_ma;
+    unsigned long rolls, wakes, presses, sessions;
+    double        awake_max_s;
+};
+
+static struct result res;
+static struct energy acc_last;
+static uint8_t       acc_state = ST_STARTUP;
+static uint64_t      awake_t0;
+
+static NO_INSTR void account(void) {
+    struct energy now = energy_total();
+    struct energy d   = energy_diff(now, acc_last);
+
+    res.by[acc_state].led_uas   += d.led_uas;
+    res.by[acc_state].cpu_uas   += d.cpu_uas;
+    res.by[acc_state].sleep_uas += d.sleep_uas;
+    res.by[acc_state].pull_uas  += d.pull_uas;
+    res.by[acc_state].t_s       += d.t_s;
+    acc_last  = now;
+    acc_state = state < N_STATE ? state : ST_IDLE;
+}
+
+NO_INSTR void __cyg_profile_func_enter(void *fn, void *site) {
+    (void)site;
+    if      (fn == (void *)wait_next)  account();
+    else if (fn == (void *)start_roll) res.rolls++;
+    else if (fn == (void *)enter_sleep) {
+        double s = (sim.now_ns - awake_t0) / 1e9;
+        if (s > res.awake_max_s) res.awake_max_s = s;
+        res.sessions++;
+    }
+}
+
+NO_INSTR void __cyg_profile_func_exit(void *fn, void *site) {
+    (void)site;
+    if (fn == (void *)enter_sleep) awake_t0 = sim.now_ns;
+}
+
+static NO_INSTR void on_frame(uint64_t t_ns, uint8_t leds) {
+    energy_frame(t_ns, leds);
+}
+
+// ─── Host-Zufall (splitmix64, wie rng_test) ───────────────────────────
+static uint64_t host_s;
+
+static NO_INSTR uint64_t splitmix64(void) {
+    uint64_t z = (host_s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static NO_INSTR uint64_t host_range(uint64_t lo, uint64_t hi) {
+    return lo + splitmix64() % (hi - lo + 1u);
+}
+
+// ─── Nutzungsmodell → Tastendrücke ────────────────────────────────────
+enum model { M_DAILY, M_NIGHT, M_STUCK, M_N };
+static const char *const M_NAME[M_N] = { "daily", "night", "stuck" };
+
+static const unsigned ROLL_MS[PROF_N] = {   // Druck → Wurf fertig
+    [PROF_FULL]  = 3700u,
+#if !BOARD_PROF_LITE
+    [PROF_SHORT] = 610u,
+#endif
+    [PROF_NOW]   = 40u
+};
+
+static uint64_t last_press, last_release;
+static uint64_t timeout_ms;
+
+static NO_INSTR void press(uint64_t t_ms, uint64_t hold_ms) {
+    sim_press(SIM_MS(t_ms), SIM_MS(hold_ms));
+    last_press   = t_ms;
+    last_release = t_ms + hold_ms;
+    res.presses++;
+}
+
+// Ein Wurf aus Sicht des Nutzers: dunkel → erst wecken
+static NO_INSTR void use(uint64_t t_ms) {
+    if (t_ms < last_release + 300u) return;         // Taster noch unten (klemmt)
+    if (t_ms - last_press > timeout_ms + ROLL_MS[profile]) {
+        press(t_ms, host_range(80u, 250u));
+        t_ms += host_range(500u, 1500u);
+        res.wakes++;
+    }
+    press(t_ms, host_range(80u, 250u));
+}
+
+static NO_INSTR int cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static NO_INSTR void schedule(enum model m, unsigned days, unsigned per_day) {
+    uint64_t *t = malloc((per_day + 600u) * sizeof *t);
+    unsigned  d, k, n;
+
+    if (!t) abort();
+    last_press = last_release = 0;
+    for (d = 0; d < days; d++) {
+        uint64_t day = d * DAY_MS, stuck = 0, x;
+
+        n = 0;
+        for (k = 0; k < per_day; k++)
+            t[n++] = day + host_range(8u * HOUR_MS, 22u * HOUR_MS - 1u);
+        if (m == M_NIGHT && d % 7u == 6u)
+            for (x = day + 19u * HOUR_MS; x < day + 22u * HOUR_MS && n < per_day + 600u;
+                 x += host_range(20000u, 90000u))
+                t[n++] = x;
+        if (m == M_STUCK && d % 30u == 13u)
+            stuck = day + host_range(9u * HOUR_MS, 17u * HOUR_MS);
+        qsort(t, n, sizeof *t, cmp_u64);
+        for (k = 0; k < n; k++) {
+            if (stuck && t[k] >= stuck) {           // Taster klemmt 8 h
+                press(stuck, 8u * HOUR_MS);
+                stuck = 0;
+            }
+            use(t[k]);
+        }
+        if (stuck) press(stuck, 8u * HOUR_MS);
+    }
+    free(t);
+}
+
+// ─── Ein Lauf: Firmware mit Pack-Spannung über alle Tage ─────────────
+static NO_INSTR void run(const struct pack *p, enum model m, unsigned days,
+                         unsigned per_day, uint64_t seed) {
+    struct energy_model em;
+    struct timespec     w0, w1;
+
+    energy_default(&em);
+    em.vdd = p->vdd;
+    sim_reset(FW_FOSC);
+    host_s = seed;
+    schedule(m, days, per_day);
+
+    sim_attach_isr(isr);
+    sim.warp     = 1;
+    sim.on_frame = on_frame;
+    sim.on_clock = energy_sample;
+#if defined(_16F1825)
+    sim.vdd_mv   = (uint16_t)(p->vdd * 1000.0 + 0.5);
+#endif
+    energy_init(&em);
+    acc_last = energy_total();
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &w0);
+    sim_run(fw_main, (uint64_t)days * SIM_MS(DAY_MS));
+    account();
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &w1);
+
+    res.days   = days;
+    res.led_ma = energy_led_ma();
+    res.wall_s = (w1.tv_sec - w0.tv_sec) + (w1.tv_nsec - w0.tv_nsec) / 1e9;
+}
+
+// Lauf im Kindprozess: Firmware-Variablen beginnen je Pack frisch,
+// beide Packs rechnen parallel
+struct child { pid_t pid; int fd; };
+
+static NO_INSTR int pack_start(const struct pack *p, enum model m, unsigned days,
+                               unsigned per_day, uint64_t seed, struct child *c) {
+    int fd[2];
+
+    if (pipe(fd)) return -1;
+    c->pid = fork();
+    if (c->pid < 0) return -1;
+    if (c->pid == 0) {
+        close(fd[0]);
+        run(p, m, days, per_day, seed);
+        if (write(fd[1], &res, sizeof res) != (ssize_t)sizeof res) _exit(1);
+        _exit(0);
+    }
+    close(fd[1]);
+    c->fd = fd[0];
+    return 0;
+}
+
+static NO_INSTR int pack_wait(struct child *c, struct result *out) {
+    int st = read(c->fd, out, sizeof *out) == (ssize_t)sizeof *out ? 0 : -1;
+
+    close(c->fd);
+    waitpid(c->pid, NULL, 0);
+    return st;
+}
+
+// ─── Hochrechnung ─────────────────────────────────────────────────────
+static NO_INSTR double total_uas(const struct result *r) {
+    double   s = 0.0;
+    unsigned k;
+    for (k = 0; k < N_STATE; k++) s += energy_uas(r->by[k]);
+    return s;
+}
+
+static NO_INSTR double led_uas(const struct result *r) {
+    double   s = 0.0;
+    unsigned k;
+    for (k = 0; k < N_STATE; k++) s += r->by[k].led_uas;
+    return s;
+}
+
+// Laufzeit in Jahren; Selbstentladung als fester Anteil der Nennkapazität
+static NO_INSTR double years(double mah, double mah_day, double self_pct) {
+    double per_day = mah_day + mah * self_pct / 100.0 / 365.0;
+    return per_day > 0.0 ? mah / per_day / 365.0 : 0.0;
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int NO_INSTR main(int argc, char **argv) {
+    static const double R_84A[]  = { 150.0, 220.0, 270.0, 330.0, 470.0, 680.0 };
+    static const double R_1825[] = { 33.0, 47.0, 68.0, 100.0, 150.0, 220.0 };
+    const double *rs = FW_PACK ? R_1825 : R_84A;
+    struct result r[2];
+    struct child  ch[2];
+    enum model m = M_DAILY;
+    unsigned   days = 28u, per_day = 10u, k, p;
+    uint64_t   seed = 1u;
+    double     self_pct = 2.0, day_uas, led_day;
+    int        i;
+
+    for (i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) goto usage;
+        if (!strcmp(a, "-m")) {
+            for (m = 0; m < M_N && strcmp(argv[i + 1], M_NAME[m]); m++) continue;
+            if (m == M_N) goto usage;
+            i++;
+        }
+        else if (!strcmp(a, "-d")) days     = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-n")) per_day  = (unsigned)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-s")) seed     = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-k")) self_pct = atof(argv[++i]);
+        else if (!strcmp(a, "-P")) {
+            profile = (uint8_t)strtoul(argv[++i], NULL, 10);
+            if (profile >= (BOARD_PROFILES ? PROF_N : 1u)) goto usage;
+        } else goto usage;
+    }
+    if (!days || per_day > 1000u) goto usage;
+    timeout_ms = (uint64_t)SLEEP_TIMEOUT * TICK_US / 1000u;
+
+    for (p = 0; p < 2u; p++)
+        if (pack_start(&PACKS[p], m, days, per_day, seed, &ch[p])) return 1;
+    for (p = 0; p < 2u; p++)
+        if (pack_wait(&ch[p], &r[p])) {
+            fprintf(stderr, "Lauf %s fehlgeschlagen\n", PACKS[p].name);
+            return 1;
+        }
+
+    // ─── Bericht (Pack des Boards) ────────────────────────────────────
+    {
+        const struct result *b = &r[FW_PACK];
+        double tot = total_uas(b);
+
+        printf("# %s  dice_life  Modell %s  %u Tage  %u Würfe/Tag  Profil %u  "
+               "SLEEP_TIMEOUT %.1f s\n", FW_NAME, M_NAME[m], days, per_day,
+               (unsigned)profile, timeout_ms / 1e3);
+        printf("# %lu Würfe, %lu Drücke (%lu zum Wecken), %lu Wachphasen, "
+               "längste %.1f s\n", b->rolls, b->presses, b->wakes, b->sessions,
+               b->awake_max_s);
+        printf("# Zeitraffer: %u Tage in %.2f s Rechenzeit (%.1f Mio.-fach)\n\n",
+               days, b->wall_s, b->wall_s > 0.0 ? days * 0.0864 / b->wall_s : 0.0);
+
+        printf("%s, %.1f V                µAh/Tag\n", PACKS[FW_PACK].name,
+               PACKS[FW_PACK].vdd);
+        printf("Zustand    Zeit/Tag    gesamt   Anteil      LED     Kern    "
+               "Sleep   Taster\n");
+        for (k = 0; k < N_STATE; k++) {
+            const struct energy *e = &b->by[k];
+            double u = energy_uas(*e);
+            if (e->t_s <= 0.0) continue;
+            printf("%-8s %8.1f s %9.1f %7.1f %% %8.1f %8.1f %8.1f %8.1f\n",
+                   ST_NAME[k], e->t_s / days, u / days / 3600.0,
+                   tot > 0.0 ? 100.0 * u / tot : 0.0,
+                   e->led_uas / days / 3600.0, e->cpu_uas / days / 3600.0,
+                   e->sleep_uas / days / 3600.0, e->pull_uas / days / 3600.0);
+        }
+        printf("Summe               %9.1f\n\n", tot / days / 3600.0);
+    }
+
+    printf("Batterie           VDD   mAh/Tag   Laufzeit   mit %.1f %%/Jahr Selbstentladung\n",
+           self_pct);
+    for (p = 0; p < 2u; p++) {
+        double mah_day = total_uas(&r[p]) / days / 3.6e6;
+        printf("%-16s %4.1f V  %7.4f  %6.1f Jahre  %6.1f Jahre\n", PACKS[p].name,
+               PACKS[p].vdd, mah_day, years(PACKS[p].mah, mah_day, 0.0),
+               years(PACKS[p].mah, mah_day, self_pct));
+    }
+
+    // Vorwiderstand: LED-Ladung mit I_LED(R) / I_LED(R0) skaliert
+    {
+        const struct pack *pk = &PACKS[FW_PACK];
+        struct energy_model em;
+
+        energy_default(&em);
+        day_uas = total_uas(&r[FW_PACK]) / days;
+        led_day = led_uas(&r[FW_PACK]) / days;
+        printf("\nVorwiderstand (%s, LED-Ladung ∝ I_LED)\n", pk->name);
+        printf("  R [Ω]   I_LED [mA]   mAh/Tag   Laufzeit (mit Selbstentladung)\n");
+        for (k = 0; k < 6u; k++) {
+            double i_led = (pk->vdd - em.vdrop - em.vf) / rs[k] * 1000.0;
+            double mah_day;
+            if (i_led < 0.0) i_led = 0.0;
+            mah_day = (day_uas - led_day +
+                       (r[FW_PACK].led_ma > 0.0 ? led_day * i_led / r[FW_PACK].led_ma : 0.0))
+                      / 3.6e6;
+            printf("  %5.0f   %8.2f    %8.4f   %6.1f Jahre%s\n", rs[k], i_led, mah_day,
+                   years(pk->mah, mah_day, self_pct), rs[k] == em.r_led ? "   ← Board" : "");
+        }
+    }
+    return 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-m daily|night|stuck] [-d tage] [-n wuerfe_pro_tag]\n"
+                    "          [-s seed] [-P profil] [-k prozent_pro_jahr]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,435 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  dice_sim  ·  Firmware auf dem PC ausführen (ohne Hardware)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Übersetzt main.c bzw. main_1825.c unverändert gegen die simulierte
+ *  Registerdatei (host/xc.h) und treibt sie mit skriptbaren Tastendrücken.
+ *
+ *  Build:
+ *    gcc -O2 -D_16F84A  -Ihost -o dice_sim_84a  host/dice_sim.c host/sim.c
+ *    gcc -O2 -D_16F1825 -Ihost -o dice_sim_1825 host/dice_sim.c host/sim.c
+ *    gcc -O2 -D_16F1825 -DDICE_N=2 -Ihost -o dice_sim_1825x2 host/dice_sim.c host/sim.c
+ *    gcc -O2 -D_16F1825 -DBOARD_TOUCH=1 -Ihost -o dice_sim_touch host/dice_sim.c host/sim.c
+ *
+ *  Aufruf:
+ *    dice_sim [-t ms] [-p ms:halten_ms]... [-f hz] [-r hz] [-l hz] [-v volt]
+ *             [-c hz[:prozent[:drift]]] [-q]
+ *      -t   Simulationsdauer (Default 15000 ms)
+ *      -p   Tastendruck bei ms, gehalten für halten_ms (mehrfach)
+ *      -f   tatsächliche Oszillatorfrequenz (nur 16F84A, RC-Streuung)
+ *      -r   Referenztakt an RA4 beim Einschalten (nur 16F84A, Prüfplatz:
+ *           1000 → RC-Kalibrierung), Default offen
+ *      -l   LFINTOSC (nur 16F1825, Default 31000 Hz, streut ±15 %)
+ *      -v   Batteriespannung (nur 16F1825, Default 3.0 V): LED-Tastgrad,
+ *           unter 2.1 V Batterie-Warnung nach dem Aufwachen
+ *      -c   Touch-Fläche (nur 16F1825, BOARD_TOUCH): CPS-Frequenz im
+ *           Bereich „hoch“ (Default 600000 Hz), Absenkung bei Berührung
+ *           in % (Default 20), Drift in Hz/s (Feuchte, Temperatur)
+ *      -q   keine Frame-Liste, nur Zusammenfassung
+ *    dice_sim -b
+ *      Abschnitte messen: Einschalt-Animation, 2 s Leerlauf, VDD-Messung
+ *      (16F1825), Druck → erster Frame, Roll-Frames, Blinken, je ein
+ *      Wurf in den Profilen kurz und sofort (Druck → Ergebnis, Rest),
+ *      Auto-Sleep-Timeout und enter_sleep (BOARD_TOUCH: 10 s Scans im
+ *      SLEEP, dazu Latenz Ø/max über 32 Berührungen, wach und aus dem
+ *      Auto-Sleep); je Abschnitt Wakes/s
+ *      (SLEEP-Befehle), Interrupts/s, Ø/max Tcy je Interrupt und je
+ *      wait_next() ohne ISR (Modell: SFR-Zugriffe; befehlsgenau mit
+ *      pic_iss); dazu die Größe der Animationstabellen
+ *
+ *  Ausgabe je Frame:  Start [ms]  Dauer [ms]  LED-Muster  Würfelbild  Duty
+ *  DICE_N > 1: Frames je Würfel, Spalte Wk (Duty = Anteil an der Zeit)
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (static-Funktionen direkt aufrufbar) ─────────
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u        // 4,7 kΩ + 100 pF
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u             // folgt OSCCON
+#endif
+#undef main
+
+static int      quiet;
+
+// ─── Frame-Ausgabe ────────────────────────────────────────────────────
+// Die Simulation meldet jede Pin-Änderung. Für die Liste werden daraus
+// sichtbare Frames: PWM-Lücken < GAP_NS gehören zum Frame (→ Duty),
+// Zwischenzustände < GLITCH_NS (LATC vor LATA5 geschrieben) entfallen.
+// Multiplex: je Würfel getrennt; solange ein anderer Würfel gewählt ist,
+// ist dieser dunkel (Lücke, zählt zur Dunkelzeit seit dark_t).
+#define GAP_NS     6000000ull
+#define GLITCH_NS    20000ull
+
+static uint8_t  pin_leds, pin_die;
+static uint64_t pin_t;
+static uint8_t  vis[DICE_N];
+static uint64_t vis_t0[DICE_N], vis_on[DICE_N], dark_t[DICE_N];
+
+static void print_frame(uint8_t d, uint64_t t_end) {
+    static const char bit[] = "abcdefg";
+    char     art[8];
+    uint64_t dur = t_end - vis_t0[d];
+    int      k;
+
+    if (quiet || !dur) return;
+    for (k = 0; k < 7; k++) art[k] = (vis[d] & (1u << k)) ? bit[k] : '.';
+    art[7] = '\0';
+    printf("%10.3f  %8.3f  0x%02X  %s  %3.0f%%", vis_t0[d] / 1e6, dur / 1e6,
+           vis[d], art, vis[d] ? 100.0 * vis_on[d] / dur : 0.0);
+    if (DICE_N > 1u) printf("  W%u", (unsigned)d);
+    putchar('\n');
+}
+
+static void new_frame(uint8_t d, uint8_t leds, uint64_t t_ns) {
+    print_frame(d, t_ns);
+    vis[d] = leds; vis_t0[d] = t_ns; vis_on[d] = 0;
+}
+
+// Pin-Abschnitt [pin_t, t_ns) den laufenden Frames zuordnen
+static void close_segment(uint64_t t_ns) {
+    uint64_t dur = t_ns - pin_t;
+    uint8_t  d, leds;
+
+    for (d = 0; d < DICE_N; d++) {
+        leds = d == pin_die ? pin_leds : 0u;
+        if (leds) {
+            if (leds != vis[d] && dur >= GLITCH_NS) new_frame(d, leds, pin_t);
+            if (leds == vis[d]) vis_on[d] += dur;
+            dark_t[d] = t_ns;
+        } else if (vis[d] && t_ns - dark_t[d] >= GAP_NS) {
+            new_frame(d, 0, dark_t[d]);
+        }
+    }
+}
+
+static void on_frame(uint64_t t_ns, uint8_t leds) {
+    close_segment(t_ns);
+    pin_leds = leds;
+    pin_die  = sim.die;
+    pin_t    = t_ns;
+}
+
+static void flush_frames(void) {
+    uint8_t d;
+
+    close_segment(sim.now_ns);
+    for (d = 0; d < DICE_N; d++) print_frame(d, sim.now_ns);
+}
+
+static void summary(void) {
+    printf("# %s  Fosc=%u Hz  t=%.3f ms  Zyklen=%llu  aktiv=%.3f ms  sleep=%.3f ms\n",
+           FW_NAME, sim.fosc_hz, sim.now_ns / 1e6,
+           (unsigned long long)sim.cycles,
+           sim.active_ns / 1e6, sim.sleep_ns / 1e6);
+    printf("# Frames=%llu  ISR=%llu  SLEEP=%llu  EEPROM-Bytes=%llu\n",
+           (unsigned long long)sim.frames,
+           (unsigned long long)sim.isr_calls,
+           (unsigned long long)sim.sleeps,
+           (unsigned long long)sim.ee_writes);
+    if (DICE_N > 1u)
+        printf("# Multiplex: %u Würfel, Überlappungen=%llu\n",
+               (unsigned)DICE_N, (unsigned long long)sim.mux_overlap);
+}
+
+// ─── Einzelfunktionen messen ──────────────────────────────────────────
+// Die Hauptschleife blockiert nicht mehr; gemessen wird der Weg durch
+// die Zustände: step()/wait_next() laufen, bis bench_until erreicht ist.
+static uint8_t bench_until;
+
+// Kosten je wait_next() ohne ISR: Termin rechnen, Timer1 laden, SLEEP,
+// verschlafene Zeit nachtragen (16F84A: Warten auf den Tick)
+static uint64_t wait_n, wait_cyc, wait_max;
+
+static void bench_wait(void) {
+    uint64_t c = sim.cycles - sim.isr_cycles;
+
+    wait_next();
+    c = sim.cycles - sim.isr_cycles - c;
+    wait_n++;
+    wait_cyc += c;
+    if (c > wait_max) wait_max = c;
+}
+
+static void call_loop(void) {
+    for (;;) {
+        step();
+        if (state == bench_until) return;
+        bench_wait();
+    }
+}
+#if BOARD_SLEEP
+static void call_sleep(void)   { enter_sleep(); }
+#endif
+
+static void call_startup(void) { startup_seq(); bench_until = ST_IDLE; call_loop(); }
+#if defined(_16F1825)
+static void call_vdd(void)     { vdd_check(); }
+#endif
+
+// Leerlauf: LEDs aus, nur der Auto-Sleep-Timeout steht an; endet nie
+// von selbst, bench() bricht nach IDLE_MS ab (mitten im Warten)
+#define IDLE_MS  2000u
+
+static void call_idle(void) {
+    for (;;) {
+        step();
+        bench_wait();
+    }
+}
+
+// Nach Abbruch in wait_next(): GIE = 0 und (16F1825) TMR1IE = 1 zurück
+static void after_abort(void) {
+    sim.reg[SIM_INTCON] |= 0x80u;
+#if defined(_16F1825)
+    sim.reg[SIM_PIE1] &= (uint8_t)~0x01u;   // ISR kennt TMR1IF nicht
+#endif
+}
+
+// ISR-Kosten je Abschnitt: Wakes (SLEEP) und Interrupts je Sekunde
+// (Wachzeit und Sleep), Tcy je Interrupt inkl. Sprung/RETFIE (ø/max)
+// und Tcy je wait_next() ohne ISR (ø/max)
+static void bench(const char *name, void (*fn)(void)) {
+    uint64_t t0 = sim.now_ns, c0 = sim.cycles, f0 = sim.frames;
+    uint64_t i0 = sim.isr_calls, ic0 = sim.isr_cycles, s0 = sim.sleeps;
+    int      hung;
+    uint64_t n, dt;
+
+    sim.isr_max = 0;
+    wait_n = wait_cyc = wait_max = 0;
+    if (fn == call_idle) {
+        sim_run(fn, sim.now_ns + SIM_MS(IDLE_MS));
+        after_abort();
+        hung = 0;
+    } else {
+        hung = sim_run(fn, sim.now_ns + SIM_MS(60000));
+    }
+    n  = sim.isr_calls - i0;
+    dt = sim.now_ns - t0;
+    printf("%-16s %10.3f ms  %10llu Tcy  %4llu Frames  %6.1f Wake/s  %6.0f IRQ/s  %5.1f/%3llu Tcy"
+           "  %5.1f/%3llu Tcy je Warten%s\n",
+           name, dt / 1e6,
+           (unsigned long long)(sim.cycles - c0),
+           (unsigned long long)(sim.frames - f0),
+           dt ? (sim.sleeps - s0) * 1e9 / dt : 0.0,
+           dt ? n * 1e9 / dt : 0.0,
+           n ? (double)(sim.isr_cycles - ic0) / n : 0.0,
+           (unsigned long long)sim.isr_max,
+           wait_n ? (double)wait_cyc / wait_n : 0.0,
+           (unsigned long long)wait_max,
+           hung ? "  HÄNGT (>60 s)" : "");
+}
+
+#if BOARD_TOUCH
+// ─── Touch-Latenz ─────────────────────────────────────────────────────
+// LAT_N Berührungen, jede um einen Schritt gegen das Scan-Raster
+// verschoben: wach 0,5 ms (Raster 16 Ticks ≈ 16 ms), im SLEEP 2,1 ms
+// (WDT ~64 ms). Wach bis zum ersten Roll-Frame (Profil sofort, damit
+// der Wurf kurz ist), im Auto-Sleep bis enter_sleep() zurückkehrt.
+#define LAT_N  32u
+
+// Bis der Druck den Wurf startet (Profil sofort: gleich weiter zu BLINK)
+static void call_touch(void) {
+    for (;;) {
+        step();
+        if (state != ST_SHOW) return;
+        wait_next();
+    }
+}
+
+static void lat_print(const char *name, double sum, double max) {
+    printf("%-16s %10.3f ms Ø  %8.3f ms max  (%u Berührungen)\n",
+           name, sum / LAT_N, max, LAT_N);
+}
+
+static void run_touch_latency(void) {
+    double   sum = 0.0, max = 0.0, ms;
+    uint64_t t;
+    unsigned i;
+
+    state      = ST_WAKE;                // wie step() nach enter_sleep()
+    idle_since = now;
+    bench_until = ST_SHOW;
+    sim_run(call_loop, sim.now_ns + SIM_MS(60000));
+    profile = PROF_NOW;
+    for (i = 0; i < LAT_N; i++) {
+        t = sim.now_ns + SIM_MS(200) + i * 523000ull;
+        sim_press(t, SIM_MS(60));
+        sim_run(call_touch, t + SIM_MS(1000));
+        ms   = (sim.now_ns - t) / 1e6;
+        sum += ms;
+        if (ms > max) max = ms;
+        bench_until = ST_SHOW;
+        sim_run(call_loop, sim.now_ns + SIM_MS(1000));
+    }
+    profile = PROF_FULL;
+    lat_print("Touch wach", sum, max);
+
+    sum = max = 0.0;
+    for (i = 0; i < LAT_N; i++) {
+        bench_until = ST_SLEEP;
+        sim_run(call_loop, sim.now_ns + SIM_MS(60000));
+        t = sim.now_ns + SIM_MS(500) + i * 2100000ull;
+        sim_press(t, SIM_MS(150));
+        sim_run(call_sleep, t + SIM_MS(1000));
+        ms   = (sim.now_ns - t) / 1e6;
+        sum += ms;
+        if (ms > max) max = ms;
+        state      = ST_WAKE;
+        idle_since = now;
+    }
+    lat_print("Touch Sleep", sum, max);
+}
+#endif
+
+#if BOARD_PROFILES
+// Je Profil außer PROF_FULL (= Druck→1. Frame … Blinken)
+static const char *const BENCH_PROF[PROF_N][2] = {
+    [PROF_FULL]  = { "", "" },
+#if !BOARD_PROF_LITE
+    [PROF_SHORT] = { "kurz →Ergebnis", "kurz Rest" },
+#endif
+    [PROF_NOW]   = { "sofort →Ergebnis", "sofort Rest" }
+};
+#endif
+
+static void run_bench(void) {
+#if BOARD_PROFILES
+    uint8_t p;
+#endif
+
+    // Initialisierung + Startup einmal durch main() laufen lassen
+    sim_run(fw_main, SIM_MS(3000));
+    after_abort();
+    printf("# %s  Fosc=%u Hz  Würfel=%u\n", FW_NAME, sim.fosc_hz, (unsigned)DICE_N);
+
+    bench("Einschalten", call_startup);
+    bench("Leerlauf 2 s", call_idle);
+#if defined(_16F1825)
+    bench("VDD messen", call_vdd);
+#endif
+    sim_press(sim.now_ns, SIM_MS(120));
+    bench_until = ST_ROLLING;
+    bench("Druck→1. Frame", call_loop);
+    bench_until = ST_BLINK;
+    bench("Roll-Frames", call_loop);
+    bench_until = ST_SHOW;
+    bench("Blinken", call_loop);
+#if BOARD_PROFILES
+    for (p = PROF_FULL + 1u; p < PROF_N; p++) {
+        profile = p;
+        sim_press(sim.now_ns, SIM_MS(120));
+        bench_until = ST_BLINK;
+        bench(BENCH_PROF[p][0], call_loop);
+        bench_until = ST_SHOW;
+        bench(BENCH_PROF[p][1], call_loop);
+    }
+    profile = PROF_FULL;
+#endif
+#if BOARD_SLEEP
+    bench_until = ST_SLEEP;
+    bench("bis Auto-Sleep", call_loop);
+#if BOARD_TOUCH
+    sim_press(sim.now_ns + SIM_MS(10000), SIM_MS(100));   // 10 s Scans im SLEEP
+    bench("enter_sleep", call_sleep);
+    run_touch_latency();
+#else
+    sim_press(sim.now_ns + SIM_MS(1000), SIM_MS(100));
+    bench("enter_sleep", call_sleep);
+#endif
+#endif
+    // Flash der Animationen: 1 Byte = 1 RETLW-Wort
+#if BOARD_PROFILES && BOARD_PROF_LITE
+    printf("# Tabellen: ANIM_ROLL %u + _NOW %u + ANIM_STARTUP %u + ANIM_DUR %u = %u Flash-Wörter\n",
+           (unsigned)sizeof ANIM_ROLL, (unsigned)sizeof ANIM_ROLL_NOW,
+           (unsigned)sizeof ANIM_STARTUP, (unsigned)sizeof ANIM_DUR,
+           (unsigned)(sizeof ANIM_ROLL + sizeof ANIM_ROLL_NOW + sizeof ANIM_STARTUP + sizeof ANIM_DUR));
+#elif BOARD_PROFILES
+    printf("# Tabellen: ANIM_ROLL %u + _SHORT %u + _NOW %u + ANIM_PROFILE %u + ANIM_STARTUP %u"
+           " + ANIM_DUR %u = %u Flash-Wörter\n",
+           (unsigned)sizeof ANIM_ROLL, (unsigned)sizeof ANIM_ROLL_SHORT,
+           (unsigned)sizeof ANIM_ROLL_NOW, (unsigned)sizeof ANIM_PROFILE,
+           (unsigned)sizeof ANIM_STARTUP, (unsigned)sizeof ANIM_DUR,
+           (unsigned)(sizeof ANIM_ROLL + sizeof ANIM_ROLL_SHORT + sizeof ANIM_ROLL_NOW +
+                      sizeof ANIM_PROFILE + sizeof ANIM_STARTUP + sizeof ANIM_DUR));
+#else
+    printf("# Tabellen: ANIM_ROLL %u + ANIM_STARTUP %u + ANIM_DUR %u = %u Flash-Wörter\n",
+           (unsigned)sizeof ANIM_ROLL, (unsigned)sizeof ANIM_STARTUP, (unsigned)sizeof ANIM_DUR,
+           (unsigned)(sizeof ANIM_ROLL + sizeof ANIM_STARTUP + sizeof ANIM_DUR));
+#endif
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    uint64_t t_end = SIM_MS(15000);
+    uint32_t fosc  = FW_FOSC;
+    int      bench_mode = 0;
+    int      i;
+
+    for (i = 1; i < argc; i++)          // Takt zuerst: sim_reset() löscht das Skript
+        if (!strcmp(argv[i], "-f") && i + 1 < argc)
+            fosc = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    sim_reset(fosc);
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            t_end = SIM_MS(strtoull(argv[++i], NULL, 10));
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            unsigned long at, hold;
+            if (sscanf(argv[++i], "%lu:%lu", &at, &hold) != 2) goto usage;
+            sim_press(SIM_MS(at), SIM_MS(hold));
+        } else if (!strcmp(argv[i], "-f") && i + 1 < argc) {
+            i++;
+#if defined(_16F84A)
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            sim.ref_hz = (uint32_t)strtoul(argv[++i], NULL, 10);
+#else
+        } else if (!strcmp(argv[i], "-l") && i + 1 < argc) {
+            sim.lfintosc_hz = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-v") && i + 1 < argc) {
+            sim.vdd_mv = (uint16_t)(atof(argv[++i]) * 1000.0 + 0.5);
+        } else if (!strcmp(argv[i], "-c") && i + 1 < argc) {
+            unsigned long hz, pct = sim.cps_touch_pct;
+            double        drift = 0.0;
+            if (sscanf(argv[++i], "%lu:%lu:%lf", &hz, &pct, &drift) < 1 || pct > 100u)
+                goto usage;
+            sim.cps_hz        = (uint32_t)hz;
+            sim.cps_touch_pct = (uint8_t)pct;
+            sim.cps_drift     = drift;
+#endif
+        } else if (!strcmp(argv[i], "-q")) {
+            quiet = 1;
+        } else if (!strcmp(argv[i], "-b")) {
+            bench_mode = 1;
+        } else {
+            goto usage;
+        }
+    }
+    sim_attach_isr(isr);
+    sim.on_frame = on_frame;
+
+    if (bench_mode) {
+        quiet = 1;
+        run_bench();
+        return 0;
+    }
+    sim_run(fw_main, t_end);
+    flush_frames();
+    summary();
+    return 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-t ms] [-p ms:halten_ms]... [-f hz] [-r hz] [-l hz] [-v volt]\n"
+                    "          [-c hz[:prozent[:drift]]] [-q] | -b\n", argv[0]);
+    return 2;
+}
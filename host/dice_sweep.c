@@ -0,0 +1,604 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  dice_sweep  ·  Tausende Tastendruck-Szenarien parallel durchspielen
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Übersetzt main.c bzw. main_1825.c unverändert gegen die simulierte
+ *  Registerdatei (wie dice_sim) und spielt n zufällige Szenarien durch.
+ *  Szenario i hängt nur von Seed und i ab → einzeln wiederholbar (-i).
+ *
+ *  Klassen (i mod 3):
+ *    Druck        aus dem Leerlauf (LEDs aus): ein Druck 20 ms … 2 s,
+ *                 Phase 0 … 60 ms gegen den Tick
+ *    Druck im Wurf  kurzer Druck, ein zweiter mitten in der Roll-
+ *                 Animation (Profil sofort: erst nach dem Ergebnis)
+ *    Einschlafen  Druck 0 … 250 ms nach dem Auto-Sleep-Entscheid: trifft
+ *                 enter_sleep() beim EEPROM-Schreiben oder im SLEEP; in
+ *                 jedem zweiten Szenario danach ein Druck zum Würfeln
+ *  Jeder Druck prellt zufällig: 0 … 6 Gegenflanken beim Drücken und beim
+ *  Loslassen, 50 … 1500 µs Abstand (nicht mit BOARD_TOUCH).
+ *
+ *  Ablauf: -j Worker (fork, Default alle Kerne) schalten die Firmware je
+ *  einmal ein, bis sie im Leerlauf wartet; jedes Szenario läuft in einem
+ *  eigenen Kind dieses Standes (fork, wie btn_test) — frischer Zustand
+ *  von Firmware, sim und libc ohne erneute Einschalt-Animation, der
+ *  Worker selbst bleibt stehen. Danach dasselbe ab ST_SLEEP für die
+ *  Klasse Einschlafen. Zeitraffer wie dice_life (sim.warp).
+ *
+ *  Gemessen:
+ *    Druck → 1. Frame    erste Flanke → erstes Muster ≠ aus
+ *    Wake → Anzeige      erste Flanke im Auto-Sleep → letzte Zahl sichtbar
+ *    Augenzahl           Endergebnis je Szenario und Würfel, χ² (5 FG)
+ *  Fehler (Exit-Code 1):
+ *    Hänger              SETTLE_MS nach dem letzten Loslassen nicht zurück
+ *                        in ST_SHOW/ST_IDLE mit ruhigem Taster, oder das
+ *                        Szenario braucht > HOST_S s Rechenzeit (Schleife
+ *                        ohne SFR-Zugriff, z. B. auf eine RAM-Variable).
+ *                        Hängt schon der Wurf, an dem jeder Worker die
+ *                        Wurfdauer misst, bricht der ganze Lauf ab
+ *    Druck verloren / doppelt   EV_PRESS ≠ Anzahl der Drücke
+ *    Würfe               falsche Anzahl Ergebnisse (Weck-Druck würfelt,
+ *                        Druck im Wurf würfelt zweimal …)
+ *    kein Frame          LEDs bleiben nach dem Druck dunkel
+ *    zu spät             Druck → 1. Frame > -L ms (50), z. B. eine Schleife,
+ *                        die aufs Loslassen wartet (Druck, Druck im Wurf)
+ *
+ *  Build:
+ *    gcc -O2 -D_16F84A  -Ihost -o dice_sweep_84a  host/dice_sweep.c host/sim.c -lm
+ *    gcc -O2 -D_16F1825 -Ihost -o dice_sweep_1825 host/dice_sweep.c host/sim.c -lm
+ *
+ *  Aufruf:
+ *    dice_sweep [-n szenarien] [-s seed] [-j worker] [-P profil] [-L ms]
+ *    dice_sweep -i nr [-s seed] [-P profil]    ein Szenario mit Zeitleiste
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (static-Funktionen direkt aufrufbar) ─────────
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u        // 4,7 kΩ + 100 pF
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u             // folgt OSCCON
+#endif
+#undef main
+#if !BOARD_PROFILES
+static uint8_t profile;         // Firmware ohne Roll-Profile: immer PROF_FULL
+#endif
+
+#define BOOT_MS    3000u        // Einschalt-Animation vorbei, Leerlauf
+#define SETTLE_MS  2000u        // nach Loslassen + Wurfdauer zur Ruhe
+#define HOST_S     1u           // Rechenzeit je Szenario (sonst ~10 ms), dann Abbruch
+#define BOUNCE_MAX 6u           // Gegenflanken je Flanke
+#define BTN_REL_MS 50u          // > BTN_REL: Loslassen ist gemeldet
+#define FRAME_MS   20u          // > PWM-Periode: gesetzte Seite ist sichtbar
+
+#if BOARD_TOUCH
+#define HOLD_MIN_MS  120u       // Scan-Raster (wach ~16 ms, Auto-Sleep ~64 ms)
+#else
+#define HOLD_MIN_MS  20u
+#endif
+
+// ─── Szenario-Klassen und Fehler ──────────────────────────────────────
+enum cls { C_PRESS, C_DOUBLE, C_SLEEP, C_N };
+static const char *const C_NAME[C_N] = { "Druck", "Druck im Wurf", "Einschlafen" };
+
+enum err { E_OK, E_HANG, E_HOST, E_PRESS, E_ROLLS, E_FRAME, E_SLOW, E_N };
+static const char *const E_NAME[E_N] = {
+    "ok", "Hänger", "Rechenzeit", "Druck ±", "Würfe", "kein Frame", "zu spät"
+};
+
+// Ergebnis eines Szenarios
+struct rec {
+    uint32_t i;
+    uint8_t  cls, err, rolls;
+    uint8_t  face[DICE_N];      // Endergebnis (0 … 5), nur mit rolls > 0
+    uint32_t lat_us;            // Druck → 1. Frame bzw. Wake → Anzeige
+};
+
+// ─── Host-Zufall (splitmix64, wie rng_test) ───────────────────────────
+static uint64_t host_s;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (host_s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint64_t host_range(uint64_t lo, uint64_t hi) {
+    return lo + splitmix64() % (hi - lo + 1u);
+}
+
+// ─── Tastendruck mit Prellen ──────────────────────────────────────────
+// Flanken streng nach Zeit (die Simulation arbeitet sie der Reihe nach ab)
+static uint8_t  verbose;          // -i: Zeitleiste
+static unsigned n_press;
+static uint64_t t_first, t_last;    // erste Flanke, letztes Loslassen
+
+static uint64_t bouncy(uint64_t t, uint8_t pressed) {
+    unsigned k, n = BOARD_TOUCH ? 0u : (unsigned)host_range(0u, BOUNCE_MAX);
+    uint64_t t0 = t;
+
+    sim_button(t, pressed);
+    for (k = 0; k < n; k++) {
+        t += host_range(50000u, 1500000u);
+        sim_button(t, !pressed);
+        t += host_range(50000u, 1500000u);
+        sim_button(t, pressed);
+    }
+    if (verbose) printf("# Taster %s  %.3f ms, %u× Prellen bis %.3f ms\n",
+                        pressed ? "gedrückt " : "los      ", t0 / 1e6, n, t / 1e6);
+    return t;
+}
+
+static void press(uint64_t t, uint64_t hold) {
+    uint64_t end = bouncy(t, 1u);
+
+    if (end + SIM_MS(5) > t + hold) hold = end + SIM_MS(5) - t;   // Prellen < Druck
+    t_last = bouncy(t + hold, 0u);
+    if (!n_press++) t_first = t;
+}
+
+// ─── Ablauf im Szenario: step()/wait_next() mit Beobachtung ──────────
+static uint8_t  st_prev, rolls0, presses_seen;
+static uint64_t t_frame, t_done;
+static uint32_t roll_ms, done_ms;   // ST_ROLLING, Druck → Ergebnis (je Worker gemessen)
+static uint32_t max_lat_ms = 50u;   // -L: Druck → 1. Frame
+
+static void on_frame(uint64_t t_ns, uint8_t leds) {
+    if (verbose) printf("%10.3f ms  LEDs 0x%02X\n", t_ns / 1e6, leds);
+    if (leds && n_press && t_ns >= t_first && !t_frame) t_frame = t_ns;
+}
+
+// Würfe zählt finish_roll() im EEPROM-Abbild mit (auch Profil sofort,
+// das ST_ROLLING im selben step() wieder verlässt)
+static uint8_t rolls(void) {
+    return (uint8_t)(ee_rec[EE_ROLLS0] - rolls0);
+}
+
+static void observe(void) {
+    if (state == st_prev) return;
+    if (verbose) printf("%10.3f ms  Zustand %u → %u\n", sim.now_ns / 1e6,
+                        (unsigned)st_prev, (unsigned)state);
+    st_prev = state;
+}
+
+static void call_loop(void) {
+    uint64_t t_calm = 0;            // seit wann alles ruhig ist
+
+    for (;;) {
+        if (btn_events & EV_PRESS) presses_seen++;    // step() löscht es gleich
+        step();
+        observe();
+        if (sim.now_ns >= t_done && (state == ST_SHOW || state == ST_IDLE) &&
+            !btn_busy && !btn_events) {
+            if (!t_calm) t_calm = sim.now_ns;
+            if (t_frame || sim.now_ns >= t_calm + SIM_MS(FRAME_MS)) return;
+        } else {
+            t_calm = 0;
+        }
+        wait_next();
+    }
+}
+
+// Bis zum Auto-Sleep-Entscheid (step() setzt ST_SLEEP, enter_sleep folgt)
+static void call_to_sleep(void) {
+    for (;;) {
+        step();
+        if (state == ST_SLEEP) return;
+        wait_next();
+    }
+}
+
+// Stand 2 für C_SLEEP: erst ein Wurf (neue Daten → enter_sleep() schreibt
+// das EEPROM), dann bis zum Auto-Sleep-Entscheid
+static int to_sleep(void) {
+    sim_press(sim.now_ns + SIM_MS(10), SIM_MS(60));
+    return sim_run(call_to_sleep, sim.now_ns + SIM_MS(60000));
+}
+
+// Nach Abbruch in wait_next(): GIE = 0 und (16F1825) TMR1IE = 1 zurück
+static void after_abort(void) {
+    sim.reg[SIM_INTCON] |= 0x80u;
+#if defined(_16F1825)
+    sim.reg[SIM_PIE1] &= (uint8_t)~0x01u;   // ISR kennt TMR1IF nicht
+#endif
+}
+
+// ─── Ein Szenario (ab dem Stand des Workers) ─────────────────────────
+static struct rec scenario(uint32_t i, uint64_t seed) {
+    struct rec r;
+    uint64_t   t0 = sim.now_ns, t;
+    uint8_t    want, k;
+
+    memset(&r, 0, sizeof r);
+    r.i   = i;
+    r.cls = (uint8_t)(i % C_N);
+    host_s = seed ^ ((uint64_t)i * 0xD1B54A32D192ED03ull);
+    st_prev = state;
+    rolls0  = ee_rec[EE_ROLLS0];
+
+    switch (r.cls) {
+    case C_PRESS:
+        t = t0 + host_range(0u, SIM_MS(60));
+        press(t, host_range(0u, 4u) ? host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(300))
+                                    : host_range(SIM_MS(300), SIM_MS(2000)));
+        want = 1;
+        break;
+    case C_DOUBLE:
+        t = t0 + host_range(0u, SIM_MS(60));
+        press(t, host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(HOLD_MIN_MS + 80u)));
+        if (roll_ms > 2u * HOLD_MIN_MS + 300u) {       // mitten in ST_ROLLING
+            press(t_last + SIM_MS(50) +
+                  host_range(0u, SIM_MS(roll_ms - 2u * HOLD_MIN_MS - 250u)),
+                  host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(HOLD_MIN_MS + 80u)));
+            want = 1;                                  // Neustart, ein Ergebnis
+        } else {                                       // Profil sofort: danach
+            press(t_last + SIM_MS(roll_ms + 200u) + host_range(0u, SIM_MS(500)),
+                  host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(300)));
+            want = 2;
+        }
+        break;
+    default:                                           // C_SLEEP
+        t = t0 + host_range(0u, SIM_MS(250));
+        press(t, host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(300)));
+        want = 0;                                      // Weck-Druck würfelt nicht
+        if (splitmix64() & 1u) {
+            press(t_last + host_range(SIM_MS(300), SIM_MS(1500)),
+                  host_range(SIM_MS(HOLD_MIN_MS), SIM_MS(300)));
+            want = 1;
+        }
+        break;
+    }
+    t_done = t_last + SIM_MS(BTN_REL_MS);               // Loslassen entprellt
+    if (sim_run(call_loop, t_last + SIM_MS(done_ms + SETTLE_MS))) {
+        r.err = E_HANG;
+    } else if (presses_seen != n_press) {
+        r.err = E_PRESS;
+    } else if (rolls() != want) {
+        r.err = E_ROLLS;
+    } else if (!t_frame) {
+        r.err = E_FRAME;
+    } else if (r.cls != C_SLEEP && t_frame - t_first > SIM_MS(max_lat_ms)) {
+        r.err = E_SLOW;                                  // z. B. Warten aufs Loslassen
+    }
+    r.rolls = rolls();
+    for (k = 0; k < DICE_N; k++) r.face[k] = last_result[k];
+    if (t_frame) r.lat_us = (uint32_t)((t_frame - t_first) / 1000u);
+    if (verbose)
+        printf("# Szenario %u (%s): %u Drücke, %u erkannt, %u Würfe (soll %u), "
+               "Latenz %.3f ms, Augen %u  → %s\n",
+               i, C_NAME[r.cls], n_press, presses_seen, r.rolls, want,
+               r.lat_us / 1e3, last_result[0] + 1u, E_NAME[r.err]);
+    return r;
+}
+
+// Schleife ohne SFR-Zugriff lässt die simulierte Zeit stehen → das
+// Zeitlimit von sim_run() greift nie; SIGVTALRM beendet dann das Kind
+static void cpu_limit(time_t s) {
+    struct itimerval it = { { 0, 0 }, { s, 0 } };
+    setitimer(ITIMER_VIRTUAL, &it, NULL);
+}
+
+// ─── Ein Szenario im Kind (Stand des Aufrufers bleibt unverändert) ───
+static struct rec run_scenario(uint32_t i, uint64_t seed, int fd[2]) {
+    struct rec r;
+    pid_t      pid;
+    int        st;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        cpu_limit(HOST_S);
+        r = scenario(i, seed);
+        fflush(stdout);
+        if (write(fd[1], &r, sizeof r) != (ssize_t)sizeof r) _exit(1);
+        _exit(0);
+    }
+    if (pid > 0 && waitpid(pid, &st, 0) == pid && WIFEXITED(st) && !WEXITSTATUS(st) &&
+        read(fd[0], &r, sizeof r) == (ssize_t)sizeof r)
+        return r;
+    memset(&r, 0, sizeof r);                 // Kind nach HOST_S abgebrochen
+    r.i   = i;
+    r.cls = (uint8_t)(i % C_N);
+    r.err = E_HOST;
+    return r;
+}
+
+// Wurfdauer im aktuellen Profil, einmal je Worker (in einem Kind):
+// ST_ROLLING und Druck → Ergebnis
+static uint64_t t_roll, t_show;
+
+static void call_roll(void) {
+    rolls0 = ee_rec[EE_ROLLS0];
+    for (;;) {
+        uint8_t ev = btn_events & EV_PRESS;
+        step();
+        if (ev && !t_roll) t_roll = sim.now_ns;                  // start_roll()
+        if (state != ST_ROLLING && t_roll && !t_show) t_show = sim.now_ns;
+        if (rolls()) return;                                     // finish_roll()
+        wait_next();
+    }
+}
+
+static int measure_roll(int fd) {
+    uint64_t t = sim.now_ns + SIM_MS(10);
+    uint32_t ms[2] = { 0, 0 };
+    pid_t    pid;
+    int      st;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        cpu_limit(HOST_S);
+        sim_press(t, SIM_MS(60));
+        if (!sim_run(call_roll, t + SIM_MS(30000)) && t_show) {
+            ms[0] = (uint32_t)((t_show - t_roll) / 1000000u);
+            ms[1] = (uint32_t)((sim.now_ns - t) / 1000000u) + 1u;
+        }
+        if (write(fd, ms, sizeof ms) != (ssize_t)sizeof ms) _exit(1);
+        _exit(0);
+    }
+    return pid < 0 || waitpid(pid, &st, 0) < 0 || !WIFEXITED(st) || WEXITSTATUS(st) ? -1 : 0;
+}
+
+static int roll_time(int fd[2]) {
+    uint32_t ms[2];
+
+    if (measure_roll(fd[1]) ||
+        read(fd[0], ms, sizeof ms) != (ssize_t)sizeof ms || !ms[1]) {
+        fprintf(stderr, "Wurfdauer nicht messbar: erster Wurf hängt\n");
+        return -1;
+    }
+    roll_ms = ms[0];
+    done_ms = ms[1];
+    return 0;
+}
+
+// ─── Worker: Stand nach boot() bzw. to_sleep() + seine Szenarien ─────
+struct sum {
+    uint64_t n[C_N], err[C_N][E_N], rolls, face[6];
+    uint32_t n_lat[2];          // 0: Druck → 1. Frame, 1: Wake → Anzeige
+    uint32_t fail_i[8], n_fail;
+    uint32_t roll_ms;
+};
+
+static void boot(void) {
+    sim_reset(FW_FOSC);
+    sim_attach_isr(isr);
+    sim.on_frame = on_frame;
+    sim.warp     = 1;
+    sim_run(fw_main, SIM_MS(BOOT_MS));
+    after_abort();
+}
+
+static void add(struct sum *s, uint32_t *lat[2], const struct rec *r) {
+    uint8_t k;
+
+    s->n[r->cls]++;
+    s->err[r->cls][r->err]++;
+    if (r->err != E_OK) {
+        if (s->n_fail < 8u) s->fail_i[s->n_fail] = r->i;
+        s->n_fail++;
+        return;
+    }
+    if (r->rolls) {
+        s->rolls++;
+        for (k = 0; k < DICE_N; k++) s->face[r->face[k] % 6u]++;
+    }
+    k = r->cls == C_SLEEP;
+    lat[k][s->n_lat[k]++] = r->lat_us;
+}
+
+static void worker(unsigned w, unsigned nw, uint32_t n, uint64_t seed, int out) {
+    struct sum s;
+    uint32_t  *lat[2], i;
+    int        fd[2];
+    unsigned   pass;
+
+    memset(&s, 0, sizeof s);
+    lat[0] = malloc((n / nw + 1u) * sizeof *lat[0]);
+    lat[1] = malloc((n / nw + 1u) * sizeof *lat[1]);
+    if (!lat[0] || !lat[1] || pipe(fd)) _exit(1);
+
+    boot();
+    if (roll_time(fd)) _exit(1);
+    s.roll_ms = roll_ms;
+    for (pass = 0; pass < 2u; pass++) {
+        if (pass && to_sleep()) _exit(1);
+        for (i = w; i < n; i += nw) {
+            struct rec r;
+            if ((i % C_N == C_SLEEP) != pass) continue;
+            r = run_scenario(i, seed, fd);
+            add(&s, lat, &r);
+        }
+    }
+    if (write(out, &s, sizeof s) != (ssize_t)sizeof s ||
+        write(out, lat[0], s.n_lat[0] * sizeof *lat[0]) != (ssize_t)(s.n_lat[0] * sizeof *lat[0]) ||
+        write(out, lat[1], s.n_lat[1] * sizeof *lat[1]) != (ssize_t)(s.n_lat[1] * sizeof *lat[1]))
+        _exit(1);
+    _exit(0);
+}
+
+// ─── Auswertung ───────────────────────────────────────────────────────
+static int read_all(int fd, void *p, size_t n) {
+    uint8_t *b = p;
+    while (n) {
+        ssize_t k = read(fd, b, n);
+        if (k <= 0) return -1;
+        b += k;
+        n -= (size_t)k;
+    }
+    return 0;
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void percentiles(const char *name, uint32_t *v, uint32_t n) {
+    static const double P[] = { 0.50, 0.90, 0.99, 0.999 };
+    unsigned k;
+
+    printf("%-18s", name);
+    if (!n) { printf("   –\n"); return; }
+    qsort(v, n, sizeof *v, cmp_u32);
+    for (k = 0; k < 4u; k++)
+        printf("  p%-5g %7.3f", P[k] * 100.0, v[(uint32_t)(P[k] * (n - 1u))] / 1e3);
+    printf("  max %8.3f ms  (n = %u)\n", v[n - 1u] / 1e3, n);
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    struct sum tot;
+    uint32_t   n = 100000u, *lat[2], one = 0;
+    uint64_t   seed = 1u, nerr = 0;
+    long       nw = sysconf(_SC_NPROCESSORS_ONLN);
+    int        single = 0, i, c, e;
+    struct timespec w0, w1;
+
+    for (i = 1; i < argc; i++) {
+        const char *a = argv[i];
+        if (i + 1 >= argc) goto usage;
+        if      (!strcmp(a, "-n")) n    = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-s")) seed = strtoull(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-j")) nw   = strtol(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-L")) max_lat_ms = (uint32_t)strtoul(argv[++i], NULL, 10);
+        else if (!strcmp(a, "-i")) { one = (uint32_t)strtoul(argv[++i], NULL, 10); single = 1; }
+        else if (!strcmp(a, "-P")) {
+            profile = (uint8_t)strtoul(argv[++i], NULL, 10);
+            if (profile >= (BOARD_PROFILES ? PROF_N : 1u)) goto usage;
+        } else goto usage;
+    }
+    if (!n || nw < 1) goto usage;
+
+    // ─── Ein Szenario mit Zeitleiste ──────────────────────────────────
+    if (single) {
+        struct rec r;
+        int        fd[2];
+
+        boot();
+        if (pipe(fd) || roll_time(fd)) return 1;
+        if (one % C_N == C_SLEEP && to_sleep()) return 1;
+        printf("# %s  Szenario %u  Seed %llu  Profil %u  Wurfdauer %u ms  Start %.3f ms\n",
+               FW_NAME, one, (unsigned long long)seed, (unsigned)profile, roll_ms,
+               sim.now_ns / 1e6);
+        verbose = 1;
+        r = run_scenario(one, seed, fd);
+        if (r.err == E_HOST) printf("# Szenario %u: > %u s Rechenzeit\n", one, HOST_S);
+        return r.err != E_OK;
+    }
+
+    // ─── Worker starten, Ergebnisse einsammeln ───────────────────────
+    {
+        int   *fd  = malloc((size_t)nw * sizeof *fd);
+        pid_t *pid = malloc((size_t)nw * sizeof *pid);
+        uint32_t w;
+
+        memset(&tot, 0, sizeof tot);
+        lat[0] = malloc(((size_t)n + 1u) * sizeof *lat[0]);
+        lat[1] = malloc(((size_t)n + 1u) * sizeof *lat[1]);
+        if (!fd || !pid || !lat[0] || !lat[1]) return 1;
+
+        clock_gettime(CLOCK_MONOTONIC, &w0);
+        for (w = 0; w < (uint32_t)nw; w++) {
+            int p[2];
+            if (pipe(p)) return 1;
+            fflush(stdout);
+            pid[w] = fork();
+            if (pid[w] < 0) return 1;
+            if (pid[w] == 0) {
+                close(p[0]);
+                worker(w, (unsigned)nw, n, seed, p[1]);
+            }
+            close(p[1]);
+            fd[w] = p[0];
+        }
+        for (w = 0; w < (uint32_t)nw; w++) {
+            struct sum s;
+            if (read_all(fd[w], &s, sizeof s) ||
+                read_all(fd[w], lat[0] + tot.n_lat[0], s.n_lat[0] * sizeof *lat[0]) ||
+                read_all(fd[w], lat[1] + tot.n_lat[1], s.n_lat[1] * sizeof *lat[1])) {
+                fprintf(stderr, "Worker %u fehlgeschlagen\n", w);
+                return 1;
+            }
+            close(fd[w]);
+            waitpid(pid[w], NULL, 0);
+            for (c = 0; c < C_N; c++) {
+                tot.n[c] += s.n[c];
+                for (e = 0; e < E_N; e++) tot.err[c][e] += s.err[c][e];
+            }
+            tot.rolls += s.rolls;
+            for (c = 0; c < 6; c++) tot.face[c] += s.face[c];
+            for (c = 0; c < 8 && (uint32_t)c < s.n_fail && tot.n_fail < 8u; c++)
+                tot.fail_i[tot.n_fail++] = s.fail_i[c];
+            tot.n_lat[0] += s.n_lat[0];
+            tot.n_lat[1] += s.n_lat[1];
+            tot.roll_ms   = s.roll_ms;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &w1);
+    }
+
+    // ─── Bericht ──────────────────────────────────────────────────────
+    printf("# %s  dice_sweep  %u Szenarien  Seed %llu  %ld Worker  Profil %u  "
+           "Wurfdauer %u ms  Würfel %u\n",
+           FW_NAME, n, (unsigned long long)seed, nw, (unsigned)profile, tot.roll_ms,
+           (unsigned)DICE_N);
+    printf("# Rechenzeit %.1f s (%.0f Szenarien/s)\n\n",
+           (w1.tv_sec - w0.tv_sec) + (w1.tv_nsec - w0.tv_nsec) / 1e9,
+           n / ((w1.tv_sec - w0.tv_sec) + (w1.tv_nsec - w0.tv_nsec) / 1e9));
+
+    printf("Klasse            Anzahl        ok    Hänger  Rechenz.   Druck ±     Würfe  kein Frame   zu spät\n");
+    for (c = 0; c < C_N; c++) {
+        printf("%-14s %9llu", C_NAME[c], (unsigned long long)tot.n[c]);
+        for (e = 0; e < E_N; e++) {
+            printf(" %9llu", (unsigned long long)tot.err[c][e]);
+            if (e) nerr += tot.err[c][e];
+        }
+        printf("\n");
+    }
+    printf("\nLatenz [ms]\n");
+    percentiles("Druck → 1. Frame", lat[0], tot.n_lat[0]);
+    percentiles("Wake → Anzeige", lat[1], tot.n_lat[1]);
+
+    {
+        uint64_t m = 0;
+        double   expect[6], x;
+        for (c = 0; c < 6; c++) m += tot.face[c];
+        printf("\nAugenzahl (%llu Ergebnisse)", (unsigned long long)m);
+        for (c = 0; c < 6; c++) {
+            expect[c] = m / 6.0;
+            printf("  %d: %.2f %%", c + 1, m ? 100.0 * tot.face[c] / m : 0.0);
+        }
+        for (x = 0.0, c = 0; c < 6; c++)
+            if (expect[c] > 0.0)
+                x += (tot.face[c] - expect[c]) * (tot.face[c] - expect[c]) / expect[c];
+        printf("\nχ² (5 FG): %.2f  %s\n", x,
+               x < 11.07 ? "ok" : x < 15.09 ? "auffällig (5 %)" : "VERZERRT (1 %)");
+    }
+    if (nerr) {
+        printf("\nFEHLER in %llu Szenarien, erste:", (unsigned long long)nerr);
+        for (c = 0; (uint32_t)c < tot.n_fail; c++) printf(" %u", tot.fail_i[c]);
+        printf("  (einzeln: %s -i nr -s %llu)\n", argv[0], (unsigned long long)seed);
+    }
+    return nerr ? 1 : 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-n szenarien] [-s seed] [-j worker] [-P profil] [-L ms]\n"
+                    "       %s -i nr [-s seed] [-P profil] [-L ms]\n", argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,378 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  ee_test  ·  EEPROM-Ring: Verschleiß-Prognose + Stromausfall beim Schreiben
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Übersetzt main.c bzw. main_1825.c unverändert gegen die Simulation
+ *  (Daten-EEPROM mit 55/AA-Folge und 4 ms je Byte, host/sim.c).
+ *
+ *  1. Verschleiß: die Firmware läuft -d Tage mit -r Würfen je Tag, in
+ *     Sitzungen zu -g Würfen (Weck-Druck, Würfe, Auto-Sleep → ein
+ *     Eintrag). Gezählt werden Schreibzyklen je EEPROM-Byte; daraus die
+ *     Lebensdauer bis -e Zyklen (Datenblatt: 100 000 min., ~1 Mio. typ.)
+ *     im Vergleich zu einem festen Speicherplatz ohne Ring. Zu Beginn
+ *     wählt ein langer Druck in der Einschalt-Animation das nächste
+ *     Profil, „kurz“ bzw. am 16F84A „sofort“ (BOARD_PROFILES; sonst
+ *     bleibt es „voll“). Danach „Batteriewechsel“: ee_load() muss
+ *     Würfe, letzte Zahl und Profil liefern.
+ *
+ *  2. Abriss: Ring mit n Einträgen füllen (leer, 1, voll, Folgenummer
+ *     läuft über), dann ee_save() alle -s µs abbrechen (Strom weg). Das
+ *     Byte im Schreibvorgang bleibt alt, wird neu, 0xFF, 0x00 oder Müll.
+ *     Nach dem Einschalten muss ee_load() exakt den alten oder den neuen
+ *     Stand liefern, und der nächste Eintrag muss wieder gewinnen.
+ *
+ *  3. RC-Kalibrierung (16F84A, BOARD_RC_CAL): je RC-Takt einschalten
+ *     ohne Referenz (leeres EEPROM → Nennwert), am Prüfplatz (1 kHz an
+ *     RA4 → gemessen und gespeichert), dann Ring mehrmals umlaufen lassen
+ *     und ohne Referenz einschalten → der gespeicherte Wert muss gelten.
+ *
+ *  16F1825 mit Ereignis-Protokoll (BOARD_TRACE): Ring im unteren Viertel,
+ *  die Lebensdauer bestimmt das meistbeschriebene Byte beider Teile.
+ *  16F84A mit RC-Kalibrierung: Ring in der unteren Hälfte (4 Plätze).
+ *
+ *  Build (16F1825 auch mit -DDICE_N=2|3: Ergebnis aller Würfel in Byte 1):
+ *    gcc -O2 -D_16F84A  -Ihost -o ee_test_84a  host/ee_test.c host/sim.c
+ *    gcc -O2 -D_16F84A -DBOARD_RC_CAL=0 -Ihost -o ee_test_84n host/ee_test.c host/sim.c
+ *    gcc -O2 -D_16F1825 -Ihost -o ee_test_1825 host/ee_test.c host/sim.c
+ *
+ *  Aufruf:
+ *    ee_test [-r würfe/tag] [-g würfe/sitzung] [-d tage] [-e zyklen] [-s µs]
+ *      Default: 100 Würfe/Tag, 1 Wurf je Sitzung (ungünstigster Fall:
+ *      jeder Wurf ein Eintrag), 4 Tage, 100 000 Zyklen, Schnitt alle 250 µs
+ *      Zyklen je Byte = meistbeschriebenes Byte / Tage (ganze Zyklen →
+ *      bei kurzer Laufzeit leicht zu hoch, also auf der sicheren Seite)
+ *
+ *  Rückgabe: 0 = alles wiederhergestellt, 1 = Fehler
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (static-Funktionen direkt aufrufbar) ─────────
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#define FW_FOSC  709000u        // 4,7 kΩ + 100 pF
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#define FW_FOSC  0u             // folgt OSCCON
+#endif
+#undef main
+#if !BOARD_PROFILES
+static uint8_t profile;         // Firmware ohne Roll-Profile: immer PROF_FULL
+#endif
+
+#define DAY_NS   (86400ull * 1000000000ull)
+
+// ─── Gespeicherter Stand aus Sicht der Firmware ──────────────────────
+struct ee_state {
+    uint8_t  result;        // gepackt wie im EEPROM (ee_pack)
+    uint16_t rng;
+    uint32_t rolls;
+    uint8_t  profile;
+};
+
+static const char *const PROF_NAME[PROF_N] = {
+    [PROF_FULL]  = "voll",
+#if !BOARD_PROF_LITE
+    [PROF_SHORT] = "kurz",
+#endif
+    [PROF_NOW]   = "sofort"
+};
+#if BOARD_PROFILES
+#define ROLLS_HI   EE_ROLLS_HI   // Würfe 22 Bit, darüber das Profil
+#define PROF_WEAR  (PROF_FULL + 1u)   // wear(): langer Druck beim Einschalten
+#else
+#define ROLLS_HI   0xFFu         // Würfe 24 Bit, Profil immer PROF_FULL
+#define PROF_WEAR  PROF_FULL
+#endif
+
+static struct ee_state fw_state(void) {
+    struct ee_state s;
+    s.result = ee_pack();
+    s.rng    = rng_s;
+    s.rolls  = ee_rec[EE_ROLLS0] | (uint32_t)ee_rec[EE_ROLLS1] << 8 |
+               (uint32_t)(ee_rec[EE_ROLLS2] & ROLLS_HI) << 16;
+    s.profile = profile;
+    return s;
+}
+
+// Gepacktes Ergebnis als Augenzahlen, Würfel 0 zuerst: "3" bzw. "3 5"
+static const char *faces(uint8_t v) {
+    static char buf[8];
+    uint8_t     d;
+
+    for (d = 0; d < DICE_N; d++, v /= 6u) {
+        buf[2 * d]     = (char)('1' + v % 6u);
+        buf[2 * d + 1] = ' ';
+    }
+    buf[2 * DICE_N - 1] = '\0';
+    return buf;
+}
+
+static int same(struct ee_state a, struct ee_state b) {
+    return a.result == b.result && a.rng == b.rng && a.rolls == b.rolls &&
+           a.profile == b.profile;
+}
+
+// Einschalten: RAM wie nach dem C-Start, EEPROM bleibt, dann ee_load()
+static struct ee_state power_on(void) {
+    sim_reset(FW_FOSC);
+    memset(last_result, 0, sizeof last_result);
+    rng_s       = RNG_SEED;
+    profile     = PROF_FULL;
+    ee_dirty    = 0;
+    memset(ee_rec, 0xEE, sizeof ee_rec);
+    ee_load();
+    return fw_state();
+}
+
+// Ein Wurf wie in der Firmware (Ergebnis, finish_roll), neuer RNG-Stand
+// und Profil
+static void roll(unsigned k) {
+    uint8_t d;
+
+    for (d = 0; d < DICE_N; d++) result[d] = (uint8_t)((k + 5u * d) % 6u);
+    finish_roll();
+#if BOARD_PROFILES
+    profile = (uint8_t)(k % PROF_N);
+#endif
+    rng_s  = (uint16_t)(k * 40503u + 1u);
+    if (!rng_s) rng_s = RNG_SEED;
+}
+
+// ─── 1. Verschleiß im Dauerbetrieb ────────────────────────────────────
+static int wear(unsigned per_day, unsigned per_session, unsigned days, double cycles) {
+    unsigned        sessions = (per_day + per_session - 1u) / per_session;
+    uint64_t        gap      = DAY_NS / sessions;
+    uint64_t        t, max = 0, min = UINT64_MAX, total = 0, ring = 0, trc = 0;
+    unsigned        d, k, j, a;
+    uint32_t        want;
+    uint8_t         want_result;
+    struct ee_state got;
+    double          per_byte, fixed;
+
+    sim_ee_erase();
+    memset(sim_ee.wear, 0, sizeof sim_ee.wear);
+    sim_reset(FW_FOSC);
+#if BOARD_PROFILES
+    sim_press(SIM_MS(300), SIM_MS(1000));          // lang in der Einschalt-Animation
+#endif
+    for (d = 0; d < days; d++)
+        for (k = 0; k < sessions; k++) {
+            t = d * DAY_NS + k * gap + SIM_MS(20000);      // nach Startup + Sleep
+            sim_press(t, SIM_MS(120));                      // Weck-Druck
+            for (j = 0; j < per_session; j++)
+                sim_press(t + SIM_MS(2000 + 5000 * j), SIM_MS(120));
+        }
+    sim_attach_isr(isr);
+    sim_run(fw_main, days * DAY_NS);
+
+    for (a = 0; a < SIM_EE_SIZE; a++) {
+        total += sim_ee.wear[a];
+        if (sim_ee.wear[a] > max) max = sim_ee.wear[a];
+        if (sim_ee.wear[a] < min) min = sim_ee.wear[a];
+        if (a < EE_RING_END) { if (sim_ee.wear[a] > ring) ring = sim_ee.wear[a]; }
+        else if (sim_ee.wear[a] > trc) trc = sim_ee.wear[a];
+    }
+    want        = days * sessions * per_session;
+    want_result = ee_pack();
+    got         = power_on();
+
+    per_byte = (double)max / days;
+    fixed    = (double)sessions;                             // ein Platz: jedes Speichern
+    printf("# %s  EEPROM %u Byte = %u Plätze × %u Byte\n",
+           FW_NAME, SIM_EE_SIZE, (unsigned)EE_SLOTS, EE_REC);
+    printf("# %u Tage, %u Würfe/Tag, %u je Sitzung → %lu Würfe, %llu Byte geschrieben\n",
+           days, sessions * per_session, per_session, (unsigned long)want,
+           (unsigned long long)total);
+    printf("Zyklen je Byte und Tag   max %.2f  min %.2f  (fester Platz: %.2f)\n",
+           per_byte, (double)min / days, fixed);
+#if BOARD_TRACE
+    printf("  davon Ring max %.2f, Ereignis-Protokoll (ab Byte %u) max %.2f\n",
+           (double)ring / days, (unsigned)EE_TRACE_AT, (double)trc / days);
+#endif
+    printf("Lebensdauer @ %.0f Zyklen   %.1f Jahre  (fester Platz: %.1f Jahre)\n",
+           cycles, cycles / per_byte / 365.0, cycles / fixed / 365.0);
+    printf("Lebensdauer @ %.0f Zyklen  %.1f Jahre\n",
+           10.0 * cycles, 10.0 * cycles / per_byte / 365.0);
+    printf("Batteriewechsel: Würfe %lu (soll %lu), letzte Zahl %s",
+           (unsigned long)got.rolls, (unsigned long)want, faces(got.result));
+    printf(" (soll %s), Profil %s (soll %s)  %s\n", faces(want_result),
+           PROF_NAME[got.profile], PROF_NAME[PROF_WEAR],
+           got.rolls == want && got.result == want_result &&
+           got.profile == PROF_WEAR ? "ok" : "FEHLER");
+    return got.rolls == want && got.result == want_result && got.profile == PROF_WEAR ? 0 : 1;
+}
+
+// ─── 2. Stromausfall mitten in ee_save() ──────────────────────────────
+enum { TEAR_OLD, TEAR_NEW, TEAR_ERASED, TEAR_ZERO, TEAR_GARBAGE, TEAR_N };
+
+static uint8_t  image[SIM_EE_SIZE];
+static unsigned n_old, n_new, n_bad, n_cont;
+
+static void call_save(void) { ee_save(); }
+
+// Ring mit n Einträgen als Ausgangsbild
+static void fill(unsigned n) {
+    unsigned k;
+
+    sim_ee_erase();
+    power_on();
+    for (k = 0; k < n; k++) { roll(k); ee_save(); }
+    memcpy(image, sim_ee.data, sizeof image);
+}
+
+// Rückgabe 1: Schnitt traf einen laufenden Schreibvorgang
+static int trial(unsigned n, uint64_t cut_ns, int tear) {
+    struct ee_state old, neu, got, want;
+    uint8_t         was;
+    int             torn = 0;
+
+    memcpy(sim_ee.data, image, sizeof image);
+    old = power_on();
+    roll(n + 1000u);
+    neu = fw_state();
+    if (sim_run(call_save, sim.now_ns + cut_ns) && sim.ee_busy) {
+        torn = 1;
+        was  = sim_ee.data[sim.ee_addr];
+        switch (tear) {
+        case TEAR_OLD:     break;
+        case TEAR_NEW:     sim_ee.data[sim.ee_addr] = sim.ee_data;                 break;
+        case TEAR_ERASED:  sim_ee.data[sim.ee_addr] = 0xFFu;                       break;
+        case TEAR_ZERO:    sim_ee.data[sim.ee_addr] = 0x00u;                       break;
+        default:           sim_ee.data[sim.ee_addr] = (uint8_t)(was ^ sim.ee_data ^ 0x5Au); break;
+        }
+    }
+    got = power_on();
+    if      (same(got, old)) n_old++;
+    else if (same(got, neu)) n_new++;
+    else {
+        n_bad++;
+        printf("FEHLER  n=%u  Schnitt %.3f ms  Abriss %d: Wurf %lu/%u/%04X\n",
+               n, cut_ns / 1e6, tear, (unsigned long)got.rolls, got.result, got.rng);
+    }
+
+    // Weiter wie gewohnt: der nächste Eintrag muss gewinnen
+    roll(n + 2000u);
+    want = fw_state();
+    ee_save();
+    if (same(power_on(), want)) n_cont++;
+    else {
+        n_bad++;
+        printf("FEHLER  n=%u  Schnitt %.3f ms: Ring schreibt danach nicht weiter\n",
+               n, cut_ns / 1e6);
+    }
+    return torn;
+}
+
+static int torn_writes(uint64_t step_ns) {
+    const unsigned fills[] = { 0u, 1u, EE_SLOTS - 1u, EE_SLOTS, 256u, 300u };
+    unsigned       f, trials = 0;
+    uint64_t       t0, dur, cut;
+    int            tear;
+
+    n_old = n_new = n_bad = n_cont = 0;
+    for (f = 0; f < sizeof fills / sizeof fills[0]; f++) {
+        fill(fills[f]);
+        power_on();                                  // Dauer eines Speicherns
+        roll(fills[f] + 1000u);
+        t0  = sim.now_ns;
+        ee_save();
+        dur = sim.now_ns - t0;
+
+        for (cut = 0; cut <= dur + step_ns; cut += step_ns)
+            for (tear = 0; tear < TEAR_N; tear++) {
+                trials++;
+                if (!trial(fills[f], cut, tear)) break;    // kein Abriss: ein Fall genügt
+            }
+    }
+    printf("Abriss: %u Fälle (Füllstände 0/1/%u/%u/256/300, Schnitt alle %.0f µs)\n",
+           trials, (unsigned)EE_SLOTS - 1u, (unsigned)EE_SLOTS, step_ns / 1e3);
+    printf("  nach dem Einschalten: alter Stand %u, neuer Stand %u, FEHLER %u\n",
+           n_old, n_new, n_bad);
+    printf("  Ring schreibt danach weiter: %u/%u  %s\n",
+           n_cont, trials, n_bad ? "FEHLER" : "ok");
+    return n_bad ? 1 : 0;
+}
+
+#if BOARD_RC_CAL
+// ─── 3. RC-Kalibrierung ───────────────────────────────────────────────
+// Einschalten bis nach rc_cal() und dem Speichern, ref = Referenztakt an RA4
+static uint8_t cal_boot(uint32_t fosc, uint32_t ref) {
+    uint8_t c;
+
+    sim_reset(fosc);
+    sim.ref_hz = ref;
+    OPTION_REG = 0x08u;                      // wie main(): Timer0 1:1
+    t0_reload  = (uint8_t)(258u - T0_CYC_NOM);
+    if ((c = rc_cal()) != 0u) ee_write(EE_CAL_AT, c);
+    return (uint8_t)(258u - t0_reload);
+}
+
+static int rc_check(void) {
+    const uint32_t fosc[] = { 520000u, 600000u, 709000u, 800000u, 900000u };
+    unsigned       f, k, bad = 0;
+    uint8_t        nom, jig, kept, want;
+
+    printf("RC-Kalibrierung (Tcy je Tick, Soll = Fosc/4 · %u µs)\n", (unsigned)TICK_US);
+    for (f = 0; f < sizeof fosc / sizeof fosc[0]; f++) {
+        sim_ee_erase();
+        nom  = cal_boot(fosc[f], 0u);
+        jig  = cal_boot(fosc[f], CAL_HZ);
+        power_on();
+        for (k = 0; k < 3u * EE_SLOTS; k++) { roll(k); ee_save(); }
+        kept = cal_boot(fosc[f], 0u);
+        want = (uint8_t)((fosc[f] / 4u * TICK_US + 500000u) / 1000000u);
+        if (want < CAL_MIN || want > CAL_MAX) want = T0_CYC_NOM;   // außerhalb ±30 %
+        printf("  %7lu Hz  ohne %3u  Prüfplatz %3u (soll %3u)  danach %3u  %s\n",
+               (unsigned long)fosc[f], nom, jig, want, kept,
+               nom == T0_CYC_NOM && (uint8_t)(jig - want + 1u) <= 2u && kept == jig
+               ? "ok" : "FEHLER");
+        if (nom != T0_CYC_NOM || (uint8_t)(jig - want + 1u) > 2u || kept != jig) bad++;
+    }
+    return bad ? 1 : 0;
+}
+#endif
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    unsigned per_day = 100u, per_session = 1u, days = 4u;
+    double   cycles  = 100000.0;
+    uint64_t step_ns = 250000u;
+    int      i, err;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            per_day = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-g") && i + 1 < argc) {
+            per_session = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+            days = (unsigned)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-e") && i + 1 < argc) {
+            cycles = strtod(argv[++i], NULL);
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            step_ns = strtoull(argv[++i], NULL, 10) * 1000u;
+        } else {
+            goto usage;
+        }
+    }
+    if (!per_day || !per_session || !days || !step_ns || cycles <= 0.0) goto usage;
+
+    err  = wear(per_day, per_session, days, cycles);
+    err |= torn_writes(step_ns);
+#if BOARD_RC_CAL
+    err |= rc_check();
+#endif
+    return err;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-r würfe/tag] [-g würfe/sitzung] [-d tage] [-e zyklen] [-s µs]\n",
+            argv[0]);
+    return 2;
+}
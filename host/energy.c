@@ -0,0 +1,164 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Energie-Buchhaltung  ·  Integration über die simulierte Zeit
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Kernstrom-Werte (typ., 3 V bzw. 4,5 V, 25 °C):
+ *   PIC16F84A   RC ~700 kHz           ~2 mA  (README: "Idle ~2 mA")
+ *   PIC16F1825  LFINTOSC 31 kHz      ~20 µA
+ *               MFINTOSC 500 kHz    ~150 µA
+ *               HFINTOSC 4 MHz      ~500 µA
+ *               HFINTOSC 16 MHz    ~1300 µA
+ *               32 MHz (PLL)       ~2400 µA
+ *  Dazwischen linear interpoliert.
+ *  Analog (16F1825, Richtwerte): FVR ~15 µA, ADC ~250 µA solange an —
+ *  gilt nur während der aktiven Zeit (vdd_check() misst wach); CPS-
+ *  Oszillator ~18 µA (hoher Bereich, nur während des Scans). WDT
+ *  ~0,5 µA zusätzlich im SLEEP, solange SWDTEN (Touch-Scan).
+ *  Pull-up am gedrückten Taster (typ.): 16F84A IPURB ~250 µA (RB7),
+ *  16F1825 IPUR ~100 µA (WPUA4) — auch im SLEEP, ein klemmender Taster
+ *  kostet also Dauerstrom.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include "energy.h"
+#include "sim.h"
+
+static struct energy_model model;
+static struct energy       acc;
+static uint64_t            last_ns, last_active_ns, last_sleep_ns;
+static uint8_t             leds;
+static double              ana_ua;        // FVR + ADC seit dem letzten Wechsel
+static double              pull_ua;       // Pull-up seit der letzten Flanke
+static double              wdt_ua;        // WDT im SLEEP seit dem letzten Wechsel
+
+// FVR/ADC-Strom nach den aktuellen Registern
+static double analog_ua(void) {
+#if defined(_16F1825)
+    return ((sim.reg[SIM_FVRCON] & 0x80u) ? model.i_fvr_ua : 0.0) +
+           ((sim.reg[SIM_ADCON0] & 0x01u) ? model.i_adc_ua : 0.0) +
+           ((sim.reg[SIM_CPSCON0] & 0x80u) ? model.i_cps_ua : 0.0);
+#else
+    return 0.0;
+#endif
+}
+
+static double watchdog_ua(void) {
+#if defined(_16F1825)
+    return (sim.reg[SIM_WDTCON] & 0x01u) ? model.i_wdt_ua : 0.0;
+#else
+    return 0.0;
+#endif
+}
+
+// Pull-up-Strom: Taster gedrückt und Pull-up eingeschaltet
+static double button_ua(void) {
+    if (!sim.button || (sim.reg[SIM_OPTION_REG] & 0x80u)) return 0.0;   // /RBPU, nWPUEN
+#if defined(_16F1825)
+    if (!(sim.reg[SIM_WPUA] & 0x10u)) return 0.0;
+#endif
+    return model.i_pullup_ua;
+}
+
+void energy_default(struct energy_model *m) {
+#if defined(_16F84A)
+    m->vdd        = 4.5;
+    m->r_led      = 270.0;
+    m->i_cpu_ua   = 2000.0;
+    m->i_pullup_ua = 250.0;
+#else
+    m->vdd        = 3.0;
+    m->r_led      = 47.0;
+    m->i_cpu_ua   = 0.0;
+    m->i_pullup_ua = 100.0;
+#endif
+    m->vf         = 1.8;
+    m->vdrop      = 0.7;
+    m->i_sleep_ua = 1.0;
+    m->i_fvr_ua   = 15.0;
+    m->i_adc_ua   = 250.0;
+    m->i_cps_ua   = 18.0;
+    m->i_wdt_ua   = 0.5;
+}
+
+void energy_init(const struct energy_model *m) {
+    model          = *m;
+    acc            = (struct energy){ 0.0, 0.0, 0.0, 0.0, 0.0 };
+    last_ns        = sim.now_ns;
+    last_active_ns = sim.active_ns;
+    last_sleep_ns  = sim.sleep_ns;
+    leds           = sim.leds;
+    ana_ua         = analog_ua();
+    pull_ua        = button_ua();
+    wdt_ua         = watchdog_ua();
+}
+
+double energy_led_ma(void) {
+    double i = (model.vdd - model.vdrop - model.vf) / model.r_led;
+    return i > 0.0 ? i * 1000.0 : 0.0;
+}
+
+double energy_cpu_ua(uint32_t fosc_hz) {
+    static const struct { double hz, ua; } tab[] = {
+        {    31000.0,   20.0 }, {   500000.0,  150.0 }, {  4000000.0,  500.0 },
+        { 16000000.0, 1300.0 }, { 32000000.0, 2400.0 },
+    };
+    unsigned k;
+
+    if (model.i_cpu_ua > 0.0) return model.i_cpu_ua;
+    if (fosc_hz <= tab[0].hz) return tab[0].ua;
+    for (k = 1; k < sizeof tab / sizeof tab[0]; k++) {
+        if (fosc_hz <= tab[k].hz) {
+            double x = (fosc_hz - tab[k - 1].hz) / (tab[k].hz - tab[k - 1].hz);
+            return tab[k - 1].ua + x * (tab[k].ua - tab[k - 1].ua);
+        }
+    }
+    return tab[k - 1].ua;
+}
+
+// Bis t_ns integrieren, mit dem bis dahin gültigen LED-Muster
+static void integrate(uint64_t t_ns) {
+    double dt_led = (t_ns - last_ns) / 1e9;
+    double dt_cpu = (sim.active_ns - last_active_ns) / 1e9;
+    double dt_slp = (sim.sleep_ns - last_sleep_ns) / 1e9;
+
+    acc.led_uas   += __builtin_popcount(leds) * energy_led_ma() * 1000.0 * dt_led;
+    acc.cpu_uas   += (energy_cpu_ua(sim.fosc_hz) + ana_ua) * dt_cpu;
+    acc.sleep_uas += (model.i_sleep_ua + wdt_ua) * dt_slp;
+    acc.pull_uas  += pull_ua * dt_led;
+    acc.t_s       += dt_led;
+
+    last_ns        = t_ns;
+    last_active_ns = sim.active_ns;
+    last_sleep_ns  = sim.sleep_ns;
+    ana_ua         = analog_ua();     // sim.on_clock: vor Takt-/FVR/ADC/CPS/WDT-Wechsel
+    pull_ua        = button_ua();     // … und nach jeder Tasterflanke
+    wdt_ua         = watchdog_ua();
+}
+
+void energy_frame(uint64_t t_ns, uint8_t new_leds) {
+    integrate(t_ns);
+    leds = new_leds;
+}
+
+void energy_sample(void) {
+    integrate(sim.now_ns);
+}
+
+struct energy energy_total(void) {
+    energy_sample();
+    return acc;
+}
+
+struct energy energy_diff(struct energy a, struct energy b) {
+    struct energy d;
+    d.led_uas   = a.led_uas   - b.led_uas;
+    d.cpu_uas   = a.cpu_uas   - b.cpu_uas;
+    d.sleep_uas = a.sleep_uas - b.sleep_uas;
+    d.pull_uas  = a.pull_uas  - b.pull_uas;
+    d.t_s       = a.t_s       - b.t_s;
+    return d;
+}
+
+double energy_uas(struct energy e) {
+    return e.led_uas + e.cpu_uas + e.sleep_uas + e.pull_uas;
+}
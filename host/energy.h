@@ -0,0 +1,57 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Energie-Buchhaltung  ·  LED-Zeit, CPU-Zeit, Sleep-Zeit → µAs
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Integriert über die Simulation (sim.h):
+ *   - LEDs:   popcount(Muster) × I_LED  über jede Frame-Dauer
+ *   - Kern:   I_CPU(Fosc)               über sim.active_ns
+ *             + I_FVR / I_ADC / I_CPS, solange FVREN, ADON bzw. CPSON
+ *   - Sleep:  I_SLEEP (+ I_WDT mit SWDTEN) über sim.sleep_ns
+ *   - Taster: I_PULLUP                  solange gedrückt (auch im SLEEP)
+ *
+ *  I_LED = (VDD − U_drop − Vf) / R   (README_1825: VOH ≈ VDD − 0,7 V)
+ *    16F84A:   4,5 V, 270 Ω, rot 1,8 V  →  ~7,4 mA je LED
+ *    16F1825:  3,0 V,  47 Ω, rot 1,8 V  → ~10,6 mA je LED
+ *
+ *  Einheit µAs = µA × s  (1 mAh = 3 600 000 µAs)
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef ENERGY_H
+#define ENERGY_H
+
+#include <stdint.h>
+
+struct energy_model {
+    double vdd;         // V
+    double vf;          // LED-Durchlassspannung, V
+    double vdrop;       // VDD − VOH am Port-Pin, V
+    double r_led;       // Vorwiderstand, Ω
+    double i_sleep_ua;  // SLEEP-Strom
+    double i_cpu_ua;    // > 0: fester Kernstrom, sonst Tabelle über Fosc
+    double i_fvr_ua;    // FVR an (16F1825)
+    double i_adc_ua;    // ADC an (16F1825)
+    double i_cps_ua;    // CPS-Oszillator an (16F1825)
+    double i_wdt_ua;    // WDT an, im SLEEP (16F1825)
+    double i_pullup_ua; // Taster gedrückt, Pull-up aktiv
+};
+
+struct energy {
+    double led_uas;
+    double cpu_uas;
+    double sleep_uas;
+    double pull_uas;
+    double t_s;
+};
+
+void          energy_default(struct energy_model *m);
+void          energy_init(const struct energy_model *m);
+void          energy_frame(uint64_t t_ns, uint8_t leds);
+void          energy_sample(void);
+struct energy energy_total(void);
+struct energy energy_diff(struct energy a, struct energy b);
+double        energy_uas(struct energy e);
+double        energy_led_ma(void);
+double        energy_cpu_ua(uint32_t fosc_hz);
+
+#endif
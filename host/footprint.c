@@ -0,0 +1,376 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  footprint  ·  Flash/RAM je Funktion aus XC8-Map + Listing, mit Budget
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Der 16F84A hat 1K Wörter Flash und 68 Byte RAM — jede Änderung soll
+ *  zeigen, was sie kostet. Gelesen werden die Ausgaben von XC8:
+ *
+ *    Map (-Wl,-Map=dice.map)
+ *      Klassen-Tabelle (TOTAL … CLASS): Länge jedes Psects
+ *      Symbol Table: _name psect adresse, __end_of_name am Funktionsende
+ *      (i1_name: ISR-Kopie einer Funktion, die auch main ruft)
+ *    Listing (dice.lst, optional): Kopf jeder Funktion
+ *      „Total ram usage“ (Parameter, Autos, Temps im Compiled Stack)
+ *      „Hardware stack levels required when called“
+ *
+ *  Zuordnung:
+ *    Wörter  Funktion: _name … __end_of_name; Tabelle (const, RETLW):
+ *            bis zum nächsten Symbol im Psect bzw. Psect-Ende
+ *    RAM     je Funktion aus dem Listing. Der Compiled Stack überlagert
+ *            Funktionen, die sich nicht gegenseitig aufrufen → die Summe
+ *            ist größer als belegt; die Klassen-Summen sind exakt
+ *    Flash   Klassen CODE, STRCODE, STRING, CONST, ENTRY (ohne CONFIG,
+ *            IDLOC, EEDATA); RAM: COMMON, BANK0 … BANK12, BIGRAM
+ *            (Objekte > 80 Byte, linear über mehrere Bänke)
+ *    Stack   main + isr: ein Interrupt kann an der tiefsten Stelle von
+ *            main kommen
+ *
+ *  Budget-Datei (host/budget.txt), je Chip ein Abschnitt [16F84A]:
+ *    name  wörter  ram        - = ohne Grenze
+ *    flash wörter / ram bytes / stack ebenen
+ *  Überschritten → Rückgabe 1. Funktionen ohne Budget werden nur gemeldet.
+ *
+ *  Build:
+ *    gcc -O2 -o footprint host/footprint.c
+ *
+ *  Aufruf:
+ *    footprint [-b budget] [-l listing] [-q] datei.map
+ *      -b   Budget-Datei (ohne: nur Tabelle)
+ *      -l   XC8-Listing derselben Übersetzung (RAM je Funktion, Stack)
+ *      -q   nur Überschreitungen und Summen
+ *
+ *  Ohne Compiler: host/fixtures/dice_{84a,1825}.{map,lst} sind
+ *  SYNTHETISCH — von Hand im Format von XC8 v2.x geschrieben (nur die
+ *  gelesenen Abschnitte), alle Größen geschätzt. Sie prüfen Parser und
+ *  Budget-Vergleich, nicht die Firmware; footprint meldet das in der
+ *  Kopfzeile. Aussagekräftig erst mit den Dateien eines echten Builds.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PS    128
+#define MAX_SYM   1024
+#define MAX_ITEM  256
+#define NO_LIMIT  (-1L)
+
+// ─── Daten aus Map und Listing ────────────────────────────────────────
+enum { C_OTHER, C_FLASH, C_RAM };
+
+struct psect {
+    char     name[64];
+    int      cls;
+    unsigned link, len;
+};
+
+struct sym {
+    char     name[64];
+    int      ps;            // Index in ps[], -1 = nicht zugeordnet
+    unsigned addr;
+};
+
+struct item {
+    char     name[64];
+    long     words, ram, stack;         // -1 = unbekannt
+    long     b_words, b_ram;            // Budget, NO_LIMIT = ohne
+    int      budget;                    // 1 = Zeile in der Budget-Datei
+};
+
+static struct psect ps[MAX_PS];
+static struct sym   sy[MAX_SYM];
+static struct item  it[MAX_ITEM];
+static unsigned     n_ps, n_sy, n_it;
+static char         chip[32];
+static int          quiet;
+static int          synthetic;      // Fixture: Größen geschätzt
+
+static int class_of(const char *c) {
+    static const char *flash[] = { "CODE", "STRCODE", "STRING", "CONST", "ENTRY" };
+    unsigned k;
+
+    for (k = 0; k < sizeof flash / sizeof flash[0]; k++)
+        if (!strcmp(c, flash[k])) return C_FLASH;
+    if (!strcmp(c, "COMMON") || !strcmp(c, "BIGRAM") || !strncmp(c, "BANK", 4)) return C_RAM;
+    return C_OTHER;
+}
+
+static int is_hex(const char *s) {
+    return *s && strspn(s, "0123456789ABCDEFabcdef") == strlen(s);
+}
+
+static struct item *item(const char *name) {
+    unsigned k;
+
+    for (k = 0; k < n_it; k++)
+        if (!strcmp(it[k].name, name)) return &it[k];
+    if (n_it == MAX_ITEM) { fprintf(stderr, "zu viele Einträge\n"); exit(2); }
+    memset(&it[n_it], 0, sizeof it[n_it]);
+    snprintf(it[n_it].name, sizeof it[n_it].name, "%s", name);
+    it[n_it].words = it[n_it].ram = it[n_it].stack = -1;
+    it[n_it].b_words = it[n_it].b_ram = NO_LIMIT;
+    return &it[n_it++];
+}
+
+static int find_ps(const char *name) {
+    unsigned k;
+    for (k = 0; k < n_ps; k++)
+        if (!strcmp(ps[k].name, name)) return (int)k;
+    return -1;
+}
+
+static const struct item *find_item(const char *name) {
+    unsigned k;
+    for (k = 0; k < n_it; k++)
+        if (!strcmp(it[k].name, name)) return &it[k];
+    return NULL;
+}
+
+static const struct sym *find_sym(const char *name) {
+    unsigned k;
+    for (k = 0; k < n_sy; k++)
+        if (!strcmp(sy[k].name, name)) return &sy[k];
+    return NULL;
+}
+
+// ─── Map lesen ────────────────────────────────────────────────────────
+static int load_map(const char *path) {
+    FILE *f = fopen(path, "r");
+    char  line[512], a[64], b[64], c[64], d[64];
+    int   sec = 0, cls = C_OTHER;       // 1 = Klassen-Tabelle, 2 = Symbole
+
+    if (!f) return -1;
+    while (fgets(line, sizeof line, f)) {
+        if (sscanf(line, "Machine type is %31s", chip) == 1) continue;
+        if (!strncmp(line, "SYNTHETISCH", 11))          { synthetic = 1; continue; }
+        if (!strncmp(line, "TOTAL", 5))                 { sec = 1; continue; }
+        if (!strncmp(line, "SEGMENTS", 8) ||
+            !strncmp(line, "UNUSED ADDRESS RANGES", 21)) { sec = 0; continue; }
+        if (strstr(line, "Symbol Table"))               { sec = 2; continue; }
+
+        if (sec == 1) {
+            if (sscanf(line, " CLASS %63s", a) == 1) { cls = class_of(a); continue; }
+            if (sscanf(line, "%63s %63s %63s %63s", a, b, c, d) == 4 &&
+                is_hex(b) && is_hex(c) && is_hex(d) && n_ps < MAX_PS && find_ps(a) < 0) {
+                snprintf(ps[n_ps].name, sizeof ps[n_ps].name, "%s", a);
+                ps[n_ps].cls  = cls;
+                ps[n_ps].link = (unsigned)strtoul(b, NULL, 16);
+                ps[n_ps].len  = (unsigned)strtoul(d, NULL, 16);
+                n_ps++;
+            }
+        } else if (sec == 2) {
+            if (sscanf(line, "%63s %63s %63s", a, b, c) == 3 && is_hex(c) && n_sy < MAX_SYM) {
+                snprintf(sy[n_sy].name, sizeof sy[n_sy].name, "%s", a);
+                sy[n_sy].ps   = find_ps(b);
+                sy[n_sy].addr = (unsigned)strtoul(c, NULL, 16);
+                n_sy++;
+            }
+        }
+    }
+    fclose(f);
+    return n_ps && n_sy ? 0 : -2;
+}
+
+// C-Namen: _name (Firmware), ___name (Bibliothek, z. B. ___lbmod) und
+// i1_name (Kopie für die ISR, wenn Hauptschleife und ISR dieselbe
+// Funktion rufen); Linker-Symbole (__Lpsect, __end_of_…, __pcstack…)
+// zählen nicht
+static const char *c_name(const char *s) {
+    if (!strncmp(s, "i1", 2)) return s;
+    if (s[0] != '_') return NULL;
+    if (s[1] == '_' && s[2] != '_') return NULL;
+    return s + 1;
+}
+
+// Programmwörter je Funktion/Tabelle in Flash-Psects
+static void attribute_flash(void) {
+    char     end[80];
+    unsigned k, j, stop;
+    const struct sym *e;
+
+    for (k = 0; k < n_sy; k++) {
+        const char *name = c_name(sy[k].name);
+        if (!name || sy[k].ps < 0 || ps[sy[k].ps].cls != C_FLASH) continue;
+
+        snprintf(end, sizeof end, "__end_of%s", sy[k].name);
+        e = find_sym(end);
+        if (e) {
+            stop = e->addr;
+        } else {                        // Tabelle: bis zum nächsten Symbol
+            stop = ps[sy[k].ps].link + ps[sy[k].ps].len;
+            for (j = 0; j < n_sy; j++)
+                if (sy[j].ps == sy[k].ps && sy[j].addr > sy[k].addr && sy[j].addr < stop)
+                    stop = sy[j].addr;
+        }
+        item(name)->words = (long)(stop - sy[k].addr);
+    }
+}
+
+// ─── Listing lesen: Funktionsköpfe ────────────────────────────────────
+static int load_lst(const char *path) {
+    FILE        *f = fopen(path, "r");
+    char         line[512], name[64];
+    long         v;
+    struct item *cur = NULL;
+    int          n = 0;
+
+    if (!f) return -1;
+    while (fgets(line, sizeof line, f)) {
+        if (sscanf(line, ";; *************** function %63s", name) == 1) {
+            cur = item(c_name(name) ? c_name(name) : name);
+            n++;
+        } else if (cur && sscanf(line, ";;Total ram usage: %ld", &v) == 1) {
+            cur->ram = v;
+        } else if (cur && sscanf(line, ";; Hardware stack levels required when called: %ld", &v) == 1) {
+            cur->stack = v;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+// ─── Budget-Datei ─────────────────────────────────────────────────────
+static long limit(const char *s) {
+    return strcmp(s, "-") ? strtol(s, NULL, 10) : NO_LIMIT;
+}
+
+static int load_budget(const char *path, long *flash, long *ram, long *stack) {
+    FILE *f = fopen(path, "r");
+    char  line[256], a[64], b[32], c[32], sect[32] = "";
+    int   n, mine = 0, lineno = 0;
+    struct item *x;
+
+    if (!f) return -1;
+    while (fgets(line, sizeof line, f)) {
+        lineno++;
+        if (strchr(line, '#')) *strchr(line, '#') = '\0';
+        if (sscanf(line, " [%31[^]]]", sect) == 1) { mine = !strcmp(sect, chip); continue; }
+        n = sscanf(line, "%63s %31s %31s", a, b, c);
+        if (n <= 0 || !mine) continue;
+        if (n < 2) {
+            fprintf(stderr, "%s:%d: Grenze fehlt\n", path, lineno);
+            fclose(f);
+            return -2;
+        }
+        if      (!strcmp(a, "flash")) *flash = limit(b);
+        else if (!strcmp(a, "ram"))   *ram   = limit(b);
+        else if (!strcmp(a, "stack")) *stack = limit(b);
+        else {
+            x = item(a);
+            x->budget  = 1;
+            x->b_words = limit(b);
+            x->b_ram   = n > 2 ? limit(c) : NO_LIMIT;
+        }
+    }
+    fclose(f);
+    return 0;
+}
+
+// ─── Ausgabe ──────────────────────────────────────────────────────────
+static int over(long v, long lim) {
+    return lim != NO_LIMIT && v > lim;
+}
+
+static void col(long v) {
+    if (v < 0) printf("  %6s", "-");
+    else       printf("  %6ld", v);
+}
+
+static int by_words(const void *a, const void *b) {
+    const struct item *x = a, *y = b;
+    return x->words < y->words ? 1 : x->words > y->words ? -1 : strcmp(x->name, y->name);
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    const char *map = NULL, *lst = NULL, *budget = NULL;
+    long        b_flash = NO_LIMIT, b_ram = NO_LIMIT, b_stack = NO_LIMIT;
+    long        flash = 0, ram = 0, cstack = 0, named = 0;
+    long        s_main = -1, s_isr = 0, stack = -1;
+    unsigned    k;
+    int         fails = 0, missing = 0, unbudgeted = 0, bad;
+    const struct item *x;
+
+    for (k = 1; k < (unsigned)argc; k++) {
+        if (!strcmp(argv[k], "-b") && k + 1 < (unsigned)argc)      budget = argv[++k];
+        else if (!strcmp(argv[k], "-l") && k + 1 < (unsigned)argc) lst = argv[++k];
+        else if (!strcmp(argv[k], "-q"))                           quiet = 1;
+        else if (argv[k][0] != '-' && !map)                        map = argv[k];
+        else goto usage;
+    }
+    if (!map) goto usage;
+
+    switch (load_map(map)) {
+    case -1: perror(map); return 2;
+    case -2: fprintf(stderr, "%s: keine XC8-Map (Klassen-Tabelle/Symbol Table fehlt)\n", map); return 2;
+    }
+    attribute_flash();
+    if (lst && load_lst(lst) < 0) { perror(lst); return 2; }
+    switch (budget ? load_budget(budget, &b_flash, &b_ram, &b_stack) : 0) {
+    case -1: perror(budget); return 2;
+    case -2: return 2;
+    }
+
+    for (k = 0; k < n_ps; k++) {
+        if (ps[k].cls == C_FLASH) flash += ps[k].len;
+        if (ps[k].cls == C_RAM) {
+            ram += ps[k].len;
+            if (!strncmp(ps[k].name, "cstack", 6)) cstack += ps[k].len;
+        }
+    }
+    if ((x = find_item("main")) != NULL) s_main = x->stack;
+    if ((x = find_item("isr")) != NULL && x->stack > 0) s_isr = x->stack;
+    if (s_main >= 0) stack = s_main + s_isr;
+
+    printf("# PIC%s  %s%s%s%s%s\n", chip, map, lst ? " + " : "", lst ? lst : "",
+           budget ? "  Budget " : "", budget ? budget : "");
+    if (synthetic)
+        printf("# SYNTHETISCH: Größen geschätzt, nicht gemessen — prüft nur den Parser\n");
+    qsort(it, n_it, sizeof it[0], by_words);
+    if (!quiet) printf("%-20s %7s %7s %7s %7s\n", "Funktion/Tabelle", "Wörter", "Budget", "RAM", "Budget");
+    for (k = 0; k < n_it; k++) {
+        x   = &it[k];
+        bad = over(x->words, x->b_words) || over(x->ram, x->b_ram);
+        if (x->words > 0) named += x->words;
+        if (x->budget && x->words < 0 && x->ram < 0) { missing++; bad = 0; }
+        if (!x->budget && budget) unbudgeted++;
+        fails += bad;
+        if (quiet && !bad) continue;
+        printf("%-20s", x->name);
+        col(x->words); col(x->b_words); col(x->ram); col(x->b_ram);
+        printf("%s\n", bad ? "  ÜBER" : x->budget && x->words < 0 && x->ram < 0 ? "  fehlt" :
+                       budget && !x->budget ? "  ohne Budget" : "");
+    }
+    if (!quiet) printf("%-20s  %6ld\n", "(nicht zugeordnet)", flash - named);
+
+    bad = over(flash, b_flash);
+    fails += bad;
+    printf("Flash gesamt  %6ld Wörter", flash);
+    if (b_flash != NO_LIMIT) printf(" / %ld (%.1f %%)", b_flash, 100.0 * flash / b_flash);
+    printf("%s\n", bad ? "  ÜBER" : "");
+
+    bad = over(ram, b_ram);
+    fails += bad;
+    printf("RAM gesamt    %6ld Byte", ram);
+    if (b_ram != NO_LIMIT) printf(" / %ld (%.1f %%)", b_ram, 100.0 * ram / b_ram);
+    printf("  (global %ld, Compiled Stack %ld)%s\n", ram - cstack, cstack, bad ? "  ÜBER" : "");
+
+    if (stack >= 0) {
+        bad = over(stack, b_stack);
+        fails += bad;
+        printf("Stack         %6ld Ebenen (main %ld + isr %ld)", stack, s_main, s_isr);
+        if (b_stack != NO_LIMIT) printf(" / %ld", b_stack);
+        printf("%s\n", bad ? "  ÜBER" : "");
+    } else if (b_stack != NO_LIMIT) {
+        printf("Stack         nicht geprüft (ohne -l Listing)\n");
+    }
+    if (budget)
+        printf("# Budget: %d überschritten, %d ohne Budget, %d fehlen\n",
+               fails, unbudgeted, missing);
+    return fails ? 1 : 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-b budget] [-l listing] [-q] datei.map\n", argv[0]);
+    return 2;
+}
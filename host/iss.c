@@ -0,0 +1,1370 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Befehlssatz-Simulator  ·  Kern, Peripherie, HEX-/Map-Lader
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Ablauf je Befehl:  Holen (vordekodiert) → Ausführen → Zeit/Timer
+ *  weiterschalten → Ereignisse (Taster, WDT, EEPROM) → Interrupt prüfen.
+ *
+ *  Datenspeicher: jede Bank-Adresse (84A: RP0<<7 | f, 1825: BSR<<7 | f)
+ *  zeigt über alias[] auf ihre kanonische Adresse (gespiegelte Register,
+ *  Common-RAM), kind[] sagt, ob dort RAM, ein SFR mit Nebenwirkung oder
+ *  nichts liegt. RAM-Zugriffe laufen so ohne Verzweigung in der Tabelle.
+ *
+ *  Quellen: DS35007C (PIC16F84A), DS41440C (PIC16F1825), Befehlssatz-
+ *  Tabellen jeweils Kapitel „Instruction Set Summary“.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include "iss.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+enum { K_RAM, K_SFR, K_NONE };
+
+// ─── Befehle (beide Kerne) ────────────────────────────────────────────
+enum {
+    OP_ADDWF, OP_ANDWF, OP_CLRF, OP_CLRW, OP_COMF, OP_DECF, OP_DECFSZ,
+    OP_INCF, OP_INCFSZ, OP_IORWF, OP_MOVF, OP_MOVWF, OP_NOP, OP_RLF,
+    OP_RRF, OP_SUBWF, OP_SWAPF, OP_XORWF,
+    OP_BCF, OP_BSF, OP_BTFSC, OP_BTFSS,
+    OP_ADDLW, OP_ANDLW, OP_CALL, OP_CLRWDT, OP_GOTO, OP_IORLW, OP_MOVLW,
+    OP_RETFIE, OP_RETLW, OP_RETURN, OP_SLEEP, OP_SUBLW, OP_XORLW,
+    OP_OPTION, OP_TRIS,
+    // nur Enhanced Mid-Range
+    OP_ADDWFC, OP_ASRF, OP_LSLF, OP_LSRF, OP_SUBWFB, OP_MOVLB, OP_MOVLP,
+    OP_BRA, OP_BRW, OP_CALLW, OP_ADDFSR, OP_MOVIW, OP_MOVIWK, OP_MOVWI,
+    OP_MOVWIK, OP_RESET,
+    OP_ILLEGAL
+};
+
+// ─── Register ─────────────────────────────────────────────────────────
+#define R_INDF     0x00u
+#define R_PCL      0x02u
+#define R_STATUS   0x03u
+#define R_PCLATH   0x0Au
+#define R_INTCON   0x0Bu
+
+#define ST_C       0x01u
+#define ST_DC      0x02u
+#define ST_Z       0x04u
+#define ST_NPD     0x08u
+#define ST_NTO     0x10u
+#define ST_RP0     0x20u
+
+#define IC_GIE     0x80u
+#define IC_PEIE    0x40u        // 84A: EEIE
+#define IC_T0IE    0x20u
+#define IC_INTE    0x10u
+#define IC_RBIE    0x08u        // 1825: IOCIE
+#define IC_T0IF    0x04u
+#define IC_INTF    0x02u
+#define IC_RBIF    0x01u        // 1825: IOCIF (nur lesbar)
+
+// PIC16F84A
+#define M_TMR0     0x01u
+#define M_FSR      0x04u
+#define M_PORTA    0x05u
+#define M_PORTB    0x06u
+#define M_EEDATA   0x08u
+#define M_EEADR    0x09u
+#define M_OPTION   0x81u
+#define M_TRISA    0x85u
+#define M_TRISB    0x86u
+#define M_EECON1   0x88u
+#define M_EECON2   0x89u
+
+// PIC16F1825
+#define E_INDF1    0x01u
+#define E_FSR0L    0x04u
+#define E_BSR      0x08u
+#define E_WREG     0x09u
+#define E_PORTA    0x0Cu
+#define E_PORTC    0x0Eu
+#define E_PIR1     0x11u
+#define E_PIR2     0x12u
+#define E_PIR3     0x13u
+#define E_TMR0     0x15u
+#define E_TMR1L    0x16u
+#define E_TMR1H    0x17u
+#define E_T1CON    0x18u
+#define E_T1GCON   0x19u
+#define E_TMR2     0x1Au
+#define E_PR2      0x1Bu
+#define E_T2CON    0x1Cu
+#define E_TRISA    0x8Cu
+#define E_TRISC    0x8Eu
+#define E_PIE1     0x91u
+#define E_PIE2     0x92u
+#define E_PIE3     0x93u
+#define E_OPTION   0x95u
+#define E_PCON     0x96u
+#define E_WDTCON   0x97u
+#define E_OSCTUNE  0x98u
+#define E_OSCCON   0x99u
+#define E_OSCSTAT  0x9Au
+#define E_ADRESL   0x9Bu
+#define E_ADRESH   0x9Cu
+#define E_ADCON0   0x9Du
+#define E_ADCON1   0x9Eu
+#define E_LATA     0x10Cu
+#define E_LATC     0x10Eu
+#define E_FVRCON   0x117u
+#define E_ANSELA   0x18Cu
+#define E_ANSELC   0x18Eu
+#define E_EEADRL   0x191u
+#define E_EEADRH   0x192u
+#define E_EEDATL   0x193u
+#define E_EEDATH   0x194u
+#define E_EECON1   0x195u
+#define E_EECON2   0x196u
+#define E_WPUA     0x20Cu
+#define E_WPUC     0x20Eu
+#define E_IOCAP    0x391u
+#define E_IOCAN    0x392u
+#define E_IOCAF    0x393u
+#define E_SHAD     0xFE4u       // STATUS, WREG, BSR, PCLATH, FSR0L/H, FSR1L/H
+#define E_STKPTR   0xFEDu
+#define E_TOSL     0xFEEu
+#define E_TOSH     0xFEFu
+
+#define EE_WRITE_PS   (4ull * ISS_PS_MS)     // typ. Schreibzeit je Byte
+#define WDT84_PS      (18ull * ISS_PS_MS)    // 84A: WDT-Grundperiode typ.
+
+#define ENH(m)    ((m)->chip == ISS_16F1825)
+#define ST(m)     ((m)->ram[R_STATUS])
+
+// ─── Speicherkarte ────────────────────────────────────────────────────
+static void map_range(struct iss *m, unsigned lo, unsigned hi, uint8_t kind) {
+    unsigned a;
+    for (a = lo; a <= hi; a++) m->kind[a] = kind;
+}
+
+static void build_map(struct iss *m) {
+    unsigned a;
+
+    for (a = 0; a < 4096u; a++) { m->alias[a] = (uint16_t)a; m->kind[a] = K_NONE; }
+
+    if (!ENH(m)) {
+        static const uint8_t sfr[] = {
+            R_INDF, M_TMR0, R_PCL, R_STATUS, M_PORTA, M_PORTB, R_INTCON,
+            M_OPTION, M_TRISA, M_TRISB, M_EECON1, M_EECON2,
+        };
+        for (a = 0x80u; a < 0x100u; a++) {
+            unsigned f = a & 0x7Fu;
+            if (f == R_INDF || f == R_PCL || f == R_STATUS || f == M_FSR ||
+                f == R_PCLATH || f == R_INTCON || (f >= 0x0Cu && f <= 0x4Fu))
+                m->alias[a] = (uint16_t)f;
+        }
+        map_range(m, 0x0Cu, 0x4Fu, K_RAM);
+        m->kind[M_FSR] = m->kind[M_EEDATA] = m->kind[M_EEADR] = m->kind[R_PCLATH] = K_RAM;
+        for (a = 0; a < sizeof sfr; a++) m->kind[sfr[a]] = K_SFR;
+        return;
+    }
+
+    {
+        static const uint16_t sfr[] = {
+            R_INDF, E_INDF1, R_PCL, R_STATUS, E_BSR, E_WREG, R_INTCON,
+            E_PORTA, E_PORTC, E_TMR0, E_T1CON, E_T2CON, E_TRISA, E_TRISC,
+            E_OPTION, E_WDTCON, E_OSCCON, E_OSCSTAT, E_LATA, E_LATC,
+            E_ANSELA, E_ANSELC, E_EECON1, E_EECON2, E_WPUA, E_WPUC,
+            E_ADCON0, E_STKPTR, E_TOSL, E_TOSH,
+        };
+        static const uint16_t ram[] = {
+            E_PIR1, E_PIR2, E_PIR3, E_TMR1L, E_TMR1H, E_T1GCON, E_TMR2,
+            E_PR2, E_PIE1, E_PIE2, E_PIE3, E_PCON, E_OSCTUNE,
+            E_EEADRL, E_EEADRH, E_EEDATL, E_EEDATH, E_IOCAP, E_IOCAN, E_IOCAF,
+            E_ADRESL, E_ADRESH, E_ADCON1, E_FVRCON,
+        };
+        for (a = 0; a < 4096u; a++) {
+            unsigned f = a & 0x7Fu, bank = a >> 7;
+            if (f < 0x0Cu)       m->alias[a] = (uint16_t)f;
+            else if (f >= 0x70u) m->alias[a] = (uint16_t)(0x70u | (f & 0x0Fu));
+            if (f >= 0x20u && f < 0x70u && (bank < 12u || (bank == 12u && f < 0x50u)))
+                m->kind[a] = K_RAM;
+        }
+        map_range(m, 0x70u, 0x7Fu, K_RAM);
+        map_range(m, E_FSR0L, E_FSR0L + 3u, K_RAM);
+        m->kind[R_PCLATH] = K_RAM;
+        map_range(m, 0x9Bu, 0x9Eu, K_RAM);             // ADC
+        map_range(m, 0x111u, 0x11Eu, K_RAM);           // CMP, FVR, DAC, SR
+        map_range(m, E_SHAD, E_SHAD + 7u, K_RAM);
+        for (a = 0; a < sizeof ram / sizeof ram[0]; a++) m->kind[ram[a]] = K_RAM;
+        for (a = 0; a < sizeof sfr / sizeof sfr[0]; a++) m->kind[sfr[a]] = K_SFR;
+    }
+}
+
+// ─── Takt ─────────────────────────────────────────────────────────────
+static void set_fosc(struct iss *m, uint32_t hz) {
+    if (!hz) hz = 1u;
+    m->fosc_hz = hz;
+    m->tcy_ps  = (4000000000000ull + hz / 2u) / hz;
+}
+
+// OSCCON: SPLLEN | IRCF<3:0> | – | SCS<1:0>
+static void osccon_1825(struct iss *m) {
+    static const uint32_t hz[16] = {
+        31000, 31000, 31250, 31250, 62500, 125000, 250000, 500000,
+        125000, 250000, 500000, 1000000, 2000000, 4000000, 8000000, 16000000,
+    };
+    uint8_t  osc  = m->ram[E_OSCCON];
+    uint8_t  ircf = (osc >> 3) & 0x0Fu, scs = osc & 0x03u;
+    uint32_t f    = hz[ircf];
+
+    if (ircf < 2u) f = m->lfintosc_hz;
+    if (scs == 1u) f = 32768u;                         // Timer1-Oszillator
+    else if (scs == 0u && ircf == 0x0Eu &&
+             ((osc & 0x80u) || (m->config[1] & 0x0100u)))
+        f = 32000000u;                                 // 8 MHz × 4 PLL
+    set_fosc(m, f);
+}
+
+// ─── Timer ────────────────────────────────────────────────────────────
+static void option_changed(struct iss *m) {
+    uint8_t opt = m->ram[ENH(m) ? E_OPTION : M_OPTION];
+    m->t0_on  = !(opt & 0x20u);                        // T0CS = 0: Fosc/4
+    m->t0_div = (opt & 0x08u) ? 1u : (2u << (opt & 0x07u));
+}
+
+static void t1_changed(struct iss *m) {
+    uint8_t c = m->ram[E_T1CON];
+    m->t1_on  = c & 0x01u;
+    m->t1_src = (c >> 6) & 0x03u;
+    m->t1_div = 1u << ((c >> 4) & 0x03u);
+    if (m->t1_src == 2u && !(c & 0x08u)) m->t1_on = 0;  // ohne T1OSC kein Takt
+}
+
+static void t2_changed(struct iss *m) {
+    static const uint8_t pre[4] = { 1, 4, 16, 64 };
+    uint8_t c = m->ram[E_T2CON];
+    m->t2_on  = (c >> 2) & 0x01u;
+    m->t2_div = pre[c & 0x03u];
+}
+
+static void t1_count(struct iss *m, uint64_t n) {
+    uint32_t t = (uint32_t)m->ram[E_TMR1L] | ((uint32_t)m->ram[E_TMR1H] << 8);
+    t += (uint32_t)(n & 0xFFFFFFFFu);
+    if (t > 0xFFFFu || n > 0xFFFFu) m->ram[E_PIR1] |= 0x01u;   // TMR1IF
+    m->ram[E_TMR1L] = (uint8_t)t;
+    m->ram[E_TMR1H] = (uint8_t)(t >> 8);
+}
+
+// Taktperiode der zeitbasierten Timer1-Quellen (LFINTOSC, T1OSC)
+static uint64_t t1_tick_ps(const struct iss *m) {
+    uint32_t hz = m->t1_src == 3u ? m->lfintosc_hz : 32768u;
+    return (1000000000000ull / hz) * m->t1_div;
+}
+
+// ─── WDT ──────────────────────────────────────────────────────────────
+static void wdt_update(struct iss *m) {
+    uint8_t was = m->wdt_on;
+
+    if (!ENH(m)) {
+        uint8_t opt = m->ram[M_OPTION];
+        m->wdt_on        = (m->config[0] >> 2) & 1u;
+        m->wdt_period_ps = WDT84_PS << ((opt & 0x08u) ? (opt & 0x07u) : 0u);
+    } else {
+        uint8_t  wdte = (m->config[0] >> 3) & 0x03u;
+        uint8_t  ps   = (m->ram[E_WDTCON] >> 1) & 0x1Fu;
+        if (ps > 18u) ps = 18u;
+        m->wdt_on = wdte == 3u || (wdte == 2u && !m->sleeping) ||
+                    (wdte == 1u && (m->ram[E_WDTCON] & 0x01u));
+        m->wdt_period_ps = ((32ull << ps) * 1000000000000ull) / m->lfintosc_hz;
+    }
+    if (m->wdt_on && !was) m->wdt_start_ps = m->now_ps;
+}
+
+static void wdt_clear(struct iss *m) {
+    m->wdt_start_ps = m->now_ps;
+}
+
+// ─── Pins ─────────────────────────────────────────────────────────────
+static uint8_t led_pattern(const struct iss *m) {
+    if (!ENH(m))
+        return m->pins[1] & (uint8_t)~m->ram[M_TRISB] & 0x7Fu;
+    return (uint8_t)((m->pins[1] & (uint8_t)~m->ram[E_TRISC] & 0x3Fu) |
+                     (((m->pins[0] & (uint8_t)~m->ram[E_TRISA]) >> 5) & 1u) << 6);
+}
+
+// Pegel aller Pins neu bestimmen, Flanken → RBIF / IOCAFx / INTF
+static void pins_update(struct iss *m) {
+    uint8_t old0 = m->pins[0], old1 = m->pins[1], leds;
+
+    if (!ENH(m)) {
+        uint8_t trisa = m->ram[M_TRISA], trisb = m->ram[M_TRISB];
+        uint8_t pu    = (m->ram[M_OPTION] & 0x80u) ? 0x00u : 0xFFu;   // /RBPU
+        uint8_t extb  = pu;
+
+        if (m->btn_pressed) extb &= (uint8_t)~(1u << m->btn_bit);
+        m->pins[0] = (uint8_t)(((m->ram[M_PORTA] & ~trisa) & 0x1Fu));
+        m->pins[1] = (uint8_t)((m->ram[M_PORTB] & ~trisb) | (extb & trisb));
+
+        if ((m->pins[1] ^ m->rb_seen) & trisb & 0xF0u)
+            m->ram[R_INTCON] |= IC_RBIF;               // Mismatch RB7:RB4
+        if ((trisb & 0x01u) && ((old1 ^ m->pins[1]) & 0x01u) &&
+            (!!(m->pins[1] & 0x01u) == !!(m->ram[M_OPTION] & 0x40u)))
+            m->ram[R_INTCON] |= IC_INTF;               // RB0/INT
+    } else {
+        uint8_t trisa = m->ram[E_TRISA] | 0x08u, trisc = m->ram[E_TRISC];
+        uint8_t pu    = (m->ram[E_OPTION] & 0x80u) ? 0x00u : 0xFFu;   // nWPUEN
+        uint8_t exta  = pu & m->ram[E_WPUA], extc = pu & m->ram[E_WPUC];
+        uint8_t dig0, dign, rise, fall;
+
+        if (m->btn_pressed) {
+            if (m->btn_port == 0) exta &= (uint8_t)~(1u << m->btn_bit);
+            else                  extc &= (uint8_t)~(1u << m->btn_bit);
+        }
+        m->pins[0] = (uint8_t)(((m->ram[E_LATA] & ~trisa) | (exta & trisa)) & 0x3Fu);
+        m->pins[1] = (uint8_t)(((m->ram[E_LATC] & ~trisc) | (extc & trisc)) & 0x3Fu);
+
+        // IOC über den digitalen Eingangspuffer (ANSEL = 1 → liest 0)
+        dig0 = old0 & (uint8_t)~m->ram[E_ANSELA];
+        dign = m->pins[0] & (uint8_t)~m->ram[E_ANSELA];
+        rise = (uint8_t)(~dig0 & dign) & m->ram[E_IOCAP];
+        fall = (uint8_t)(dig0 & ~dign) & m->ram[E_IOCAN];
+        m->ram[E_IOCAF] |= (uint8_t)(rise | fall);
+        if ((trisa & 0x04u) && ((dig0 ^ dign) & 0x04u) &&
+            (!!(dign & 0x04u) == !!(m->ram[E_OPTION] & 0x40u)))
+            m->ram[R_INTCON] |= IC_INTF;               // RA2/INT
+    }
+
+    leds = led_pattern(m);
+    if (leds != m->leds) {
+        m->leds = leds;
+        if (m->on_leds) m->on_leds(m->now_ps, leds);
+    }
+}
+
+// ─── Interrupt-Bedingungen ────────────────────────────────────────────
+// Weckt aus SLEEP unabhängig von GIE; Interrupt nur mit GIE.
+static int wake_pending(const struct iss *m) {
+    uint8_t ic = m->ram[R_INTCON];
+
+    if ((ic & IC_T0IE) && (ic & IC_T0IF)) return 1;
+    if ((ic & IC_INTE) && (ic & IC_INTF)) return 1;
+    if (!ENH(m)) {
+        if ((ic & IC_RBIE) && (ic & IC_RBIF)) return 1;
+        return (ic & IC_PEIE) && (m->ram[M_EECON1] & 0x10u);       // EEIE/EEIF
+    }
+    if ((ic & IC_RBIE) && m->ram[E_IOCAF]) return 1;               // IOCIE/IOCIF
+    return (ic & IC_PEIE) &&
+           ((m->ram[E_PIE1] & m->ram[E_PIR1]) | (m->ram[E_PIE2] & m->ram[E_PIR2]) |
+            (m->ram[E_PIE3] & m->ram[E_PIR3]));
+}
+
+// ─── EEPROM ───────────────────────────────────────────────────────────
+static void ee_finish(struct iss *m) {
+    if (!ENH(m)) {
+        m->eeprom[m->ram[M_EEADR] & 0x3Fu] = m->ram[M_EEDATA];
+        m->ram[M_EECON1] = (uint8_t)((m->ram[M_EECON1] & ~0x02u) | 0x10u);  // WR=0, EEIF
+    } else {
+        m->eeprom[m->ram[E_EEADRL]] = m->ram[E_EEDATL];
+        m->ram[E_EECON1] &= (uint8_t)~0x02u;
+        m->ram[E_PIR2]   |= 0x10u;                                          // EEIF
+    }
+    m->ee_done_ps = 0;
+}
+
+static void eecon1_write(struct iss *m, unsigned a, uint8_t v) {
+    uint8_t old = m->ram[a];
+
+    // WR/RD lassen sich nur setzen; EEIF (84A) / WRERR per Software
+    m->ram[a] = (uint8_t)((v & ~0x03u) | (old & 0x03u) | (v & 0x03u));
+    if (v & 0x01u) {                                                  // RD
+        if (!ENH(m)) {
+            m->ram[M_EEDATA] = m->eeprom[m->ram[M_EEADR] & 0x3Fu];
+        } else if (v & 0x80u) {                                       // EEPGD
+            uint16_t w = m->prog[(((unsigned)m->ram[E_EEADRH] << 8) | m->ram[E_EEADRL]) &
+                                 (m->flash_words - 1u)];
+            m->ram[E_EEDATL] = (uint8_t)w;
+            m->ram[E_EEDATH] = (uint8_t)(w >> 8);
+        } else {
+            m->ram[E_EEDATL] = m->eeprom[m->ram[E_EEADRL]];
+        }
+        m->ram[a] &= (uint8_t)~0x01u;
+    }
+    if ((v & 0x02u) && !(old & 0x02u)) {                              // WR
+        if ((v & 0x04u) && m->ee_unlock == 2u && !(ENH(m) && (v & 0x80u)))
+            m->ee_done_ps = m->now_ps + EE_WRITE_PS;
+        else
+            m->ram[a] &= (uint8_t)~0x02u;                             // Sequenz fehlt
+    }
+    m->ee_unlock = 0;
+}
+
+static void eecon2_write(struct iss *m, uint8_t v) {
+    if (v == 0x55u)                          m->ee_unlock = 1;
+    else if (v == 0xAAu && m->ee_unlock == 1u) m->ee_unlock = 2;
+    else                                     m->ee_unlock = 0;
+}
+
+// ─── FVR + ADC (1825) ─────────────────────────────────────────────────
+// Nur der Kanal FVR (CHS = 11111) liefert einen Wert: 1023 · FVR / VDD
+// bei VREF+ = VDD. FVRRDY gilt sofort; Wandlung = 11,5 TAD.
+static uint64_t adc_tad_ps(const struct iss *m) {
+    static const uint8_t div[8] = { 2, 8, 32, 0, 4, 16, 64, 0 };
+    uint8_t cs = (m->ram[E_ADCON1] >> 4) & 0x07u;
+    return div[cs] ? div[cs] * 1000000000000ull / m->fosc_hz : 1600000u;   // FRC ~1,6 µs
+}
+
+static void adc_finish(struct iss *m) {
+    uint8_t  fvr = m->ram[E_FVRCON];
+    uint16_t r   = 0;
+
+    if (((m->ram[E_ADCON0] >> 2) & 0x1Fu) == 0x1Fu && (fvr & 0x80u) && m->vdd_mv) {
+        uint32_t mv = 512u << (fvr & 0x03u);
+        r = mv >= m->vdd_mv ? 1023u : (uint16_t)(1023u * mv / m->vdd_mv);
+    }
+    if (m->ram[E_ADCON1] & 0x80u) {                                  // ADFM rechtsbündig
+        m->ram[E_ADRESH] = (uint8_t)(r >> 8);
+        m->ram[E_ADRESL] = (uint8_t)r;
+    } else {
+        m->ram[E_ADRESH] = (uint8_t)(r >> 2);
+        m->ram[E_ADRESL] = (uint8_t)(r << 6);
+    }
+    m->ram[E_ADCON0] &= (uint8_t)~0x02u;                             // GO/nDONE = 0
+    m->ram[E_PIR1]   |= 0x40u;                                       // ADIF
+    m->adc_done_ps = 0;
+}
+
+static void adcon0_write(struct iss *m, uint8_t v) {
+    m->ram[E_ADCON0] = v;
+    if (!(v & 0x01u)) {                                              // ADON = 0 bricht ab
+        m->ram[E_ADCON0] &= (uint8_t)~0x02u;
+        m->adc_done_ps = 0;
+    } else if ((v & 0x02u) && !m->adc_done_ps) {
+        m->adc_done_ps = m->now_ps + adc_tad_ps(m) * 23u / 2u;
+    }
+}
+
+// ─── Stack ────────────────────────────────────────────────────────────
+// 1 = Überlauf hat einen Reset ausgelöst (1825, STVREN)
+static int push(struct iss *m, uint16_t addr) {
+    if (m->sp >= m->stack_depth) {
+        m->stack_overflows++;
+        if (ENH(m) && (m->config[1] & 0x0200u)) { iss_reset(m, 0); return 1; }
+        m->sp = 0;                                    // sonst ringförmig
+    }
+    m->stack[m->sp++] = addr;
+    return 0;
+}
+
+static uint16_t pop(struct iss *m) {
+    if (!m->sp) m->sp = m->stack_depth;              // Unterlauf: ringförmig
+    return m->stack[--m->sp];
+}
+
+// ─── Profil ───────────────────────────────────────────────────────────
+static void frame_push(struct iss *m, int16_t fn) {
+    struct iss_frame *fr;
+
+    if (m->depth < ISS_SHADOW) {
+        fr       = &m->frames[m->depth];
+        fr->fn   = fn;
+        fr->cyc0 = m->cycles;
+        fr->isr0 = m->isr_cycles;
+        if (fn >= 0) m->fn[fn].calls++;
+    }
+    m->depth++;
+}
+
+// extra: Zyklen des Rücksprungs, die advance() erst noch zählt
+static void frame_pop(struct iss *m, unsigned extra) {
+    struct iss_frame *fr;
+    uint64_t incl;
+
+    if (!m->depth) return;
+    m->depth--;
+    if (m->depth >= ISS_SHADOW) return;
+    fr = &m->frames[m->depth];
+    if (fr->fn < 0) return;
+    incl = m->cycles + extra - fr->cyc0;
+    if (!m->in_isr) incl -= m->isr_cycles - fr->isr0;      // ISR zählt für sich
+    m->fn[fr->fn].incl += incl;
+    m->fn[fr->fn].rets++;
+    if (incl > m->fn[fr->fn].max_incl) m->fn[fr->fn].max_incl = incl;
+}
+
+static int16_t self_fn(const struct iss *m) {
+    unsigned d = m->depth < ISS_SHADOW ? m->depth : ISS_SHADOW;
+    while (d--) if (m->frames[d].fn >= 0) return m->frames[d].fn;
+    return 0;
+}
+
+int iss_add_symbol(struct iss *m, const char *name, uint16_t addr) {
+    struct iss_fn *f;
+
+    if (addr >= m->flash_words || m->n_fn >= ISS_MAX_FN) return -1;
+    if (m->fn_at[addr] > 0) return m->fn_at[addr];
+    f = &m->fn[m->n_fn];
+    memset(f, 0, sizeof *f);
+    snprintf(f->name, sizeof f->name, "%s", name);
+    f->addr = addr;
+    m->fn_at[addr] = (int16_t)m->n_fn;
+    if (addr == 0x0004u) m->fn_at_vector = (int16_t)m->n_fn;
+    if (!strcmp(name, "main")) m->fn_main = (int16_t)m->n_fn;
+    return (int)m->n_fn++;
+}
+
+// ─── Datenspeicher: Zugriff ───────────────────────────────────────────
+static uint8_t rd(struct iss *m, unsigned a);
+static void    wr(struct iss *m, unsigned a, uint8_t v);
+
+static uint16_t fsr16(const struct iss *m, unsigned n) {
+    return (uint16_t)(m->ram[E_FSR0L + 2u * n] | (m->ram[E_FSR0L + 1u + 2u * n] << 8));
+}
+
+// 1825: FSR → Bank-Adresse, −1 = Programmspeicher, −2 = nichts
+static int fsr_target(uint16_t fsr) {
+    if (fsr < 0x1000u) return fsr;
+    if (fsr >= 0x2000u && fsr < 0x29B0u) {
+        unsigned n = fsr - 0x2000u;
+        return (int)(((n / 80u) << 7) | (0x20u + n % 80u));
+    }
+    if (fsr >= 0x8000u) return -1;
+    return -2;
+}
+
+static uint8_t ind_rd(struct iss *m, uint16_t fsr) {
+    int a;
+
+    if (!ENH(m)) {
+        a = ((fsr & 0x80u) ? 0x80 : 0) | (fsr & 0x7Fu);
+        return (m->alias[a] == R_INDF) ? 0u : rd(m, (unsigned)a);
+    }
+    a = fsr_target(fsr);
+    if (a == -1) {
+        m->extra++;
+        return (uint8_t)m->prog[(fsr & 0x7FFFu) & (m->flash_words - 1u)];
+    }
+    if (a < 0 || m->alias[a] <= E_INDF1) return 0;
+    return rd(m, (unsigned)a);
+}
+
+static void ind_wr(struct iss *m, uint16_t fsr, uint8_t v) {
+    int a;
+
+    if (!ENH(m)) {
+        a = ((fsr & 0x80u) ? 0x80 : 0) | (fsr & 0x7Fu);
+        if (m->alias[a] != R_INDF) wr(m, (unsigned)a, v);
+        return;
+    }
+    a = fsr_target(fsr);
+    if (a >= 0 && m->alias[a] > E_INDF1) wr(m, (unsigned)a, v);
+}
+
+static uint8_t rd_sfr(struct iss *m, unsigned a) {
+    if (m->kind[a] == K_NONE) return 0;
+    switch (a) {
+    case R_INDF:   return ind_rd(m, ENH(m) ? fsr16(m, 0) : m->ram[M_FSR]);
+    case R_PCL:    return (uint8_t)m->pc;
+    }
+    if (!ENH(m)) {
+        switch (a) {
+        case M_PORTA:  return m->pins[0];
+        case M_PORTB:  m->rb_seen = m->pins[1]; return m->pins[1];
+        }
+        return m->ram[a];
+    }
+    switch (a) {
+    case E_INDF1:  return ind_rd(m, fsr16(m, 1));
+    case E_BSR:    return m->bsr;
+    case E_WREG:   return m->w;
+    case R_INTCON: return (uint8_t)((m->ram[R_INTCON] & ~IC_RBIF) | (m->ram[E_IOCAF] ? IC_RBIF : 0u));
+    case E_PORTA:  return m->pins[0] & (uint8_t)~m->ram[E_ANSELA];
+    case E_PORTC:  return m->pins[1] & (uint8_t)~m->ram[E_ANSELC];
+    case E_OSCSTAT: return 0x5Fu;                   // alle Oszillatoren bereit
+    case E_STKPTR: return m->sp;
+    case E_TOSL:   return m->sp ? (uint8_t)m->stack[m->sp - 1u] : 0u;
+    case E_TOSH:   return m->sp ? (uint8_t)(m->stack[m->sp - 1u] >> 8) : 0u;
+    }
+    return m->ram[a];
+}
+
+static void wr_sfr(struct iss *m, unsigned a, uint8_t v) {
+    if (m->kind[a] == K_NONE) return;
+    switch (a) {
+    case R_INDF:
+        ind_wr(m, ENH(m) ? fsr16(m, 0) : m->ram[M_FSR], v);
+        return;
+    case R_PCL:
+        m->pc = (uint16_t)(((m->ram[R_PCLATH] << 8) | v) & m->pc_mask);
+        m->extra++;
+        return;
+    case R_STATUS: {
+        uint8_t keep = ST_NTO | ST_NPD | (ENH(m) ? 0xE0u : 0u);
+        m->ram[a] = (uint8_t)((m->ram[a] & keep) | (v & ~keep));
+        return;
+    }
+    }
+    if (!ENH(m)) {
+        switch (a) {
+        case M_TMR0:
+            m->ram[a] = v;
+            m->t0_acc = 0;
+            m->t0_inhibit = 3;                      // dieser + 2 folgende Tcy
+            return;
+        case M_PORTA: case M_PORTB:
+            m->ram[a] = v;
+            pins_update(m);
+            if (a == M_PORTB) m->rb_seen = m->pins[1];
+            return;
+        case M_TRISA: case M_TRISB:
+            m->ram[a] = v;
+            pins_update(m);
+            return;
+        case M_OPTION:
+            m->ram[a] = v;
+            option_changed(m);
+            wdt_update(m);
+            pins_update(m);
+            return;
+        case R_INTCON:
+            m->ram[a] = v;
+            pins_update(m);                         // Mismatch setzt RBIF sofort wieder
+            return;
+        case M_EECON1: eecon1_write(m, a, v); return;
+        case M_EECON2: eecon2_write(m, v);    return;
+        }
+        m->ram[a] = v;
+        return;
+    }
+    switch (a) {
+    case E_INDF1:  ind_wr(m, fsr16(m, 1), v); return;
+    case E_BSR:    m->bsr = v & 0x1Fu;        return;
+    case E_WREG:   m->w   = v;                return;
+    case R_INTCON: m->ram[a] = (uint8_t)((v & ~IC_RBIF) | (m->ram[a] & IC_RBIF)); return;
+    case E_PORTA:  a = E_LATA; break;           // PORTx schreiben → LATx
+    case E_PORTC:  a = E_LATC; break;
+    case E_TMR0:
+        m->ram[a] = v;
+        m->t0_acc = 0;
+        m->t0_inhibit = 3;
+        return;
+    case E_T1CON:  m->ram[a] = v; t1_changed(m); return;
+    case E_T2CON:  m->ram[a] = v; t2_changed(m); return;
+    case E_OPTION:
+        m->ram[a] = v;
+        option_changed(m);
+        pins_update(m);
+        return;
+    case E_WDTCON: m->ram[a] = v; wdt_update(m);   return;
+    case E_OSCCON: m->ram[a] = v; osccon_1825(m);  return;
+    case E_OSCSTAT: return;
+    case E_ADCON0: adcon0_write(m, v); return;
+    case E_EECON1: eecon1_write(m, a, v); return;
+    case E_EECON2: eecon2_write(m, v);    return;
+    case E_STKPTR: m->sp = v & 0x1Fu;     return;
+    case E_TOSL:   if (m->sp) m->stack[m->sp - 1u] = (uint16_t)((m->stack[m->sp - 1u] & 0x7F00u) | v); return;
+    case E_TOSH:   if (m->sp) m->stack[m->sp - 1u] = (uint16_t)((m->stack[m->sp - 1u] & 0x00FFu) | ((v & 0x7Fu) << 8)); return;
+    }
+    m->ram[a] = v;                               // LAT, TRIS, ANSEL, WPU
+    pins_update(m);
+}
+
+static inline uint8_t rd(struct iss *m, unsigned a) {
+    a = m->alias[a];
+    return m->kind[a] == K_RAM ? m->ram[a] : rd_sfr(m, a);
+}
+
+static inline void wr(struct iss *m, unsigned a, uint8_t v) {
+    a = m->alias[a];
+    if (m->kind[a] == K_RAM) m->ram[a] = v;
+    else                     wr_sfr(m, a, v);
+}
+
+// ─── Dekoder ──────────────────────────────────────────────────────────
+static struct iss_insn decode(const struct iss *m, uint16_t x) {
+    struct iss_insn in = { OP_ILLEGAL, 0, 0 };
+    uint8_t sub = (x >> 8) & 0x0Fu;
+
+    x &= 0x3FFFu;
+    switch (x >> 12) {
+    case 0: {
+        static const uint8_t byte_op[16] = {
+            OP_MOVWF, OP_CLRF, OP_SUBWF, OP_DECF, OP_IORWF, OP_ANDWF, OP_XORWF, OP_ADDWF,
+            OP_MOVF, OP_COMF, OP_INCF, OP_DECFSZ, OP_RRF, OP_RLF, OP_SWAPF, OP_INCFSZ,
+        };
+        in.d = (x >> 7) & 1u;
+        in.k = x & 0x7Fu;
+        if (sub == 1u) { in.op = in.d ? OP_CLRF : OP_CLRW; break; }
+        if (sub || in.d) { in.op = byte_op[sub]; break; }
+        // 00 0000 0xxx xxxx: Steuerbefehle
+        if (x == 0x0008u)                         in.op = OP_RETURN;
+        else if (x == 0x0009u)                    in.op = OP_RETFIE;
+        else if (x == 0x0062u)                    in.op = OP_OPTION;
+        else if (x == 0x0063u)                    in.op = OP_SLEEP;
+        else if (x == 0x0064u)                    in.op = OP_CLRWDT;
+        else if (x >= 0x0065u && x <= 0x0067u)  { in.op = OP_TRIS; in.k = x & 0x07u; }
+        else if (!ENH(m))                         in.op = (x & 0x1Fu) ? OP_ILLEGAL : OP_NOP;
+        else if (x == 0x0000u)                    in.op = OP_NOP;
+        else if (x == 0x0001u)                    in.op = OP_RESET;
+        else if (x == 0x000Au)                    in.op = OP_CALLW;
+        else if (x == 0x000Bu)                    in.op = OP_BRW;
+        else if ((x & 0x7FF8u) == 0x0010u)      { in.op = OP_MOVIW; in.d = (x >> 2) & 1u; in.k = x & 3u; }
+        else if ((x & 0x7FF8u) == 0x0018u)      { in.op = OP_MOVWI; in.d = (x >> 2) & 1u; in.k = x & 3u; }
+        else if ((x & 0x7FE0u) == 0x0020u)      { in.op = OP_MOVLB; in.k = x & 0x1Fu; }
+        break;
+    }
+    case 1:
+        in.op = (uint8_t)(OP_BCF + ((x >> 10) & 3u));
+        in.d  = (x >> 7) & 7u;
+        in.k  = x & 0x7Fu;
+        break;
+    case 2:
+        in.op = (x & 0x0800u) ? OP_GOTO : OP_CALL;
+        in.k  = x & 0x07FFu;
+        break;
+    case 3:
+        in.k = x & 0xFFu;
+        if (!ENH(m)) {
+            if (sub < 4u)       in.op = OP_MOVLW;
+            else if (sub < 8u)  in.op = OP_RETLW;
+            else if (sub == 8u) in.op = OP_IORLW;
+            else if (sub == 9u) in.op = OP_ANDLW;
+            else if (sub == 10u) in.op = OP_XORLW;
+            else if (sub >= 12u && sub < 14u) in.op = OP_SUBLW;
+            else if (sub >= 14u) in.op = OP_ADDLW;
+            break;
+        }
+        switch (sub) {
+        case 0:  in.op = OP_MOVLW; break;
+        case 1:
+            if (x & 0x80u) { in.op = OP_MOVLP; in.k = x & 0x7Fu; }
+            else           { in.op = OP_ADDFSR; in.d = (x >> 6) & 1u; in.k = x & 0x3Fu; }
+            break;
+        case 2: case 3: in.op = OP_BRA; in.k = x & 0x01FFu; break;
+        case 4:  in.op = OP_RETLW; break;
+        case 5:  in.op = OP_LSLF;   in.d = (x >> 7) & 1u; in.k = x & 0x7Fu; break;
+        case 6:  in.op = OP_LSRF;   in.d = (x >> 7) & 1u; in.k = x & 0x7Fu; break;
+        case 7:  in.op = OP_ASRF;   in.d = (x >> 7) & 1u; in.k = x & 0x7Fu; break;
+        case 8:  in.op = OP_IORLW; break;
+        case 9:  in.op = OP_ANDLW; break;
+        case 10: in.op = OP_XORLW; break;
+        case 11: in.op = OP_SUBWFB; in.d = (x >> 7) & 1u; in.k = x & 0x7Fu; break;
+        case 12: in.op = OP_SUBLW; break;
+        case 13: in.op = OP_ADDWFC; in.d = (x >> 7) & 1u; in.k = x & 0x7Fu; break;
+        case 14: in.op = OP_ADDLW; break;
+        case 15:
+            in.op = (x & 0x80u) ? OP_MOVWIK : OP_MOVIWK;
+            in.d  = (x >> 6) & 1u;
+            in.k  = x & 0x3Fu;
+            break;
+        }
+        break;
+    }
+    return in;
+}
+
+static void predecode(struct iss *m) {
+    unsigned a;
+    for (a = 0; a < m->flash_words; a++) m->code[a] = decode(m, m->prog[a]);
+}
+
+// ─── Init / Reset ─────────────────────────────────────────────────────
+int iss_init(struct iss *m, enum iss_chip chip, uint32_t fosc_hz) {
+    unsigned a;
+
+    memset(m, 0, sizeof *m);
+    m->chip        = chip;
+    m->flash_words = chip == ISS_16F84A ? 1024u : 8192u;
+    m->pc_mask     = (uint16_t)(m->flash_words - 1u);
+    m->stack_depth = chip == ISS_16F84A ? 8u : 16u;
+    m->lfintosc_hz = 31000u;
+    m->vdd_mv      = 3000u;
+    m->config[0]   = m->config[1] = 0x3FFFu;        // gelöscht
+    m->btn_port    = chip == ISS_16F84A ? 1u : 0u;  // RB7 bzw. RA4
+    m->btn_bit     = chip == ISS_16F84A ? 7u : 4u;
+    for (a = 0; a < 8192u; a++) m->prog[a] = 0x3FFFu;
+    memset(m->eeprom, 0xFF, sizeof m->eeprom);
+    for (a = 0; a < 8192u; a++) m->fn_at[a] = -1;
+    build_map(m);
+    predecode(m);
+    set_fosc(m, fosc_hz ? fosc_hz : 4000000u);
+    m->fn_at_vector = -1;
+    m->fn_main      = -1;
+    iss_add_symbol(m, "(ohne Symbol)", (uint16_t)(m->flash_words - 1u));
+    m->fn_at[m->flash_words - 1u] = -1;               // nur Sammelposten
+    iss_reset(m, 1);
+    return 0;
+}
+
+void iss_reset(struct iss *m, int por) {
+    uint32_t fosc = m->fosc_hz;
+
+    m->pc = 0; m->sp = 0; m->w = 0; m->bsr = 0;
+    m->sleeping = 0; m->irq_hold = 0; m->halted = 0;
+    m->depth = 0; m->in_isr = 0; m->main_seen = 0;
+    m->ram[R_PCLATH] = 0;
+    m->ram[R_INTCON] &= ENH(m) ? 0x00u : 0x01u;
+    if (por) ST(m) = 0x18u;
+    else     ST(m) = (uint8_t)((ST(m) & 0x07u) | ST_NPD);   // nTO per Aufrufer
+    m->ee_unlock = 0;
+
+    if (!ENH(m)) {
+        m->ram[M_OPTION] = 0xFFu;
+        m->ram[M_TRISA]  = 0x1Fu;
+        m->ram[M_TRISB]  = 0xFFu;
+        m->ram[M_EECON1] &= 0x08u;
+        set_fosc(m, fosc);
+    } else {
+        m->ram[E_OPTION] = 0xFFu;
+        m->ram[E_TRISA]  = 0x3Fu; m->ram[E_TRISC]  = 0x3Fu;
+        m->ram[E_ANSELA] = 0x17u; m->ram[E_ANSELC] = 0x0Fu;
+        m->ram[E_WPUA]   = 0x3Fu; m->ram[E_WPUC]   = 0x3Fu;
+        m->ram[E_IOCAP]  = m->ram[E_IOCAN] = m->ram[E_IOCAF] = 0;
+        m->ram[E_PIE1]   = m->ram[E_PIE2]  = m->ram[E_PIE3]  = 0;
+        m->ram[E_PIR1]   = m->ram[E_PIR2]  = m->ram[E_PIR3]  = 0;
+        m->ram[E_T1CON]  = m->ram[E_T2CON] = 0;
+        m->ram[E_TMR2]   = 0; m->ram[E_PR2] = 0xFFu;
+        m->ram[E_WDTCON] = 0x16u;
+        m->ram[E_OSCCON] = 0x38u;                  // 500 kHz MFINTOSC
+        m->ram[E_EECON1] = 0;
+        if (por) { m->ram[E_LATA] = m->ram[E_LATC] = 0; }
+        t1_changed(m);
+        t2_changed(m);
+        osccon_1825(m);
+    }
+    option_changed(m);
+    m->t0_acc = 0; m->t0_inhibit = 0;
+    m->t1_acc = 0; m->t2_acc = 0; m->t2_post = 0;
+    m->wdt_on = 0;
+    wdt_update(m);
+    wdt_clear(m);
+    m->ee_done_ps = 0;
+    m->adc_done_ps = 0;
+    if (ENH(m)) m->ram[E_ADCON0] = m->ram[E_ADCON1] = m->ram[E_FVRCON] = 0;
+    pins_update(m);
+    m->rb_seen = m->pins[1];
+}
+
+// ─── HEX / Map laden ──────────────────────────────────────────────────
+static int hexbyte(const char *s) {
+    int v = 0, k;
+    for (k = 0; k < 2; k++) {
+        int c = s[k];
+        v <<= 4;
+        if (c >= '0' && c <= '9')      v |= c - '0';
+        else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+static void store_byte(struct iss *m, uint32_t addr, uint8_t b) {
+    uint32_t word = addr >> 1;
+    uint16_t *p   = NULL;
+
+    if (word < m->flash_words)                          p = &m->prog[word];
+    else if (!ENH(m) && word == 0x2007u)                p = &m->config[0];
+    else if (ENH(m) && (word == 0x8007u || word == 0x8008u)) p = &m->config[word - 0x8007u];
+    else if (!ENH(m) && word >= 0x2100u && word < 0x2140u) {
+        if (!(addr & 1u)) m->eeprom[word - 0x2100u] = b;
+        return;
+    } else if (ENH(m) && word >= 0xF000u && word < 0xF100u) {
+        if (!(addr & 1u)) m->eeprom[word - 0xF000u] = b;
+        return;
+    }
+    if (!p) return;
+    if (addr & 1u) *p = (uint16_t)((*p & 0x00FFu) | ((b & 0x3Fu) << 8));
+    else           *p = (uint16_t)((*p & 0x3F00u) | b);
+}
+
+int iss_load_hex(struct iss *m, const char *path) {
+    FILE    *f = fopen(path, "r");
+    char     line[600];
+    uint32_t base = 0;
+    int      lineno = 0;
+
+    if (!f) return -1;
+    while (fgets(line, sizeof line, f)) {
+        int n, addr, type, k, sum = 0, b;
+        lineno++;
+        if (line[0] != ':') continue;
+        if ((n = hexbyte(line + 1)) < 0) goto bad;
+        for (k = 0; k < n + 5; k++) {
+            if ((b = hexbyte(line + 1 + 2 * k)) < 0) goto bad;
+            sum += b;
+        }
+        if (sum & 0xFF) goto bad;
+        addr = (hexbyte(line + 3) << 8) | hexbyte(line + 5);
+        type = hexbyte(line + 7);
+        if (type == 0) {
+            for (k = 0; k < n; k++)
+                store_byte(m, base + (uint32_t)addr + (uint32_t)k, (uint8_t)hexbyte(line + 9 + 2 * k));
+        } else if (type == 1) {
+            break;
+        } else if (type == 2) {
+            base = (uint32_t)((hexbyte(line + 9) << 8) | hexbyte(line + 11)) << 4;
+        } else if (type == 4) {
+            base = (uint32_t)((hexbyte(line + 9) << 8) | hexbyte(line + 11)) << 16;
+        }
+    }
+    fclose(f);
+    predecode(m);
+    iss_reset(m, 1);
+    return 0;
+bad:
+    fprintf(stderr, "%s:%d: ungültiger HEX-Datensatz\n", path, lineno);
+    fclose(f);
+    return -1;
+}
+
+// XC8-Map: Abschnitt „Symbol Table“, Zeilen  _name  psect  ADRESSE.
+// Ohne diesen Abschnitt: jede Zeile „name adresse“ (hex).
+static int code_psect(const char *ps) {
+    static const char *ram[] = {
+        "COMMON", "BANK", "bss", "data", "nv", "cstack", "stack", "RAM",
+        "SFR", "eeData", "config", "idloc", "abs",
+    };
+    unsigned k;
+    for (k = 0; k < sizeof ram / sizeof ram[0]; k++)
+        if (strstr(ps, ram[k])) return 0;
+    return 1;
+}
+
+int iss_load_map(struct iss *m, const char *path) {
+    FILE *f = fopen(path, "r");
+    char  line[512], a[128], b[128], c[128];
+    int   in_tab = 0, any_tab = 0, n = 0;
+
+    if (!f) return -1;
+    while (fgets(line, sizeof line, f)) {
+        if (strstr(line, "Symbol Table")) { in_tab = any_tab = 1; continue; }
+        if (!in_tab) continue;
+        if (sscanf(line, "%127s %127s %127s", a, b, c) == 3 && a[0] == '_' &&
+            strspn(c, "0123456789ABCDEFabcdef") == strlen(c) && code_psect(b)) {
+            if (iss_add_symbol(m, a + 1, (uint16_t)strtoul(c, NULL, 16)) >= 0) n++;
+        }
+    }
+    if (!any_tab) {
+        rewind(f);
+        while (fgets(line, sizeof line, f))
+            if (sscanf(line, "%127s %127s", a, b) == 2 &&
+                strspn(b, "0123456789ABCDEFabcdefx") == strlen(b) &&
+                iss_add_symbol(m, a[0] == '_' ? a + 1 : a, (uint16_t)strtoul(b, NULL, 16)) >= 0)
+                n++;
+    }
+    fclose(f);
+    return n;
+}
+
+// ─── Taster-Skript ────────────────────────────────────────────────────
+static void add_edge(struct iss *m, uint64_t t_ps, uint8_t pressed) {
+    size_t k;
+
+    if (m->n_edges == m->cap_edges) {
+        m->cap_edges = m->cap_edges ? m->cap_edges * 2u : 16u;
+        m->edges     = realloc(m->edges, m->cap_edges * sizeof *m->edges);
+        if (!m->edges) { perror("realloc"); exit(1); }
+    }
+    k = m->n_edges++;
+    while (k > m->next_edge && m->edges[k - 1u].t_ps > t_ps) {
+        m->edges[k] = m->edges[k - 1u];
+        k--;
+    }
+    m->edges[k].t_ps    = t_ps;
+    m->edges[k].pressed = pressed;
+}
+
+void iss_press(struct iss *m, uint64_t t_ps, uint64_t hold_ps) {
+    add_edge(m, t_ps, 1);
+    add_edge(m, t_ps + hold_ps, 0);
+}
+
+// ─── Zeit ─────────────────────────────────────────────────────────────
+// Nächstes zeitgesteuertes Ereignis (Taster, WDT, EEPROM, ADC)
+static uint64_t next_event(const struct iss *m) {
+    uint64_t t = UINT64_MAX;
+
+    if (m->next_edge < m->n_edges) t = m->edges[m->next_edge].t_ps;
+    if (m->wdt_on && m->wdt_start_ps + m->wdt_period_ps < t) t = m->wdt_start_ps + m->wdt_period_ps;
+    if (m->ee_done_ps && m->ee_done_ps < t) t = m->ee_done_ps;
+    if (m->adc_done_ps && m->adc_done_ps < t) t = m->adc_done_ps;
+    return t;
+}
+
+// Ereignisse bis now_ps abarbeiten; 1 = WDT abgelaufen
+static int events(struct iss *m) {
+    int wdt = 0;
+
+    while (m->next_edge < m->n_edges && m->edges[m->next_edge].t_ps <= m->now_ps) {
+        m->btn_pressed = m->edges[m->next_edge++].pressed;
+        pins_update(m);
+    }
+    if (m->ee_done_ps && m->ee_done_ps <= m->now_ps) ee_finish(m);
+    if (m->adc_done_ps && m->adc_done_ps <= m->now_ps) adc_finish(m);
+    if (m->wdt_on && m->wdt_start_ps + m->wdt_period_ps <= m->now_ps) {
+        wdt = 1;
+        wdt_clear(m);
+    }
+    return wdt;
+}
+
+// Timer1 mit Zeitbasis (LFINTOSC, T1OSC) um dt_ps weiterzählen
+static void t1_time(struct iss *m, uint64_t dt_ps) {
+    uint64_t tick = t1_tick_ps(m), n;
+    m->t1_lf_ps += dt_ps;
+    n = m->t1_lf_ps / tick;
+    m->t1_lf_ps -= n * tick;
+    if (n) t1_count(m, n);
+}
+
+// Zeitpunkt des nächsten Timer1-Überlaufs im SLEEP (asynchron)
+static uint64_t t1_overflow_ps(const struct iss *m) {
+    uint32_t t = (uint32_t)m->ram[E_TMR1L] | ((uint32_t)m->ram[E_TMR1H] << 8);
+    return m->now_ps + (0x10000u - t) * t1_tick_ps(m) - m->t1_lf_ps;
+}
+
+static int t1_runs_asleep(const struct iss *m) {
+    return ENH(m) && m->t1_on && m->t1_src >= 2u && (m->ram[E_T1CON] & 0x04u);
+}
+
+static void wdt_timeout_awake(struct iss *m) {
+    m->wdt_resets++;
+    iss_reset(m, 0);
+    ST(m) &= (uint8_t)~ST_NTO;
+}
+
+// SLEEP: bis zum nächsten Weck-Ereignis springen
+static void sleep_step(struct iss *m, uint64_t until_ps) {
+    uint64_t t = next_event(m), t0 = m->now_ps;
+    int      wdt;
+
+    if (t1_runs_asleep(m) && t1_overflow_ps(m) < t) t = t1_overflow_ps(m);
+    m->halted = t == UINT64_MAX;                      // nichts kann mehr wecken
+    if (t > until_ps) t = until_ps;
+    if (t < m->now_ps) t = m->now_ps;
+    if (t1_runs_asleep(m)) t1_time(m, t - t0);
+    m->now_ps    = t;
+    m->sleep_ps += t - t0;
+
+    wdt = events(m);
+    if (wdt) {
+        m->wdt_wakes++;
+        ST(m) &= (uint8_t)~ST_NTO;                   // WDT-Wake: nTO = 0
+    }
+    if (wdt || wake_pending(m)) {
+        m->sleeping = 0;
+        m->irq_hold = 1;                              // Befehl nach SLEEP zuerst
+        wdt_update(m);
+        wdt_clear(m);
+    }
+}
+
+static inline void advance(struct iss *m, unsigned c) {
+    m->cycles    += c;
+    m->now_ps    += c * m->tcy_ps;
+    m->active_ps += c * m->tcy_ps;
+    if (m->in_isr) m->isr_cycles += c;
+
+    if (m->t0_on) {
+        unsigned n = c;
+        if (m->t0_inhibit) {
+            unsigned s = n < m->t0_inhibit ? n : m->t0_inhibit;
+            m->t0_inhibit -= (uint8_t)s;
+            n -= s;
+        }
+        m->t0_acc += n;
+        while (m->t0_acc >= m->t0_div) {
+            unsigned a = ENH(m) ? E_TMR0 : M_TMR0;
+            m->t0_acc -= m->t0_div;
+            if (!++m->ram[a]) m->ram[R_INTCON] |= IC_T0IF;
+        }
+    }
+    if (m->t2_on) {
+        m->t2_acc += c;
+        while (m->t2_acc >= m->t2_div) {
+            m->t2_acc -= m->t2_div;
+            if (m->ram[E_TMR2] == m->ram[E_PR2]) {
+                m->ram[E_TMR2] = 0;
+                if (++m->t2_post > ((m->ram[E_T2CON] >> 3) & 0x0Fu)) {
+                    m->t2_post = 0;
+                    m->ram[E_PIR1] |= 0x02u;          // TMR2IF
+                }
+            } else {
+                m->ram[E_TMR2]++;
+            }
+        }
+    }
+    if (m->t1_on) {
+        if (m->t1_src >= 2u) {
+            t1_time(m, (uint64_t)c * m->tcy_ps);
+        } else {
+            m->t1_acc += m->t1_src ? 4u * c : c;
+            if (m->t1_acc >= m->t1_div) {
+                t1_count(m, m->t1_acc / m->t1_div);
+                m->t1_acc %= m->t1_div;
+            }
+        }
+    }
+}
+
+// ─── Flag-Helfer ──────────────────────────────────────────────────────
+static inline void set_z(struct iss *m, uint8_t r) {
+    ST(m) = (uint8_t)((ST(m) & ~ST_Z) | (r ? 0u : ST_Z));
+}
+
+// a + b + cin → C, DC, Z
+static inline uint8_t add8(struct iss *m, uint8_t a, uint8_t b, unsigned cin) {
+    unsigned r  = a + b + cin;
+    unsigned dc = (a & 0x0Fu) + (b & 0x0Fu) + cin;
+    uint8_t  st = ST(m) & (uint8_t)~(ST_C | ST_DC | ST_Z);
+    if (r > 0xFFu)     st |= ST_C;
+    if (dc > 0x0Fu)    st |= ST_DC;
+    if (!(r & 0xFFu))  st |= ST_Z;
+    ST(m) = st;
+    return (uint8_t)r;
+}
+
+// ─── Ausführen ────────────────────────────────────────────────────────
+static void take_irq(struct iss *m) {
+    if (ENH(m)) {
+        m->ram[E_SHAD + 0] = ST(m) & 0x07u;
+        m->ram[E_SHAD + 1] = m->w;
+        m->ram[E_SHAD + 2] = m->bsr;
+        m->ram[E_SHAD + 3] = m->ram[R_PCLATH];
+        memcpy(&m->ram[E_SHAD + 4], &m->ram[E_FSR0L], 4);
+    }
+    if (push(m, m->pc)) return;
+    m->ram[R_INTCON] &= (uint8_t)~IC_GIE;
+    m->pc = 0x0004u;
+    m->irqs++;
+    m->in_isr = 1;
+    frame_push(m, m->fn_at_vector);
+    advance(m, 2);
+}
+
+uint64_t iss_main_cycles(const struct iss *m) {
+    if (!m->main_seen) return 0;
+    return (m->cycles - m->main_cyc0) - (m->isr_cycles - m->main_isr0);
+}
+
+uint64_t iss_run(struct iss *m, uint64_t until_ps) {
+    uint64_t start = m->insns;
+    int16_t  cur_fn = self_fn(m);
+    uint16_t main_addr = m->fn_main >= 0 ? m->fn[m->fn_main].addr : 0xFFFFu;
+
+    while (m->now_ps < until_ps) {
+        const struct iss_insn *in;
+        unsigned c = 1, a;
+        uint8_t  v, r;
+        int16_t  sfn;                               // Befehl zählt „selbst“ hier
+
+        if (m->sleeping) {
+            sleep_step(m, until_ps);
+            if (m->sleeping && m->now_ps >= until_ps) break;
+            continue;
+        }
+        if (m->pc == main_addr && !m->main_seen && !m->in_isr) {
+            m->main_seen = 1;
+            m->main_cyc0 = m->cycles;
+            m->main_isr0 = m->isr_cycles;
+            frame_push(m, m->fn_main);
+            cur_fn = m->fn_main;
+        }
+
+        sfn = cur_fn;
+        in = &m->code[m->pc];
+        m->pc = (uint16_t)((m->pc + 1u) & m->pc_mask);
+        m->extra = 0;
+        a = ENH(m) ? ((unsigned)m->bsr << 7) | in->k
+                   : ((ST(m) & ST_RP0) ? 0x80u : 0u) | in->k;
+
+#define DEST(val) do { if (in->d) wr(m, a, (val)); else m->w = (val); } while (0)
+
+        switch (in->op) {
+        case OP_NOP:    break;
+        case OP_MOVWF:  wr(m, a, m->w); break;
+        case OP_CLRF:   wr(m, a, 0); set_z(m, 0); break;
+        case OP_CLRW:   m->w = 0; set_z(m, 0); break;
+        case OP_MOVF:   v = rd(m, a); DEST(v); set_z(m, v); break;
+        case OP_COMF:   r = (uint8_t)~rd(m, a); DEST(r); set_z(m, r); break;
+        case OP_INCF:   r = (uint8_t)(rd(m, a) + 1u); DEST(r); set_z(m, r); break;
+        case OP_DECF:   r = (uint8_t)(rd(m, a) - 1u); DEST(r); set_z(m, r); break;
+        case OP_ANDWF:  r = rd(m, a) & m->w; DEST(r); set_z(m, r); break;
+        case OP_IORWF:  r = rd(m, a) | m->w; DEST(r); set_z(m, r); break;
+        case OP_XORWF:  r = rd(m, a) ^ m->w; DEST(r); set_z(m, r); break;
+        case OP_SWAPF:  v = rd(m, a); r = (uint8_t)((v << 4) | (v >> 4)); DEST(r); break;
+        case OP_ADDWF:  v = rd(m, a); r = add8(m, v, m->w, 0); DEST(r); break;
+        case OP_ADDWFC: v = rd(m, a); r = add8(m, v, m->w, ST(m) & ST_C); DEST(r); break;
+        case OP_SUBWF:  v = rd(m, a); r = add8(m, v, (uint8_t)~m->w, 1); DEST(r); break;
+        case OP_SUBWFB: v = rd(m, a); r = add8(m, v, (uint8_t)~m->w, ST(m) & ST_C); DEST(r); break;
+        case OP_RLF:
+            v = rd(m, a); r = (uint8_t)((v << 1) | (ST(m) & ST_C));
+            DEST(r); ST(m) = (uint8_t)((ST(m) & ~ST_C) | (v >> 7));
+            break;
+        case OP_RRF:
+            v = rd(m, a); r = (uint8_t)((v >> 1) | ((ST(m) & ST_C) << 7));
+            DEST(r); ST(m) = (uint8_t)((ST(m) & ~ST_C) | (v & 1u));
+            break;
+        case OP_LSLF:
+            v = rd(m, a); r = (uint8_t)(v << 1);
+            DEST(r); ST(m) = (uint8_t)((ST(m) & ~ST_C) | (v >> 7)); set_z(m, r);
+            break;
+        case OP_LSRF:
+            v = rd(m, a); r = (uint8_t)(v >> 1);
+            DEST(r); ST(m) = (uint8_t)((ST(m) & ~ST_C) | (v & 1u)); set_z(m, r);
+            break;
+        case OP_ASRF:
+            v = rd(m, a); r = (uint8_t)((v >> 1) | (v & 0x80u));
+            DEST(r); ST(m) = (uint8_t)((ST(m) & ~ST_C) | (v & 1u)); set_z(m, r);
+            break;
+        case OP_DECFSZ: r = (uint8_t)(rd(m, a) - 1u); DEST(r); if (!r) { m->pc = (m->pc + 1u) & m->pc_mask; c = 2; } break;
+        case OP_INCFSZ: r = (uint8_t)(rd(m, a) + 1u); DEST(r); if (!r) { m->pc = (m->pc + 1u) & m->pc_mask; c = 2; } break;
+
+        case OP_BCF:    wr(m, a, (uint8_t)(rd(m, a) & ~(1u << in->d))); break;
+        case OP_BSF:    wr(m, a, (uint8_t)(rd(m, a) |  (1u << in->d))); break;
+        case OP_BTFSC:  if (!(rd(m, a) & (1u << in->d))) { m->pc = (m->pc + 1u) & m->pc_mask; c = 2; } break;
+        case OP_BTFSS:  if (  rd(m, a) & (1u << in->d))  { m->pc = (m->pc + 1u) & m->pc_mask; c = 2; } break;
+
+        case OP_MOVLW:  m->w = (uint8_t)in->k; break;
+        case OP_ANDLW:  m->w &= (uint8_t)in->k; set_z(m, m->w); break;
+        case OP_IORLW:  m->w |= (uint8_t)in->k; set_z(m, m->w); break;
+        case OP_XORLW:  m->w ^= (uint8_t)in->k; set_z(m, m->w); break;
+        case OP_ADDLW:  m->w = add8(m, m->w, (uint8_t)in->k, 0); break;
+        case OP_SUBLW:  m->w = add8(m, (uint8_t)in->k, (uint8_t)~m->w, 1); break;
+        case OP_MOVLB:  m->bsr = (uint8_t)in->k; break;
+        case OP_MOVLP:  m->ram[R_PCLATH] = (uint8_t)in->k; break;
+
+        case OP_GOTO:
+            m->pc = (uint16_t)((((m->ram[R_PCLATH] & 0x78u) << 8) | in->k) & m->pc_mask);
+            c = 2;
+            break;
+        case OP_CALL:
+            if (push(m, m->pc)) break;
+            m->pc = (uint16_t)((((m->ram[R_PCLATH] & 0x78u) << 8) | in->k) & m->pc_mask);
+            frame_push(m, m->fn_at[m->pc]);
+            sfn = cur_fn = self_fn(m);              // CALL zählt zum Ziel
+            c = 2;
+            break;
+        case OP_CALLW:
+            if (push(m, m->pc)) break;
+            m->pc = (uint16_t)(((m->ram[R_PCLATH] << 8) | m->w) & m->pc_mask);
+            frame_push(m, m->fn_at[m->pc]);
+            sfn = cur_fn = self_fn(m);
+            c = 2;
+            break;
+        case OP_BRA: {
+            int off = (in->k & 0x100u) ? (int)in->k - 0x200 : (int)in->k;
+            m->pc = (uint16_t)((m->pc + off) & m->pc_mask);
+            c = 2;
+            break;
+        }
+        case OP_BRW:
+            m->pc = (uint16_t)((m->pc + m->w) & m->pc_mask);
+            c = 2;
+            break;
+        case OP_RETLW:
+            m->w = (uint8_t)in->k;
+            /* fall through */
+        case OP_RETURN:
+            m->pc = pop(m);
+            frame_pop(m, 2);
+            cur_fn = self_fn(m);
+            c = 2;
+            break;
+        case OP_RETFIE:
+            m->pc = pop(m);
+            m->ram[R_INTCON] |= IC_GIE;
+            if (ENH(m)) {
+                ST(m) = (uint8_t)((ST(m) & ~0x07u) | (m->ram[E_SHAD + 0] & 0x07u));
+                m->w   = m->ram[E_SHAD + 1];
+                m->bsr = m->ram[E_SHAD + 2] & 0x1Fu;
+                m->ram[R_PCLATH] = m->ram[E_SHAD + 3];
+                memcpy(&m->ram[E_FSR0L], &m->ram[E_SHAD + 4], 4);
+            }
+            if (cur_fn >= 0) m->fn[cur_fn].self += 2;
+            advance(m, 2);                          // zählt noch zur ISR
+            frame_pop(m, 0);
+            m->in_isr = 0;
+            cur_fn = self_fn(m);
+            c = 0;
+            break;
+
+        case OP_ADDFSR: {
+            unsigned n = E_FSR0L + 2u * in->d;
+            int      k = (in->k & 0x20u) ? (int)in->k - 0x40 : (int)in->k;
+            uint16_t f = (uint16_t)(fsr16(m, in->d) + k);
+            m->ram[n] = (uint8_t)f; m->ram[n + 1u] = (uint8_t)(f >> 8);
+            break;
+        }
+        case OP_MOVIW: case OP_MOVWI: {
+            unsigned n = E_FSR0L + 2u * in->d;
+            uint16_t f = fsr16(m, in->d), use;
+            switch (in->k) {
+            case 0: use = ++f; break;                 // ++FSRn
+            case 1: use = --f; break;                 // --FSRn
+            case 2: use = f++; break;                 // FSRn++
+            default: use = f--; break;                // FSRn--
+            }
+            m->ram[n] = (uint8_t)f; m->ram[n + 1u] = (uint8_t)(f >> 8);
+            if (in->op == OP_MOVIW) { m->w = ind_rd(m, use); set_z(m, m->w); }
+            else                      ind_wr(m, use, m->w);
+            break;
+        }
+        case OP_MOVIWK: case OP_MOVWIK: {
+            int      k   = (in->k & 0x20u) ? (int)in->k - 0x40 : (int)in->k;
+            uint16_t use = (uint16_t)(fsr16(m, in->d) + k);
+            if (in->op == OP_MOVIWK) { m->w = ind_rd(m, use); set_z(m, m->w); }
+            else                       ind_wr(m, use, m->w);
+            break;
+        }
+
+        case OP_CLRWDT:
+            wdt_clear(m);
+            if (!ENH(m) && (m->ram[M_OPTION] & 0x08u)) m->t0_acc = 0;
+            ST(m) |= ST_NTO | ST_NPD;
+            break;
+        case OP_SLEEP:
+            wdt_clear(m);
+            ST(m) = (uint8_t)((ST(m) | ST_NTO) & ~ST_NPD);
+            m->sleeps++;
+            if (!wake_pending(m)) {                 // gesetztes Flag: SLEEP = NOP
+                m->sleeping = 1;
+                wdt_update(m);
+            }
+            break;
+        case OP_OPTION:
+            if (!ENH(m)) { m->ram[M_OPTION] = m->w; option_changed(m); pins_update(m); }
+            break;
+        case OP_TRIS:
+            if (in->k >= 5u && in->k <= 7u) {
+                unsigned t = ENH(m) ? (in->k == 5u ? E_TRISA : E_TRISC)
+                                    : (in->k == 5u ? M_TRISA : M_TRISB);
+                m->ram[t] = m->w;
+                pins_update(m);
+            }
+            break;
+        case OP_RESET:
+            iss_reset(m, 0);
+            c = 1;
+            break;
+        default:
+            break;                                  // ILLEGAL: wie NOP
+        }
+#undef DEST
+
+        c += m->extra;
+        m->insns++;
+        if (c) {
+            if (sfn >= 0) m->fn[sfn].self += c;
+            advance(m, c);
+        }
+        if (m->now_ps >= next_event(m) && events(m)) {
+            wdt_timeout_awake(m);
+            cur_fn = self_fn(m);
+        }
+
+        if (m->irq_hold)                            m->irq_hold = 0;
+        else if ((m->ram[R_INTCON] & IC_GIE) && !m->sleeping && wake_pending(m)) {
+            take_irq(m);
+            cur_fn = self_fn(m);
+            if (cur_fn >= 0) m->fn[cur_fn].self += 2;
+        }
+    }
+    return m->insns - start;
+}
@@ -0,0 +1,160 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Befehlssatz-Simulator  ·  PIC16F84A (Mid-Range) + PIC16F1825 (Enhanced)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Führt das von XC8 erzeugte Intel-HEX Befehl für Befehl aus — anders
+ *  als sim.h (Firmware-C auf dem PC) zählt hier jeder echte Befehl:
+ *    1 Tcy je Befehl, 2 Tcy für Sprünge, CALL/RETURN, übersprungene
+ *    Befehle und Schreiben auf PCL; Interrupt-Einsprung 2 Tcy.
+ *
+ *  Modelliert:
+ *    Kern        Banking (RP0 bzw. BSR), INDF/FSR (1825: linear + Flash),
+ *                Hardware-Stack, 1825: Kontext-Shadow beim Interrupt
+ *    Timer0      Fosc/4, Vorteiler (OPTION_REG), 2 Tcy Sperre nach
+ *                Schreiben auf TMR0, steht im SLEEP
+ *    Timer1/2    nur 1825; Timer1 mit LFINTOSC läuft im SLEEP weiter
+ *    WDT         Reset im Betrieb, Wake-Up im SLEEP
+ *    Interrupts  Vektor 0x0004, GIE/PEIE, Wake aus SLEEP ohne GIE
+ *    Ports       TRIS/PORT/LAT, Pull-Ups (/RBPU bzw. nWPUEN + WPUx),
+ *                ANSEL (digital liest 0), RBIF-Mismatch (84A), IOC (1825)
+ *    EEPROM      Lesen, Schreiben mit 55/AA-Sequenz und Schreibzeit
+ *    Takt        84A: fest (RC), 1825: OSCCON/IRCF/SPLLEN zur Laufzeit
+ *
+ *  Zeit in Pikosekunden (uint64): reicht für ~200 Tage Gerätezeit.
+ *  SLEEP springt direkt zum nächsten Weck-Ereignis.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef ISS_H
+#define ISS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define ISS_PS_MS       1000000000ull          // ps je ms
+#define ISS_MAX_FN      256u
+#define ISS_SHADOW      64u                    // Tiefe der Profil-Aufrufkette
+
+enum iss_chip { ISS_16F84A, ISS_16F1825 };
+
+// ─── Vordekodierter Befehl ────────────────────────────────────────────
+struct iss_insn {
+    uint8_t  op;            // enum in iss.c
+    uint8_t  d;             // Ziel (0 = W, 1 = f) bzw. Bitnummer / FSR-Nr.
+    uint16_t k;             // f, Literal oder Sprungziel
+};
+
+// ─── Profil: Funktionen aus der Map-Datei ─────────────────────────────
+struct iss_fn {
+    char     name[40];
+    uint16_t addr;
+    uint64_t calls;
+    uint64_t rets;          // abgeschlossene Aufrufe (Basis für Ø)
+    uint64_t incl;          // Tcy inkl. Unterfunktionen, ohne ISR
+    uint64_t self;          // Tcy nur im eigenen Code
+    uint64_t max_incl;      // teuerster einzelner Aufruf
+};
+
+struct iss_frame {
+    int16_t  fn;            // −1 = unbekanntes Ziel (z. B. RETLW-Tabelle)
+    uint64_t cyc0;          // Zyklen beim Einsprung
+    uint64_t isr0;          // ISR-Zyklen beim Einsprung
+};
+
+struct iss_edge {
+    uint64_t t_ps;
+    uint8_t  pressed;
+};
+
+struct iss {
+    enum iss_chip chip;
+
+    // Programm
+    uint16_t pc, pc_mask;
+    uint16_t flash_words;
+    uint16_t prog[8192];
+    struct iss_insn code[8192];
+    uint16_t config[2];
+    uint8_t  eeprom[256];
+
+    // Datenspeicher (Bank-Adresse bank<<7 | f) → kanonische Adresse
+    uint8_t  ram[4096];
+    uint16_t alias[4096];
+    uint8_t  kind[4096];
+    uint8_t  w, bsr;
+    uint16_t stack[16];
+    uint8_t  sp, stack_depth;
+    uint8_t  extra;         // Strafzyklen des laufenden Befehls (PCL, FSR → Flash)
+
+    // Zeit
+    uint64_t now_ps;
+    uint64_t tcy_ps;
+    uint32_t fosc_hz;
+    uint32_t lfintosc_hz;
+    uint64_t cycles, insns;
+    uint64_t active_ps, sleep_ps;
+
+    // Timer0
+    uint8_t  t0_on;         // Fosc/4 als Takt
+    uint32_t t0_div, t0_acc;
+    uint8_t  t0_inhibit;
+    // Timer1 (1825)
+    uint8_t  t1_on, t1_src; // Quelle: 0 Fosc/4, 1 Fosc, 2 T1OSC, 3 LFINTOSC
+    uint32_t t1_div, t1_acc;
+    uint64_t t1_lf_ps;      // LFINTOSC/T1OSC: angefangene Vorteiler-Periode
+    // Timer2 (1825)
+    uint8_t  t2_on;
+    uint32_t t2_div, t2_acc, t2_post;
+    // WDT
+    uint8_t  wdt_on;
+    uint64_t wdt_start_ps, wdt_period_ps;
+    // EEPROM
+    uint8_t  ee_unlock;
+    uint64_t ee_done_ps;    // 0 = kein Schreibvorgang
+    // FVR + ADC (1825): nur Kanal FVR, Ergebnis aus vdd_mv
+    uint16_t vdd_mv;        // Batteriespannung (Default 3000 mV)
+    uint64_t adc_done_ps;   // 0 = keine Wandlung
+
+    // Ablauf
+    uint8_t  sleeping;
+    uint8_t  irq_hold;      // nach Wake: erst ein Befehl, dann Vektor
+    uint8_t  halted;        // SLEEP ohne mögliche Weckquelle
+
+    // Pins
+    uint8_t  pins[2];       // 84A: PORTA, PORTB · 1825: PORTA, PORTC
+    uint8_t  rb_seen;       // 84A: RB7:RB4 beim letzten PORTB-Zugriff
+    uint8_t  btn_port, btn_bit;
+    uint8_t  btn_pressed;
+    uint8_t  leds;
+    void   (*on_leds)(uint64_t t_ps, uint8_t leds);
+
+    struct iss_edge *edges;
+    size_t   n_edges, cap_edges, next_edge;
+
+    // Statistik
+    uint64_t irqs, sleeps, wdt_wakes, wdt_resets, stack_overflows;
+
+    // Profil
+    struct iss_fn fn[ISS_MAX_FN];
+    int16_t  fn_at[8192];   // Programmadresse → Funktion, −1 = keine
+    unsigned n_fn;
+    int16_t  fn_at_vector;  // Funktion an 0x0004 (isr)
+    int16_t  fn_main;
+    uint64_t isr_cycles;    // Zyklen in der ISR (für incl-Abzug)
+    uint8_t  in_isr;
+    struct iss_frame frames[ISS_SHADOW];
+    unsigned depth;
+    uint64_t main_cyc0, main_isr0;
+    uint8_t  main_seen;
+};
+
+int      iss_init(struct iss *m, enum iss_chip chip, uint32_t fosc_hz);
+int      iss_load_hex(struct iss *m, const char *path);
+int      iss_load_map(struct iss *m, const char *path);
+int      iss_add_symbol(struct iss *m, const char *name, uint16_t addr);
+void     iss_reset(struct iss *m, int por);
+void     iss_press(struct iss *m, uint64_t t_ps, uint64_t hold_ps);
+uint64_t iss_run(struct iss *m, uint64_t until_ps);
+uint64_t iss_main_cycles(const struct iss *m);
+
+#endif
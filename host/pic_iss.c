@@ -0,0 +1,236 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  pic_iss  ·  XC8-HEX befehlsgenau ausführen und profilieren
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Ergänzung zu dice_sim: dort läuft das Firmware-C auf dem PC und nur
+ *  SFR-Zugriffe kosten Zeit. Hier läuft das fertige Kompilat (iss.c),
+ *  jeder Befehl mit seinen echten Tcy — die Zahlen gelten für genau den
+ *  Code, den XC8 erzeugt hat, samt Optimierungsstufe und Lizenz-Modus.
+ *
+ *  Build:
+ *    gcc -O2 -Ihost -o pic_iss host/pic_iss.c host/iss.c
+ *
+ *  Aufruf:
+ *    pic_iss -m 16F84A|16F1825 [-f hz] [-w hz] [-v volt] [-t ms] [-p ms:halten_ms]...
+ *            [-y datei.map] [-s name=adresse]... [-q] firmware.hex
+ *    pic_iss -k host/fixtures/iss_check.txt
+ *      -m   Chip (Pflicht)
+ *      -f   Oszillator 16F84A (Default 709000 Hz, 4,7 kΩ + 100 pF);
+ *           16F1825 folgt OSCCON
+ *      -w   LFINTOSC 16F1825 (Default 31000 Hz, streut ±15 %)
+ *      -v   Batteriespannung 16F1825 (Default 3.0 V, FVR-Messung)
+ *      -t   Simulationsdauer (Default 15000 ms)
+ *      -p   Tastendruck bei ms, gehalten für halten_ms (mehrfach)
+ *      -y   XC8-Map-Datei (-Wl,-Map=…): Funktionsnamen fürs Profil
+ *      -s   Symbol von Hand, Adresse in Worten (hex), z. B. -s isr=4
+ *      -q   keine Frame-Liste
+ *      -k   Prüfmodus: von Hand assemblierte HEX-Dateien aus der Liste
+ *           laufen lassen, Tcy und Interrupts bis SLEEP mit dem Soll
+ *           vergleichen (Rückgabe 0 = alle gleich, 1 = Abweichung)
+ *
+ *  Ausgabe: Frames wie dice_sim (Start [ms], Dauer [ms], LED-Muster),
+ *  danach Zusammenfassung und Profil je Funktion:
+ *    inkl    Tcy einschließlich Unterfunktionen, ohne Interrupts
+ *    selbst  Tcy nur im eigenen Code (ISR-Zeit zählt bei isr)
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "iss.h"
+
+static struct iss m;
+static int        quiet;
+
+// ─── Frame-Ausgabe (wie dice_sim, Zeit in ps) ────────────────────────
+#define GAP_PS     (6ull * ISS_PS_MS)
+#define GLITCH_PS  20000000ull
+
+static uint8_t  pin_leds, vis;
+static uint64_t pin_t, vis_t0, vis_on;
+
+static void print_frame(uint64_t t_end) {
+    static const char bit[] = "abcdefg";
+    char     art[8];
+    uint64_t dur = t_end - vis_t0;
+    int      k;
+
+    if (quiet || !dur) return;
+    for (k = 0; k < 7; k++) art[k] = (vis & (1u << k)) ? bit[k] : '.';
+    art[7] = '\0';
+    printf("%10.3f  %8.3f  0x%02X  %s  %3.0f%%\n", vis_t0 / 1e9, dur / 1e9,
+           vis, art, vis ? 100.0 * vis_on / dur : 0.0);
+}
+
+static void close_segment(uint64_t t_ps) {
+    uint64_t dur = t_ps - pin_t;
+
+    if (pin_leds) {
+        if (pin_leds != vis && dur >= GLITCH_PS) {
+            print_frame(pin_t);
+            vis = pin_leds; vis_t0 = pin_t; vis_on = 0;
+        }
+        if (pin_leds == vis) vis_on += dur;
+    } else if (vis && dur >= GAP_PS) {
+        print_frame(pin_t);
+        vis = 0; vis_t0 = pin_t; vis_on = 0;
+    }
+}
+
+static void on_leds(uint64_t t_ps, uint8_t leds) {
+    close_segment(t_ps);
+    pin_leds = leds;
+    pin_t    = t_ps;
+}
+
+// ─── Profil ───────────────────────────────────────────────────────────
+static int by_incl(const void *a, const void *b) {
+    const struct iss_fn *x = *(const struct iss_fn *const *)a;
+    const struct iss_fn *y = *(const struct iss_fn *const *)b;
+    return x->incl < y->incl ? 1 : x->incl > y->incl ? -1 : strcmp(x->name, y->name);
+}
+
+static void profile(void) {
+    const struct iss_fn *row[ISS_MAX_FN];
+    unsigned k, n = 0;
+
+    for (k = 0; k < m.n_fn; k++)
+        if (m.fn[k].calls || m.fn[k].self) row[n++] = &m.fn[k];
+    if (n <= 1u && !m.fn[0].self) return;
+    qsort(row, n, sizeof row[0], by_incl);
+
+    printf("\n%-24s %10s %14s %14s %10s %10s\n",
+           "Funktion", "Aufrufe", "inkl [Tcy]", "selbst [Tcy]", "Ø inkl", "max inkl");
+    for (k = 0; k < n; k++) {
+        const struct iss_fn *f = row[k];
+        printf("%-24s %10llu %14llu %14llu %10.1f %10llu\n", f->name,
+               (unsigned long long)f->calls, (unsigned long long)f->incl,
+               (unsigned long long)f->self,
+               f->rets ? (double)f->incl / f->rets : 0.0,
+               (unsigned long long)f->max_incl);
+    }
+    if (m.main_seen)
+        printf("# main inkl. (ohne ISR, läuft noch): %llu Tcy\n",
+               (unsigned long long)iss_main_cycles(&m));
+}
+
+static void summary(double host_s) {
+    static const char *chip[] = { "PIC16F84A", "PIC16F1825" };
+
+    printf("# %s  Fosc=%u Hz  t=%.3f ms  Zyklen=%llu  aktiv=%.3f ms  sleep=%.3f ms\n",
+           chip[m.chip], m.fosc_hz, m.now_ps / 1e9,
+           (unsigned long long)m.cycles, m.active_ps / 1e9, m.sleep_ps / 1e9);
+    printf("# Befehle=%llu  ISR=%llu  SLEEP=%llu  WDT-Wake=%llu  WDT-Reset=%llu  Stack-Überlauf=%llu\n",
+           (unsigned long long)m.insns, (unsigned long long)m.irqs,
+           (unsigned long long)m.sleeps, (unsigned long long)m.wdt_wakes,
+           (unsigned long long)m.wdt_resets, (unsigned long long)m.stack_overflows);
+    if (host_s > 0.0)
+        printf("# Host: %.2f s, %.1f MIPS\n", host_s, m.insns / host_s / 1e6);
+}
+
+// ─── Prüfmodus ────────────────────────────────────────────────────────
+// Liste: je Zeile  Chip  Tcy  ISR  Datei  (Datei relativ zur Liste,
+// # = Kommentar). Jeder Prüfling endet in SLEEP ohne Weckquelle; wer
+// dort nach 1 s nicht angekommen ist, hängt in seiner Fehlerschleife.
+static int check(const char *list) {
+    FILE         *f = fopen(list, "r");
+    const char   *slash = strrchr(list, '/');
+    int           dir = slash ? (int)(slash - list) + 1 : 0;
+    char          line[512], chip[16], file[256], path[512];
+    unsigned long tcy, irq;
+    unsigned      n = 0, bad = 0;
+
+    if (!f) { perror(list); return 1; }
+    while (fgets(line, sizeof line, f)) {
+        int ok;
+
+        if (line[0] == '#' ||
+            sscanf(line, "%15s %lu %lu %255s", chip, &tcy, &irq, file) != 4) continue;
+        if (!strcmp(chip, "16F84A"))       iss_init(&m, ISS_16F84A, 709000u);
+        else if (!strcmp(chip, "16F1825")) iss_init(&m, ISS_16F1825, 0);
+        else { fprintf(stderr, "%s: Chip %s?\n", list, chip); bad++; continue; }
+        snprintf(path, sizeof path, "%.*s%s", dir, list, file);
+        if (iss_load_hex(&m, path) < 0) { perror(path); bad++; continue; }
+
+        iss_run(&m, 1000ull * ISS_PS_MS);
+        ok = m.halted && m.cycles == tcy && m.irqs == irq;
+        printf("%-24s %-8s Tcy %6llu (Soll %6lu)  ISR %2llu (Soll %2lu)  %s\n",
+               file, chip, (unsigned long long)m.cycles, tcy,
+               (unsigned long long)m.irqs, irq,
+               ok ? "ok" : m.halted ? "FEHLER" : "FEHLER: kein SLEEP");
+        n++;
+        bad += !ok;
+    }
+    fclose(f);
+    printf("# %u Prüflinge, %u Fehler\n", n, bad);
+    return bad || !n ? 1 : 0;
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    uint64_t    t_end = 15000ull * ISS_PS_MS;
+    uint32_t    fosc = 709000u, lfint = 0;
+    const char *hex = NULL, *map = NULL, *chip = NULL;
+    clock_t     c0;
+    int         i;
+
+    for (i = 1; i < argc; i++) {                       // Chip + Takt zuerst
+        if (!strcmp(argv[i], "-k") && i + 1 < argc) return check(argv[i + 1]);
+        if (!strcmp(argv[i], "-m") && i + 1 < argc) chip = argv[i + 1];
+        if (!strcmp(argv[i], "-f") && i + 1 < argc) fosc = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+    }
+    if (!chip) goto usage;
+    if (!strcmp(chip, "16F84A"))       iss_init(&m, ISS_16F84A, fosc);
+    else if (!strcmp(chip, "16F1825")) iss_init(&m, ISS_16F1825, 0);
+    else goto usage;
+
+    for (i = 1; i < argc; i++) {
+        if ((!strcmp(argv[i], "-m") || !strcmp(argv[i], "-f")) && i + 1 < argc) {
+            i++;
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            lfint = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (!strcmp(argv[i], "-v") && i + 1 < argc) {
+            m.vdd_mv = (uint16_t)(atof(argv[++i]) * 1000.0 + 0.5);
+        } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            t_end = strtoull(argv[++i], NULL, 10) * ISS_PS_MS;
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            unsigned long at, hold;
+            if (sscanf(argv[++i], "%lu:%lu", &at, &hold) != 2) goto usage;
+            iss_press(&m, at * ISS_PS_MS, hold * ISS_PS_MS);
+        } else if (!strcmp(argv[i], "-y") && i + 1 < argc) {
+            map = argv[++i];
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            char name[40];
+            unsigned addr;
+            if (sscanf(argv[++i], "%39[^=]=%x", name, &addr) != 2) goto usage;
+            iss_add_symbol(&m, name, (uint16_t)addr);
+        } else if (!strcmp(argv[i], "-q")) {
+            quiet = 1;
+        } else if (argv[i][0] != '-' && !hex) {
+            hex = argv[i];
+        } else {
+            goto usage;
+        }
+    }
+    if (!hex) goto usage;
+    if (lfint) m.lfintosc_hz = lfint;
+    if (map && iss_load_map(&m, map) < 0) { perror(map); return 1; }
+    if (iss_load_hex(&m, hex) < 0) { perror(hex); return 1; }
+    m.on_leds = on_leds;
+
+    c0 = clock();
+    iss_run(&m, t_end);
+    close_segment(m.now_ps);
+    print_frame(m.now_ps);
+    summary((double)(clock() - c0) / CLOCKS_PER_SEC);
+    profile();
+    return 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s -m 16F84A|16F1825 [-f hz] [-w hz] [-v volt] [-t ms] [-p ms:halten_ms]...\n"
+                    "          [-y datei.map] [-s name=adresse]... [-q] firmware.hex\n"
+                    "       %s -k liste.txt\n", argv[0], argv[0]);
+    return 2;
+}
@@ -0,0 +1,265 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  rng_test  ·  Statistik-Test des Würfel-Zufallsgenerators
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Übersetzt rng_mix()/rng_next()/rng_roll() direkt aus main.c bzw.
+ *  main_1825.c und würfelt Millionen Mal in derselben Reihenfolge wie die
+ *  Firmware je Wurf:
+ *    Druck:      rng_mix(TMR0 an der Flanke), rng_mix(Tick-Zähler)
+ *    Animation:  23× rng_next() (Seitensprünge)
+ *    Loslassen:  rng_mix(Druckdauer in Ticks)
+ *    Ergebnis:   rng_roll()
+ *
+ *  Entropie-Modell (Host-Zufall, splitmix64):
+ *    TMR0 gleichverteilt, Druckdauer 120 ± 30 ms, 2 … 20 s zwischen Würfen
+ *    -k: alle Entropiequellen konstant → nur der xorshift-Generator zählt;
+ *        die Folge läuft dann in einen kurzen Zyklus, χ² muss anschlagen
+ *
+ *  Tests:
+ *    χ² Häufigkeit      5 FG   (kritisch 11,07 @ 5 %, 15,09 @ 1 %)
+ *    χ² Wurfpaare      35 FG   (kritisch 49,80 @ 5 %, 57,34 @ 1 %)
+ *    Vergleich mit dem alten  tmr0_count % 6  (256 Werte → 4×43, 2×42)
+ *
+ *  Zyklen je Wurf: die Host-Simulation zählt nur SFR-Zugriffe, reines C
+ *  kostet dort 0 Tcy. Geschätzt wird deshalb über die Anzahl der
+ *  xorshift-Schritte (Richtwerte für XC8, -c).
+ *
+ *  Exakt (unabhängig vom Entropie-Modell): Augenzahl je Generatorzustand
+ *  über alle 65535 Zustände, Sollwert 10922/10923.
+ *
+ *  Build:
+ *    gcc -O2 -D_16F84A  -Ihost -o rng_test_84a  host/rng_test.c host/sim.c -lm
+ *    gcc -O2 -D_16F1825 -Ihost -o rng_test_1825 host/rng_test.c host/sim.c -lm
+ *
+ *  Aufruf:
+ *    rng_test [-n würfe] [-s seed] [-k] [-c schritt:basis:rest]
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (static-Funktionen direkt aufrufbar) ─────────
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME  "PIC16F84A"
+#else
+#include "../main_1825.c"
+#define FW_NAME  "PIC16F1825"
+#endif
+#undef main
+
+// ─── Zyklen-Richtwerte (XC8, ohne Barrel-Shifter) ────────────────────
+// xorshift-Schritt: <<8 = Byte-Kopie, >>9 = Byte-Kopie + 1 Shift,
+// <<7 = 16-Bit-Shift über Carry, dazu Aufruf + Versuch (High-Byte, SWAP,
+// Maske, Vergleich); Rest = v & 3 (kommt nicht vor, ungünstigster
+// Zustand 8 Schritte)
+struct tcy_est {
+    unsigned step, base, rest;
+};
+
+static struct tcy_est est = { 48u, 12u, 4u };
+
+// ─── Host-Zufall für das Entropie-Modell ─────────────────────────────
+static uint64_t host_s;
+
+static uint64_t splitmix64(void) {
+    uint64_t z = (host_s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static uint32_t host_range(uint32_t lo, uint32_t hi) {
+    return lo + (uint32_t)(splitmix64() % (hi - lo + 1u));
+}
+
+// ─── Referenzmodell von rng_roll(): zählt Schritte und Versuche ──────
+struct roll_cost {
+    unsigned steps, rest;
+};
+
+static uint8_t ref_roll(uint16_t s, struct roll_cost *c) {
+    unsigned k;
+
+    c->steps = c->rest = 0;
+    for (k = 0; k < RNG_STEPS; k++) {
+        s ^= (uint16_t)(s << 7); s ^= (uint16_t)(s >> 9); s ^= (uint16_t)(s << 8);
+        c->steps++;
+        if ((s >> 13) < 6u) return (uint8_t)(s >> 13);
+    }
+    c->rest = 1;
+    return (uint8_t)((s >> 13) & 3u);
+}
+
+// Alle 65535 Zustände einmal: wie viele Zustände je Augenzahl, und
+// wie viele Schritte braucht der ungünstigste Zustand (exakte Schranke)?
+static unsigned state_spread(uint64_t cnt[6], struct roll_cost *worst) {
+    struct roll_cost c;
+    uint64_t lo = UINT64_MAX, hi = 0;
+    uint32_t s;
+    unsigned k;
+
+    for (k = 0; k < 6u; k++) cnt[k] = 0;
+    worst->steps = worst->rest = 0;
+    for (s = 1; s <= 0xFFFFu; s++) {
+        cnt[ref_roll((uint16_t)s, &c)]++;
+        if (c.steps + c.rest > worst->steps + worst->rest) *worst = c;
+    }
+    for (k = 0; k < 6u; k++) {
+        if (cnt[k] < lo) lo = cnt[k];
+        if (cnt[k] > hi) hi = cnt[k];
+    }
+    return (unsigned)(hi - lo);
+}
+
+static unsigned cost_tcy(const struct roll_cost *c) {
+    return est.base + c->steps * est.step + c->rest * est.rest;
+}
+
+// ─── χ² ───────────────────────────────────────────────────────────────
+static double chi2(const uint64_t *obs, const double *expect, unsigned n) {
+    double   x = 0.0;
+    unsigned k;
+
+    for (k = 0; k < n; k++) {
+        double d = (double)obs[k] - expect[k];
+        x += d * d / expect[k];
+    }
+    return x;
+}
+
+static const char *verdict(double x, double crit5, double crit1) {
+    return x < crit5 ? "ok" : x < crit1 ? "auffällig (5 %)" : "VERZERRT (1 %)";
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    uint64_t n_rolls = 30000000ull, seed = 1u, i;
+    uint64_t face[6] = { 0 }, pair[36] = { 0 }, old_face[6] = { 0 };
+    uint64_t hist_steps[RNG_STEPS + 1] = { 0 }, n_rest = 0, tcy_sum = 0, mism = 0;
+    uint64_t per_state[6];
+    struct roll_cost worst;
+    double   expect[36];
+    unsigned tcy_max = 0, k;
+    uint16_t ticks = 0;
+    uint8_t  prev = 0xFFu;
+    int      konst = 0;
+
+    for (k = 1; k < (unsigned)argc; k++) {
+        if (!strcmp(argv[k], "-n") && k + 1 < (unsigned)argc) {
+            n_rolls = strtoull(argv[++k], NULL, 10);
+        } else if (!strcmp(argv[k], "-s") && k + 1 < (unsigned)argc) {
+            seed = strtoull(argv[++k], NULL, 10);
+        } else if (!strcmp(argv[k], "-k")) {
+            konst = 1;
+        } else if (!strcmp(argv[k], "-c") && k + 1 < (unsigned)argc) {
+            if (sscanf(argv[++k], "%u:%u:%u", &est.step, &est.base,
+                       &est.rest) != 3) goto usage;
+        } else {
+            goto usage;
+        }
+    }
+    if (!n_rolls) goto usage;
+    host_s = seed;
+
+    for (i = 0; i < n_rolls; i++) {
+        struct roll_cost c;
+        uint8_t  t0, hold, r, ref;
+        unsigned tcy;
+
+        // Zeit seit dem letzten Wurf, Phase im Tick, Druckdauer
+        if (konst) {
+            t0 = 0x5Au; hold = (uint8_t)MS(120); ticks += MS(5000);
+        } else {
+            ticks += (uint16_t)MS(host_range(2000u, 20000u));
+            t0    = (uint8_t)splitmix64();
+            hold  = (uint8_t)MS(host_range(90u, 150u));
+        }
+        old_face[(uint8_t)ticks % 6u]++;       // Zählerstand beim Druck
+
+        rng_mix(t0);
+        rng_mix((uint8_t)ticks);
+        for (k = 0; k < 23u; k++) rng_next();
+        rng_mix(hold);
+
+        ref = ref_roll(rng_s, &c);
+        r   = rng_roll();
+        if (r != ref) mism++;
+
+        tcy = cost_tcy(&c);
+        tcy_sum += tcy;
+        if (tcy > tcy_max) tcy_max = tcy;
+        hist_steps[c.rest ? 0 : c.steps]++;
+        n_rest += c.rest;
+
+        face[r]++;
+        if (prev < 6u) pair[prev * 6u + r]++;
+        prev = r;
+    }
+
+    printf("# %s  rng_test  %llu Würfe  Entropie: %s\n", FW_NAME,
+           (unsigned long long)n_rolls, konst ? "konstant (-k)" : "Modell");
+
+    // Häufigkeit
+    for (k = 0; k < 6u; k++) expect[k] = n_rolls / 6.0;
+    printf("\nAugen    Anzahl        Anteil    Abw. [σ]\n");
+    for (k = 0; k < 6u; k++) {
+        double sd = sqrt(n_rolls * (1.0 / 6.0) * (5.0 / 6.0));
+        printf("  %u  %12llu   %8.5f %%   %+6.2f\n", k + 1,
+               (unsigned long long)face[k], 100.0 * face[k] / n_rolls,
+               (face[k] - expect[k]) / sd);
+    }
+    {
+        double x = chi2(face, expect, 6);
+        printf("χ² Häufigkeit  (5 FG):  %8.2f  %s\n", x, verdict(x, 11.07, 15.09));
+    }
+
+    // Paare aufeinanderfolgender Würfe
+    for (k = 0; k < 36u; k++) expect[k] = (n_rolls - 1) / 36.0;
+    {
+        double x = chi2(pair, expect, 36);
+        printf("χ² Wurfpaare  (35 FG):  %8.2f  %s\n", x, verdict(x, 49.80, 57.34));
+    }
+
+    // Altes Verfahren: Zähler % 6 (256 Zählerstände)
+    for (k = 0; k < 6u; k++) expect[k] = n_rolls / 6.0;
+    {
+        double x = chi2(old_face, expect, 6);
+        printf("\nalt: tmr0_count %% 6    Augen 1–4: %.4f %%, 5–6: %.4f %% (je 43/256 bzw. 42/256)\n",
+               100.0 * 43 / 256, 100.0 * 42 / 256);
+        printf("χ² alt         (5 FG):  %8.2f  %s\n", x, verdict(x, 11.07, 15.09));
+    }
+
+    // Exakt über alle Zustände
+    {
+        unsigned spread = state_spread(per_state, &worst);
+        printf("\nZustände je Augenzahl:");
+        for (k = 0; k < 6u; k++) printf(" %llu", (unsigned long long)per_state[k]);
+        printf("  (Spanne %u, optimal 1)\n", spread);
+        printf("ungünstigster Zustand: %u Schritte%s → %u Tcy\n", worst.steps,
+               worst.rest ? " + Rest" : "", cost_tcy(&worst));
+        if (spread > 1u) mism++;
+    }
+
+    // Laufzeit
+    printf("\nrng_roll(): Schritte    Anteil\n");
+    for (k = 1; k <= RNG_STEPS; k++)
+        if (hist_steps[k])
+            printf("  %2u             %10.6f %%\n", k, 100.0 * hist_steps[k] / n_rolls);
+    printf("  Rest (& 3)     %10.6f %%\n", 100.0 * n_rest / n_rolls);
+    printf("Tcy je Wurf (Richtwerte %u/%u/%u): Mittel %.1f  max %u  Schranke (RNG_STEPS) %u\n",
+           est.step, est.base, est.rest,
+           (double)tcy_sum / n_rolls, tcy_max,
+           est.base + RNG_STEPS * est.step + est.rest);
+    if (mism) printf("FEHLER: Firmware ↔ Referenz oder Zustandsverteilung\n");
+    return mism ? 1 : 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-n würfe] [-s seed] [-k] [-c schritt:basis:rest]\n", argv[0]);
+    return 2;
+}
@@ -0,0 +1,771 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Host-Simulation  ·  Registerdatei, Timer0, Interrupts, SLEEP
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Modell (bewusst einfach, aber zyklengenau für Delays):
+ *   - Jeder SFR-Zugriff = 1 Tcy, __delay_ms(x) = x·Fosc/4000 Tcy
+ *   - Timer0: Fosc/4 → Vorteiler (PSA/PS) → TMR0 → T0IF bei Überlauf
+ *   - Timer2 (16F1825): Fosc/4 → T2CKPS → PR2-Vergleich → T2OUTPS → TMR2IF
+ *   - Timer1 (16F1825): nur LFINTOSC (TMR1CS = 11) → T1CKPS → TMR1IF,
+ *            asynchron (nT1SYNC = 1) zählt er auch im SLEEP und weckt
+ *            (TMR1IE + PEIE)
+ *   - ADC + FVR (16F1825): Wandlung 11,5 TAD nach GO, ADRES = 1023 ·
+ *            U_FVR / VDD (sim.vdd_mv); andere Kanäle lesen 0
+ *   - CPS (16F1825): Oszillator ∝ Strombereich (CPSRNG), Kanal 2 (RA2)
+ *            = Touch-Fläche, berührt (sim.button) um cps_touch_pct
+ *            langsamer; Timer0 zählt ihn bei TMR0CS = 1 und T0XCS = 1
+ *   - Interrupt: GIE && Enable && Flag → GIE=0, isr(), GIE=1 (RETFIE)
+ *   - NOP: 1 Tcy; mit sim.warp bis zum nächsten Ereignis (Zeitraffer)
+ *   - SLEEP: Timer0 steht, Zeit springt zur nächsten Weck-Flanke
+ *            (16F84A: RBIF/RBIE,  16F1825: IOCAFx/IOCIE), zum
+ *            WDT-Timeout (16F1825: SWDTEN, 1:32·2^WDTPS aus LFINTOSC)
+ *            oder zum Timer1-Überlauf
+ *   - Taster aktiv LOW, ohne Pull-Up liest der Pin LOW (floatend)
+ *   - Daten-EEPROM: RD sofort, WR nur nach 55/AA an EECON2 mit WREN
+ *     (ein Interrupt dazwischen bricht die Folge ab), fertig nach
+ *     SIM_EE_WRITE_NS; Inhalt und Verschleiß in sim_ee
+ *
+ *  Die LED-Ausgänge werden bei jedem Zugriff neu bewertet → jede
+ *  Änderung des sichtbaren Musters erzeugt genau einen Frame-Callback.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+struct sim_state  sim;
+struct sim_eeprom sim_ee;
+
+// ─── Registermasken ───────────────────────────────────────────────────
+#define INT_GIE   0x80u
+#define INT_PEIE  0x40u     // 16F84A: EEIE
+#define INT_T0IE  0x20u
+#define INT_INTE  0x10u
+#define INT_RBIE  0x08u     // 16F1825: IOCIE
+#define INT_T0IF  0x04u
+#define INT_INTF  0x02u
+#define INT_RBIF  0x01u     // 16F1825: IOCIF
+
+#define OPT_PULLUP_OFF  0x80u   // /RBPU bzw. nWPUEN
+#define OPT_T0CS        0x20u
+#define OPT_PSA         0x08u
+
+#define EE_RD     0x01u
+#define EE_WR     0x02u
+#define EE_WREN   0x04u
+#define EE_EEIF   0x10u     // nur 16F84A (16F1825: PIR2)
+
+#define STATUS_NTO  0x10u
+#define STATUS_NPD  0x08u
+
+#define BUTTON_BIT  (1u << 7)   // 16F84A: RB7
+#define RA4_BIT     (1u << 4)   // 16F1825: Taster RA4, 16F84A: Referenz RA4
+
+// ─── Zeit ─────────────────────────────────────────────────────────────
+static void set_fosc(uint32_t hz) {
+    sim.fosc_hz = hz;
+    sim.tcy_ns  = 4.0e9 / (double)hz;
+}
+
+static void add_time(double ns) {
+    double   t     = sim.frac_ns + ns;
+    uint64_t whole = (uint64_t)t;
+    sim.now_ns  += whole;
+    sim.frac_ns  = t - (double)whole;
+}
+
+static uint64_t cycles_until(uint64_t t_ns) {
+    double dt;
+    if (t_ns <= sim.now_ns) return 0;
+    dt = (double)(t_ns - sim.now_ns) - sim.frac_ns;
+    if (dt <= 0.0) return 0;
+    return (uint64_t)(dt / sim.tcy_ns) + 1u;
+}
+
+static void finish(void) {
+    if (sim.jmp) longjmp(*sim.jmp, 1);
+    abort();    // Simulationsende ohne sim_run() → Harness-Fehler
+}
+
+// ─── Pins / LEDs ──────────────────────────────────────────────────────
+static uint8_t pullup_on(void) {
+    if (sim.reg[SIM_OPTION_REG] & OPT_PULLUP_OFF) return 0;
+#if defined(_16F84A)
+    return 1;
+#else
+    return (sim.reg[SIM_WPUA] & RA4_BIT) ? 1u : 0u;
+#endif
+}
+
+static uint8_t button_level(void) {
+    if (sim.button) return 0;
+    return pullup_on();
+}
+
+#if defined(_16F1825)
+static uint8_t porta_pins(void) {
+    uint8_t out = sim.reg[SIM_LATA] & (uint8_t)~sim.reg[SIM_TRISA];
+    return (uint8_t)((out & ~RA4_BIT) | (sim.pin ? RA4_BIT : 0u));
+}
+
+static uint8_t portc_pins(void) {
+    return sim.reg[SIM_LATC] & (uint8_t)~sim.reg[SIM_TRISC];
+}
+
+static uint32_t t2_prescale(void);
+static void     t1_sync(void);
+static void     adc_sync(void);
+#endif
+
+// Multiplex (DICE_N > 1): Segmente leuchten nur auf dem gewählten
+// Würfel; kein Würfel gewählt → dunkel, mehrere → Fehler (Strom ×n)
+static uint8_t led_pattern(void) {
+#if defined(_16F84A)
+    return sim.reg[SIM_PORTB] & (uint8_t)~sim.reg[SIM_TRISB] & 0x7Fu;
+#else
+    uint8_t a = sim.reg[SIM_LATA] & (uint8_t)~sim.reg[SIM_TRISA];
+    uint8_t c = sim.reg[SIM_LATC] & (uint8_t)~sim.reg[SIM_TRISC];
+#if defined(DICE_N) && DICE_N > 1
+    uint8_t sel = a & ((1u << DICE_N) - 1u);
+    if (!sel) return 0;
+    if (sel & (sel - 1u)) sim.mux_overlap++;
+    sim.die = (sel & 1u) ? 0u : (sel & 2u) ? 1u : 2u;
+#endif
+    return (uint8_t)((c & 0x3Fu) | ((a >> 5) & 1u) << 6);
+#endif
+}
+
+// Pegelwechsel am Taster-Pin → Interrupt-Flags wie in Hardware
+static void pin_changed(uint8_t level) {
+#if defined(_16F84A)
+    // RB-Port-Change: Mismatch zum zuletzt gelesenen Wert setzt RBIF
+    if ((sim.reg[SIM_TRISB] & BUTTON_BIT) &&
+        ((level ? BUTTON_BIT : 0u) != (sim.rb_latch & BUTTON_BIT)))
+        sim.reg[SIM_INTCON] |= INT_RBIF;
+#else
+    if (( level && (sim.reg[SIM_IOCAP] & RA4_BIT)) ||
+        (!level && (sim.reg[SIM_IOCAN] & RA4_BIT)))
+        sim.reg[SIM_IOCAF] |= RA4_BIT;
+#endif
+}
+
+// ─── Daten-EEPROM ─────────────────────────────────────────────────────
+// Ausgewertet beim nächsten Zugriff nach dem Schreiben des Registers
+// (wie TMR2): EECON2 liest sich als 0, RD löscht sich selbst.
+static void ee_sync(void) {
+    uint8_t v = sim.reg[SIM_EECON2];
+
+    if (sim.ee_busy && sim.now_ns >= sim.ee_done_ns) {
+        sim_ee.data[sim.ee_addr] = sim.ee_data;
+        sim_ee.wear[sim.ee_addr]++;
+        sim.ee_writes++;
+        sim.ee_busy = 0;
+        sim.reg[SIM_EECON1] &= (uint8_t)~EE_WR;
+#if defined(_16F84A)
+        sim.reg[SIM_EECON1] |= EE_EEIF;
+#endif
+    }
+    if (v) {
+        if (v == 0x55u)                           sim.ee_unlock = 1;
+        else if (v == 0xAAu && sim.ee_unlock == 1u) sim.ee_unlock = 2;
+        else                                      sim.ee_unlock = 0;
+        sim.reg[SIM_EECON2] = 0;
+    }
+    if (sim.reg[SIM_EECON1] & EE_RD) {
+        sim.reg[SIM_EEDATA]  = sim_ee.data[sim.reg[SIM_EEADR] % SIM_EE_SIZE];
+        sim.reg[SIM_EECON1] &= (uint8_t)~EE_RD;
+    }
+    if ((sim.reg[SIM_EECON1] & EE_WR) && !sim.ee_busy) {
+        if (sim.ee_unlock == 2u && (sim.reg[SIM_EECON1] & EE_WREN)) {
+            sim.ee_busy    = 1;
+            sim.ee_addr    = (uint8_t)(sim.reg[SIM_EEADR] % SIM_EE_SIZE);
+            sim.ee_data    = sim.reg[SIM_EEDATA];
+            sim.ee_done_ns = sim.now_ns + SIM_EE_WRITE_NS;
+        } else {
+            sim.reg[SIM_EECON1] &= (uint8_t)~EE_WR;   // ohne Folge: kein Start
+        }
+        sim.ee_unlock = 0;
+    }
+}
+
+void sim_ee_erase(void) {
+    memset(sim_ee.data, 0xFF, sizeof sim_ee.data);
+    sim_ee.init = 1;
+}
+
+// Registerzustand nach jedem Firmware-Zugriff nachziehen
+static void sync(void) {
+    uint8_t level = button_level();
+    uint8_t leds, die;
+
+    if (level != sim.pin) {
+        sim.pin = level;
+        pin_changed(level);
+    }
+    ee_sync();
+    // Schreiben auf TMR0: Vorteiler gelöscht, Zähler 2 Tcy gesperrt
+    // (denselben Wert schreiben bleibt unbemerkt)
+    if (sim.reg[SIM_TMR0] != sim.t0_seen) {
+        sim.t0_seen = sim.reg[SIM_TMR0];
+        sim.t0_pre  = 0;
+        sim.t0_hold = 2u;
+#if defined(_16F1825)
+        sim.cps_frac = 0.0;
+#endif
+    }
+#if defined(_16F1825)
+    // Schreiben auf PORTx wirkt in Hardware auf LATx
+    if (sim.reg[SIM_PORTA] != sim.porta_seen) sim.reg[SIM_LATA] = sim.reg[SIM_PORTA];
+    if (sim.reg[SIM_PORTC] != sim.portc_seen) sim.reg[SIM_LATC] = sim.reg[SIM_PORTC];
+    sim.reg[SIM_PORTA] = sim.porta_seen = porta_pins();
+    sim.reg[SIM_PORTC] = sim.portc_seen = portc_pins();
+    // Schreiben auf TMR2 setzt Zähler und Vorteiler
+    if (sim.reg[SIM_TMR2] != sim.t2_seen) {
+        sim.t2_seen = sim.reg[SIM_TMR2];
+        sim.t2_pos  = (uint64_t)sim.t2_seen * t2_prescale();
+    }
+    t1_sync();
+    adc_sync();
+    // IOCIF ist read-only: ODER aller IOCAFx
+    if (sim.reg[SIM_IOCAF] & 0x3Fu) sim.reg[SIM_INTCON] |= INT_RBIF;
+    else                            sim.reg[SIM_INTCON] &= (uint8_t)~INT_RBIF;
+#endif
+    die  = sim.die;
+    leds = led_pattern();
+    if (leds != sim.leds || die != sim.die) {
+        sim.leds = leds;
+        sim.frames++;
+        if (sim.on_frame) sim.on_frame(sim.now_ns, leds);
+    }
+}
+
+static void apply_edges(void) {
+    while (sim.next_edge < sim.n_edges &&
+           sim.edges[sim.next_edge].t_ns <= sim.now_ns) {
+        sim.button = sim.edges[sim.next_edge].pressed;
+        sim.next_edge++;
+        sync();
+        if (sim.on_clock) sim.on_clock();   // Pull-up-Strom ändert sich
+    }
+}
+
+// ─── Interrupts ───────────────────────────────────────────────────────
+static uint8_t periph_pending(void) {
+#if defined(_16F1825)
+    return (sim.reg[SIM_INTCON] & INT_PEIE) &&
+           (sim.reg[SIM_PIE1] & sim.reg[SIM_PIR1]);
+#else
+    return 0;
+#endif
+}
+
+static uint8_t irq_pending(void) {
+    uint8_t ic = sim.reg[SIM_INTCON];
+    return ((ic & INT_T0IE) && (ic & INT_T0IF)) ||
+           ((ic & INT_INTE) && (ic & INT_INTF)) ||
+           ((ic & INT_RBIE) && (ic & INT_RBIF)) ||
+           periph_pending();
+}
+
+static void dispatch(void) {
+    uint64_t c0;
+
+    if (sim.in_isr || !sim.isr) return;
+    if (!(sim.reg[SIM_INTCON] & INT_GIE) || !irq_pending()) return;
+
+    sim.reg[SIM_INTCON] &= (uint8_t)~INT_GIE;
+    sim.ee_unlock = 0;                  // 55/AA nur ohne Unterbrechung
+    sim.in_isr = 1;
+    sim.isr_calls++;
+    c0 = sim.cycles;
+    sim_delay_cycles(2u);               // Sprung auf 0x0004
+    sim.isr();
+    sim_delay_cycles(2u);               // RETFIE
+    c0 = sim.cycles - c0;
+    sim.isr_cycles += c0;
+    if (c0 > sim.isr_max) sim.isr_max = c0;
+    sim.in_isr = 0;
+    sim.reg[SIM_INTCON] |= INT_GIE;
+}
+
+// ─── Timer0 ───────────────────────────────────────────────────────────
+static uint8_t t0_running(void) {
+    return !(sim.reg[SIM_OPTION_REG] & OPT_T0CS);
+}
+
+// Vorteiler als Zweierpotenz: 1 << t0_shift()
+static unsigned t0_shift(void) {
+    uint8_t opt = sim.reg[SIM_OPTION_REG];
+    if (opt & OPT_PSA) return 0u;
+    return (opt & 0x07u) + 1u;
+}
+
+static uint32_t t0_prescale(void) {
+    return 1u << t0_shift();
+}
+
+static uint64_t t0_cycles_to_overflow(void) {
+    uint64_t pre = t0_prescale();
+    if (sim.t0_pre >= pre) sim.t0_pre = 0;     // PS während des Laufs geändert
+    return sim.t0_hold + (256u - sim.reg[SIM_TMR0]) * pre - sim.t0_pre;
+}
+
+static void t0_tick(uint64_t n) {
+    unsigned sh = t0_shift();
+    uint64_t total, tmr;
+
+    if (sim.t0_hold) {                  // Sperre nach Schreiben
+        uint64_t h = n < sim.t0_hold ? n : sim.t0_hold;
+        sim.t0_hold -= (uint8_t)h;
+        n -= h;
+    }
+    total = sim.t0_pre + n;
+    tmr   = sim.reg[SIM_TMR0] + (total >> sh);
+    sim.t0_pre = (uint32_t)(total & ((1u << sh) - 1u));
+    if (tmr >= 256u) sim.reg[SIM_INTCON] |= INT_T0IF;
+    sim.reg[SIM_TMR0] = sim.t0_seen = (uint8_t)tmr;
+}
+
+#if defined(_16F1825)
+// OSCCON.IRCF → HFINTOSC/MFINTOSC/LFINTOSC (DS41440E, Table 5-1)
+static uint32_t ircf_hz(uint8_t osccon) {
+    static const uint32_t tab[16] = {
+        31000u, 31000u, 31250u, 31250u, 62500u, 125000u, 250000u, 500000u,
+        125000u, 250000u, 500000u, 1000000u, 2000000u, 4000000u, 8000000u, 16000000u,
+    };
+    uint8_t  ircf = (osccon >> 3) & 0x0Fu;
+    uint32_t hz   = tab[ircf];
+    if ((osccon & 0x80u) && ircf == 0x0Eu) hz = 32000000u;   // SPLLEN
+    return hz;
+}
+
+// ─── Timer2 (läuft nur mit Kerntakt, steht im SLEEP) ──────────────────
+static uint32_t t2_prescale(void) {
+    return 1u << ((sim.reg[SIM_T2CON] & 0x03u) * 2u);   // 1, 4, 16, 64
+}
+
+static uint64_t t2_period(void) {
+    return (uint64_t)(sim.reg[SIM_PR2] + 1u) * t2_prescale() *
+           (((sim.reg[SIM_T2CON] >> 3) & 0x0Fu) + 1u);
+}
+
+static uint8_t t2_running(void) {
+    return (sim.reg[SIM_T2CON] & 0x04u) != 0;
+}
+
+static void t2_tick(uint64_t n) {
+    uint64_t per = t2_period();
+    sim.t2_pos += n;
+    if (sim.t2_pos >= per) {
+        sim.t2_pos %= per;
+        sim.reg[SIM_PIR1] |= 0x02u;     // TMR2IF
+    }
+    sim.reg[SIM_TMR2] = sim.t2_seen =       // t2_pos < Periode (32 Bit)
+        (uint8_t)((uint32_t)sim.t2_pos / t2_prescale() % (sim.reg[SIM_PR2] + 1u));
+}
+
+// ─── Timer1: LFINTOSC → T1CKPS → TMR1H:L (läuft auch im SLEEP) ────────
+// Zählerstand aus der Zeit seit t1_ref_ns, damit auch lange Schlaf-
+// phasen ohne Schritt-für-Schritt-Zählen genau bleiben. Neu bezogen
+// wird nur beim Schreiben von TMR1H/L, Ein-/Ausschalten und beim
+// Wechsel des Vorteilers. Andere Taktquellen: Timer1 steht.
+static uint8_t t1_running(void) {
+    uint8_t c = sim.reg[SIM_T1CON];
+    return (c & 0x01u) && (c & 0xC0u) == 0xC0u;
+}
+
+static double t1_ns_per_count(void) {
+    return (double)(1u << ((sim.reg[SIM_T1CON] >> 4) & 0x03u)) * 1e9 / sim.lfintosc_hz;
+}
+
+static uint32_t t1_value(void) {
+    if (!sim.t1_on) return sim.t1_base;
+    return sim.t1_base + (uint32_t)((double)(sim.now_ns - sim.t1_ref_ns) / t1_ns_per_count());
+}
+
+static void t1_sync(void) {
+    uint16_t reg = (uint16_t)(sim.reg[SIM_TMR1H] << 8 | sim.reg[SIM_TMR1L]);
+    uint32_t v   = t1_value();
+
+    if (reg != sim.t1_seen) v = reg;                 // Firmware hat geschrieben
+    while (v >= 0x10000u) {
+        sim.reg[SIM_PIR1] |= 0x01u;                  // TMR1IF
+        v            -= 0x10000u;
+        sim.t1_base  -= 0x10000u;                    // Bezug bleibt, Überlauf gezählt
+    }
+    if (reg != sim.t1_seen || sim.reg[SIM_T1CON] != sim.t1con_seen ||
+        t1_running() != sim.t1_on) {
+        sim.t1_base    = v;
+        sim.t1_ref_ns  = sim.now_ns;
+        sim.t1_on      = t1_running();
+        sim.t1con_seen = sim.reg[SIM_T1CON];
+    }
+    sim.reg[SIM_TMR1L] = (uint8_t)v;
+    sim.reg[SIM_TMR1H] = (uint8_t)(v >> 8);
+    sim.t1_seen        = (uint16_t)v;
+}
+
+// Zeitpunkt des nächsten Überlaufs (SIM_FOREVER: steht)
+static uint64_t t1_overflow_ns(void) {
+    if (!sim.t1_on) return SIM_FOREVER;
+    return sim.t1_ref_ns + (uint64_t)((0x10000u - sim.t1_base) * t1_ns_per_count()) + 1u;
+}
+
+// ─── CPS: Touch-Fläche an RA2 (CPS2) als Timer0-Takt ──────────────────
+// Frequenz ∝ Ladestrom des Bereichs (0,1 / 1,2 / 18 µA), cps_hz gilt
+// für den hohen; Berührung = mehr Kapazität = langsamer. Timer0 zählt
+// ohne Vorteiler-Sperre, steht im SLEEP wie mit Fosc/4.
+static uint8_t cps_counting(void) {
+    return (sim.reg[SIM_OPTION_REG] & OPT_T0CS) &&
+           (sim.reg[SIM_CPSCON0] & 0x81u) == 0x81u;         // CPSON, T0XCS
+}
+
+static double cps_osc_hz(void) {
+    static const double rng[4] = { 0.0, 0.1 / 18.0, 1.2 / 18.0, 1.0 };
+    double f = sim.cps_hz + sim.cps_drift * (double)sim.now_ns / 1e9;
+
+    if ((sim.reg[SIM_CPSCON1] & 0x0Fu) == 2u && sim.button)
+        f *= 1.0 - sim.cps_touch_pct / 100.0;
+    if (f < 0.0) f = 0.0;
+    return f * rng[(sim.reg[SIM_CPSCON0] >> 2) & 0x03u];
+}
+
+static void cps_tick(uint64_t n) {
+    double   c = sim.cps_frac + (double)n * sim.tcy_ns * cps_osc_hz() / 1e9;
+    uint64_t whole = (uint64_t)c, tmr;
+
+    sim.cps_frac = c - (double)whole;
+    tmr = sim.reg[SIM_TMR0] + whole;
+    if (tmr >= 256u) sim.reg[SIM_INTCON] |= INT_T0IF;
+    sim.reg[SIM_TMR0] = sim.t0_seen = (uint8_t)tmr;
+}
+
+// ─── ADC: VREF+ = VDD, nur Kanal FVR (CHS = 11111) beschaltet ─────────
+// GO legt den Fertig-Zeitpunkt fest; erst ein Zugriff danach sieht
+// GO = 0 und das Ergebnis (die Firmware pollt GO).
+static uint64_t adc_tad_ns(void) {
+    static const uint8_t div[3] = { 2u, 8u, 32u };     // ADCS<1:0>, Bit 2 = ×2
+    uint8_t cs = (sim.reg[SIM_ADCON1] >> 4) & 0x07u;
+
+    if ((cs & 0x03u) == 0x03u) return 1600u;           // FRC, typ. 1,6 µs
+    return (uint64_t)((div[cs & 0x03u] << (cs >> 2)) * 1e9 / sim.fosc_hz);
+}
+
+static uint16_t adc_value(void) {
+    uint8_t  fvr = sim.reg[SIM_FVRCON];
+    uint32_t mv;
+
+    if (((sim.reg[SIM_ADCON0] >> 2) & 0x1Fu) != 0x1Fu) return 0;
+    if (!(fvr & 0x80u) || !(fvr & 0x03u)) return 0;
+    mv = 512u << (fvr & 0x03u);                         // 1,024 / 2,048 / 4,096 V
+    if (!sim.vdd_mv || mv >= sim.vdd_mv) return 1023u;
+    return (uint16_t)(1023.0 * mv / sim.vdd_mv + 0.5);
+}
+
+static void adc_sync(void) {
+    uint8_t  ana = (uint8_t)((sim.reg[SIM_FVRCON] & 0x80u) | (sim.reg[SIM_ADCON0] & 0x01u) |
+                             ((sim.reg[SIM_CPSCON0] & 0x80u) ? 0x02u : 0u) |
+                             ((sim.reg[SIM_WDTCON] & 0x01u) << 2));
+    uint16_t r;
+
+    if (ana != sim.ana_seen) {                          // Strom ändert sich (auch CPS, WDT)
+        if (sim.on_clock) sim.on_clock();
+        sim.ana_seen = ana;
+    }
+    if (!(sim.reg[SIM_ADCON0] & 0x01u)) {               // ADON = 0: bricht ab
+        sim.reg[SIM_ADCON0] &= (uint8_t)~0x02u;
+        sim.adc_done_ns = 0;
+        return;
+    }
+    if ((sim.reg[SIM_ADCON0] & 0x02u) && !sim.adc_done_ns)
+        sim.adc_done_ns = sim.now_ns + adc_tad_ns() * 23u / 2u;
+    if (sim.adc_done_ns && sim.now_ns >= sim.adc_done_ns) {
+        r = adc_value();
+        if (!(sim.reg[SIM_ADCON1] & 0x80u)) r = (uint16_t)(r << 6);   // ADFM = 0: linksbündig
+        sim.reg[SIM_ADRESL]  = (uint8_t)r;
+        sim.reg[SIM_ADRESH]  = (uint8_t)(r >> 8);
+        sim.reg[SIM_ADCON0] &= (uint8_t)~0x02u;
+        sim.reg[SIM_PIR1]   |= 0x40u;                   // ADIF
+        sim.adc_done_ns      = 0;
+        sim.adc_convs++;
+    }
+}
+
+// ─── Watchdog (CONFIG WDTE = SWDTEN) ──────────────────────────────────
+static uint64_t wdt_period_ns(void) {
+    uint8_t ps = (sim.reg[SIM_WDTCON] >> 1) & 0x1Fu;
+    return (uint64_t)((32.0 * (double)(1ull << ps)) * 1e9 / sim.lfintosc_hz);
+}
+
+static void wdt_check(void) {
+    uint8_t on = sim.reg[SIM_WDTCON] & 0x01u;
+    if (on && !sim.wdt_on) sim.wdt_clear_ns = sim.now_ns;   // Einschalten
+    sim.wdt_on = on;
+    if (on && sim.now_ns >= sim.wdt_clear_ns + wdt_period_ns()) {
+        sim.wdt_resets++;                   // echter Chip: Reset
+        sim.wdt_clear_ns = sim.now_ns;
+    }
+}
+#endif
+
+// ─── Zeit vorrücken (Kern läuft) ──────────────────────────────────────
+void sim_delay_cycles(uint64_t n) {
+    while (n) {
+        uint64_t step = n, c;
+
+        apply_edges();
+        sync();
+#if defined(_16F1825)
+        if (ircf_hz(sim.reg[SIM_OSCCON]) != sim.fosc_hz) {
+            if (sim.on_clock) sim.on_clock();
+            set_fosc(ircf_hz(sim.reg[SIM_OSCCON]));
+        }
+        wdt_check();
+#endif
+        if (sim.now_ns >= sim.end_ns) finish();
+
+        if (t0_running()) {
+            c = t0_cycles_to_overflow();
+            if (c < step) step = c;
+        }
+#if defined(_16F1825)
+        if (t2_running() && sim.t2_pos >= t2_period()) sim.t2_pos = 0;
+#endif
+        // Jede weitere Grenze liegt ≥ 1 Tcy voraus: Einzelschritte (SFR-
+        // Zugriff, der häufigste Fall) brauchen sie nicht
+        if (step > 1u) {
+#if defined(_16F1825)
+            if (t2_running()) {
+                c = t2_period() - sim.t2_pos;
+                if (c < step) step = c;
+            }
+#endif
+            if (sim.next_edge < sim.n_edges) {
+                c = cycles_until(sim.edges[sim.next_edge].t_ns);
+                if (c && c < step) step = c;
+            }
+            c = cycles_until(sim.end_ns);
+            if (c && c < step) step = c;
+        }
+
+        if (t0_running()) t0_tick(step);
+#if defined(_16F1825)
+        else if (cps_counting()) cps_tick(step);
+        if (t2_running()) t2_tick(step);
+#endif
+        sim.cycles += step;
+        {
+            uint64_t t0 = sim.now_ns;
+            add_time((double)step * sim.tcy_ns);
+            sim.active_ns += sim.now_ns - t0;
+        }
+        n -= step;
+        dispatch();
+    }
+}
+
+// ─── Zeitraffer: NOP in Warteschleifen ────────────────────────────────
+// Die Firmware ruft NOP() nur in Warteschleifen auf eine Interrupt-
+// Folge (tmr0_count, GIE = 1) und hinter SLEEP (GIE = 0 → 1 Tcy wie
+// ohne Zeitraffer). Bis zum nächsten Ereignis,
+// das eine ISR auslösen oder ein Register ändern kann, sieht die Schleife
+// nichts Neues → in einem Schritt dorthin. Zyklen und Zeit zählen gleich,
+// nur die Schleife läuft einmal statt einige hundert Mal.
+static uint64_t cycles_to_event(void) {
+    uint64_t step = SIM_FOREVER, c;
+
+    if ((sim.reg[SIM_INTCON] & INT_GIE) && irq_pending()) return 1u;   // ISR sofort
+    if (t0_running()) step = t0_cycles_to_overflow();
+#if defined(_16F1825)
+    if (t2_running()) {
+        if (sim.t2_pos >= t2_period()) sim.t2_pos = 0;
+        c = t2_period() - sim.t2_pos;
+        if (c < step) step = c;
+    }
+    if (sim.t1_on && (c = cycles_until(t1_overflow_ns())) && c < step) step = c;
+    if (sim.adc_done_ns && (c = cycles_until(sim.adc_done_ns)) && c < step) step = c;
+    if (sim.wdt_on && (c = cycles_until(sim.wdt_clear_ns + wdt_period_ns())) && c < step)
+        step = c;
+#endif
+    if (sim.ee_busy && (c = cycles_until(sim.ee_done_ns)) && c < step) step = c;
+    if (sim.next_edge < sim.n_edges &&
+        (c = cycles_until(sim.edges[sim.next_edge].t_ns)) && c < step) step = c;
+    if ((c = cycles_until(sim.end_ns)) && c < step) step = c;
+    return step ? step : 1u;
+}
+
+void sim_nop(void) {
+    if (!sim.warp || !(sim.reg[SIM_INTCON] & INT_GIE)) {   // z. B. NOP hinter SLEEP
+        sim_delay_cycles(1u);
+        return;
+    }
+    apply_edges();                      // fällige Flanke → Flag vor dem Sprung
+    sync();
+    sim_delay_cycles(cycles_to_event());
+}
+
+volatile uint8_t *sim_reg(int idx) {
+    sim_delay_cycles(1u);
+#if defined(_16F84A)
+    if (idx == SIM_PORTB) {
+        uint8_t pb = sim.reg[SIM_PORTB] & (uint8_t)~BUTTON_BIT;
+        if (sim.pin) pb |= BUTTON_BIT;
+        sim.reg[SIM_PORTB] = pb;
+        sim.rb_latch = pb & 0xF0u;      // Lesen beendet den Mismatch
+    }
+    if (idx == SIM_PORTA && (sim.reg[SIM_TRISA] & RA4_BIT)) {
+        // RA4 als Eingang: Rechteck vom Prüfplatz (HIGH zuerst), offen = LOW
+        uint8_t pa = sim.reg[SIM_PORTA] & (uint8_t)~RA4_BIT;
+        if (sim.ref_hz) {
+            uint64_t per = 1000000000ull / sim.ref_hz;
+            if (sim.now_ns % per < per / 2u) pa |= RA4_BIT;
+        }
+        sim.reg[SIM_PORTA] = pa;
+    }
+#endif
+    return &sim.reg[idx];
+}
+
+// ─── SLEEP ────────────────────────────────────────────────────────────
+// T0IF kann im SLEEP nicht entstehen (Timer0 steht), ein schon
+// gesetztes Flag macht SLEEP aber wie jedes andere zum NOP.
+static uint8_t wake_pending(void) {
+    uint8_t ic = sim.reg[SIM_INTCON];
+    return ((ic & INT_T0IE) && (ic & INT_T0IF)) ||
+           ((ic & INT_INTE) && (ic & INT_INTF)) ||
+           ((ic & INT_RBIE) && (ic & INT_RBIF)) ||
+           periph_pending();
+}
+
+void sim_sleep(void) {
+    sim_delay_cycles(1u);
+    sim.reg[SIM_STATUS] = (uint8_t)((sim.reg[SIM_STATUS] & ~STATUS_NPD) | STATUS_NTO);
+    if (sim.on_sleep) sim.on_sleep();   // Test: Flag im letzten Takt davor
+    if (wake_pending()) return;         // Flag schon gesetzt → SLEEP = NOP
+
+    sim.asleep = 1;
+    sim.sleeps++;
+#if defined(_16F1825)
+    sim.wdt_clear_ns = sim.now_ns;      // SLEEP löscht den WDT
+#endif
+    for (;;) {
+        uint64_t t0  = sim.now_ns;
+        uint64_t t   = sim.end_ns;
+        uint8_t  wdt = 0;
+        if (sim.next_edge < sim.n_edges && sim.edges[sim.next_edge].t_ns < t)
+            t = sim.edges[sim.next_edge].t_ns;
+#if defined(_16F1825)
+        if ((sim.reg[SIM_WDTCON] & 0x01u) &&
+            sim.wdt_clear_ns + wdt_period_ns() <= t) {
+            t   = sim.wdt_clear_ns + wdt_period_ns();
+            wdt = 1;
+        }
+        if ((sim.reg[SIM_PIE1] & 0x01u) && t1_overflow_ns() < t) {
+            t   = t1_overflow_ns();
+            wdt = 0;
+        }
+#endif
+        if (t > sim.now_ns) { sim.now_ns = t; sim.frac_ns = 0.0; }
+        sim.sleep_ns += sim.now_ns - t0;
+        if (sim.now_ns >= sim.end_ns) finish();
+        if (wdt) {                      // WDT-Timeout im SLEEP = Wake, kein Reset
+            sim.reg[SIM_STATUS] &= (uint8_t)~STATUS_NTO;
+            sim.wdt_wakes++;
+            break;
+        }
+        apply_edges();
+#if defined(_16F1825)
+        t1_sync();
+#endif
+        if (wake_pending()) break;
+    }
+#if defined(_16F1825)
+    sim.wdt_clear_ns = sim.now_ns;      // Wake löscht den WDT
+#endif
+    sim.asleep = 0;
+}
+
+void sim_clrwdt(void) {
+    sim_delay_cycles(1u);
+#if defined(_16F1825)
+    sim.wdt_clear_ns = sim.now_ns;
+#endif
+}
+
+// ─── Harness-Schnittstelle ────────────────────────────────────────────
+void sim_reset(uint32_t fosc_hz) {
+    free(sim.edges);
+    memset(&sim, 0, sizeof sim);        // sim_ee bleibt (nicht flüchtig)
+    sim.end_ns = SIM_FOREVER;
+    if (!sim_ee.init) sim_ee_erase();
+
+    // Power-On-Reset-Werte (Datenblatt)
+    sim.reg[SIM_OPTION_REG] = 0xFFu;
+    sim.reg[SIM_STATUS]     = 0x18u;
+    sim.reg[SIM_TRISA]      = 0xFFu;
+#if defined(_16F84A)
+    sim.reg[SIM_TRISB]      = 0xFFu;
+    set_fosc(fosc_hz);
+#else
+    sim.reg[SIM_TRISC]      = 0xFFu;
+    sim.reg[SIM_ANSELA]     = 0x17u;
+    sim.reg[SIM_ANSELC]     = 0x0Fu;
+    sim.reg[SIM_WPUA]       = 0x3Fu;
+    sim.reg[SIM_WPUC]       = 0x3Fu;
+    sim.reg[SIM_OSCCON]     = 0x38u;    // 500 kHz MFINTOSC
+    sim.reg[SIM_WDTCON]     = 0x16u;    // WDTPS = 1:65536 (2 s), SWDTEN = 0
+    sim.reg[SIM_PR2]        = 0xFFu;
+    sim.lfintosc_hz         = 31000u;
+    sim.vdd_mv              = 3000u;    // 2×AAA frisch
+    sim.cps_hz              = 600000u;  // ~10 pF Fläche, 18 µA
+    sim.cps_touch_pct       = 20u;      // Finger ~+2,5 pF
+    (void)fosc_hz;                      // Takt folgt OSCCON
+    set_fosc(ircf_hz(sim.reg[SIM_OSCCON]));
+#endif
+    sim.pin = button_level();
+}
+
+void sim_attach_isr(void (*isr)(void)) {
+    sim.isr = isr;
+}
+
+void sim_button(uint64_t t_ns, uint8_t pressed) {
+    if (sim.n_edges == sim.cap_edges) {
+        sim.cap_edges = sim.cap_edges ? 2u * sim.cap_edges : 64u;
+        sim.edges = realloc(sim.edges, sim.cap_edges * sizeof *sim.edges);
+        if (!sim.edges) abort();
+    }
+    sim.edges[sim.n_edges].t_ns    = t_ns;
+    sim.edges[sim.n_edges].pressed = pressed ? 1u : 0u;
+    sim.n_edges++;
+}
+
+void sim_press(uint64_t t_ns, uint64_t hold_ns) {
+    sim_button(t_ns, 1u);
+    sim_button(t_ns + hold_ns, 0u);
+}
+
+int sim_run(void (*entry)(void), uint64_t until_ns) {
+    jmp_buf  jb;
+    jmp_buf *outer = sim.jmp;
+    uint64_t end   = sim.end_ns;
+
+    sim.jmp    = &jb;
+    sim.end_ns = until_ns;
+    if (setjmp(jb) == 0) {
+        entry();
+        sync();
+        sim.jmp    = outer;
+        sim.end_ns = end;
+        return 0;                       // Funktion ist zurückgekehrt
+    }
+    sim.jmp    = outer;
+    sim.end_ns = end;
+    sim.asleep = 0;
+    if (sim.in_isr) {                   // Abbruch mitten in der ISR
+        sim.in_isr = 0;
+        sim.reg[SIM_INTCON] |= INT_GIE;
+    }
+    return 1;                           // Zeitlimit erreicht
+}
@@ -0,0 +1,177 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  Host-Simulation  ·  Registerdatei + virtuelle Uhr
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Ersetzt auf dem PC die Special-Function-Register des PIC durch eine
+ *  simulierte Registerdatei. Jeder Registerzugriff aus der Firmware
+ *  kostet 1 Befehlszyklus, __delay_ms()/NOP() schieben die virtuelle
+ *  Uhr weiter, SLEEP() springt bis zum nächsten Weck-Ereignis.
+ *
+ *  Chip-Auswahl wie bei XC8 über das Makro des Zielchips:
+ *    -D_16F84A   → main.c       (PORTB/TRISB/OPTION_REG)
+ *    -D_16F1825  → main_1825.c  (LATA/LATC/PORTA/IOCAF/OSCCON)
+ *    -DDICE_N=2|3 (nur 16F1825): Würfel-Auswahl RA0–RA2 → sim.die
+ *
+ *  Zeitbasis:  now_ns + frac_ns  (ganzzahlige ns + Nachkommaanteil)
+ *              → auch Jahre Gerätezeit ohne Rundungsdrift
+ *  Timer0:     Schreiben auf TMR0 löscht den Vorteiler und sperrt den
+ *              Zähler 2 Tcy (erkannt beim nächsten Zugriff, wie TMR2);
+ *              16F1825: TMR0CS + T0XCS → zählt den CPS-Oszillator
+ *  Zeitraffer: sim.warp = 1 → NOP() in Warteschleifen springt bis zum
+ *              nächsten Timer-/Taster-Ereignis statt Tcy für Tcy
+ *
+ *  Daten-EEPROM (sim_ee) liegt außerhalb von sim und übersteht
+ *  sim_reset() wie im echten Chip das Aus- und Einschalten.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <setjmp.h>
+
+#if !defined(_16F84A) && !defined(_16F1825)
+#error "Zielchip fehlt: -D_16F84A oder -D_16F1825 angeben"
+#endif
+
+#define SIM_MS(x)   ((uint64_t)(x) * 1000000ull)   // ms → ns
+#define SIM_FOREVER UINT64_MAX
+
+#if defined(_16F84A)
+#define SIM_EE_SIZE  64u
+#else
+#define SIM_EE_SIZE  256u
+#endif
+#define SIM_EE_WRITE_NS  SIM_MS(4)     // Schreibzeit je Byte (TDEW typ.)
+
+// ─── Registerdatei (Indizes, nicht Adressen!) ─────────────────────────
+enum {
+    SIM_INTCON, SIM_OPTION_REG, SIM_TMR0, SIM_STATUS,
+    SIM_PORTA, SIM_TRISA,
+    SIM_EEDATA, SIM_EEADR, SIM_EECON1, SIM_EECON2,   // 16F1825: EEDATL, EEADRL
+#if defined(_16F84A)
+    SIM_PORTB, SIM_TRISB,
+#else
+    SIM_PORTC, SIM_TRISC, SIM_LATA, SIM_LATC,
+    SIM_ANSELA, SIM_ANSELC, SIM_WPUA, SIM_WPUC,
+    SIM_IOCAP, SIM_IOCAN, SIM_IOCAF, SIM_OSCCON, SIM_WDTCON,
+    SIM_PIR1, SIM_PIE1, SIM_T2CON, SIM_PR2, SIM_TMR2,
+    SIM_T1CON, SIM_TMR1L, SIM_TMR1H,
+    SIM_FVRCON, SIM_ADCON0, SIM_ADCON1, SIM_ADRESL, SIM_ADRESH,
+    SIM_CPSCON0, SIM_CPSCON1,
+#endif
+    SIM_NREG
+};
+
+// ─── Eingangsflanke am Taster (RB7 bzw. RA4) ─────────────────────────
+// 16F1825: dieselben Flanken berühren die Touch-Fläche an RA2 (CPS2)
+struct sim_edge {
+    uint64_t t_ns;
+    uint8_t  pressed;       // 1 = Taster gedrückt (Pin LOW) bzw. Fläche berührt
+};
+
+struct sim_state {
+    // Zeit
+    uint64_t now_ns;
+    double   frac_ns;
+    uint64_t cycles;        // ausgeführte Befehlszyklen (Tcy)
+    uint64_t active_ns;     // Zeit mit laufendem Kern
+    uint64_t sleep_ns;      // Zeit im SLEEP
+    uint64_t end_ns;        // Simulationsende → longjmp aus der Firmware
+    uint32_t fosc_hz;       // tatsächliche Oszillatorfrequenz
+    double   tcy_ns;        // 4 / Fosc
+
+    // Peripherie
+    uint8_t  reg[SIM_NREG];
+    uint32_t t0_pre;        // Vorteiler-Zähler Timer0
+    uint8_t  t0_seen;       // TMR0 nach dem letzten Zählen (Schreiben erkennen)
+    uint8_t  t0_hold;       // Tcy Sperre nach Schreiben auf TMR0 (2)
+    uint8_t  button;        // 1 = gedrückt
+    uint8_t  pin;           // aktueller Pegel Taster-Pin
+    uint8_t  leds;          // sichtbares LED-Muster, Bit 0..6 = a..g
+    uint8_t  die;           // DICE_N > 1: gewählter Würfel (RA0–RA2)
+#if defined(_16F84A)
+    uint8_t  rb_latch;      // RB7:RB4 beim letzten PORTB-Lesen (RBIF)
+    uint32_t ref_hz;        // Referenztakt an RA4 (Prüfplatz), 0 = offen
+#else
+    uint8_t  porta_seen, portc_seen;   // PORTx-Schreiben → LATx
+    uint8_t  wdt_on;        // SWDTEN beim letzten Zugriff
+    uint64_t wdt_clear_ns;  // letzter WDT-Reset (SLEEP, CLRWDT, Wake)
+    uint32_t lfintosc_hz;   // WDT-Taktquelle, nominal 31 kHz
+    uint64_t t2_pos;        // Tcy seit letztem TMR2IF
+    uint8_t  t2_seen;       // TMR2 nach dem letzten Zählen (Schreiben erkennen)
+    uint8_t  t1_on;         // Timer1 zählt (LFINTOSC, TMR1ON)
+    uint8_t  t1con_seen;
+    uint16_t t1_seen;       // TMR1H:L nach dem letzten Zählen
+    uint32_t t1_base;       // Stand bei t1_ref_ns (+ 65536 je Überlauf)
+    uint64_t t1_ref_ns;
+    uint16_t vdd_mv;        // Versorgung für den ADC (FVR gegen VDD)
+    uint64_t adc_done_ns;   // laufende Wandlung fertig (0 = keine)
+    uint8_t  ana_seen;      // FVREN | ADON | CPSON | SWDTEN beim letzten Zugriff (Strom)
+    uint32_t cps_hz;        // CPS-Oszillator an RA2, hoher Bereich, unberührt
+    uint8_t  cps_touch_pct; // Frequenzabfall bei Berührung [%]
+    double   cps_drift;     // Hz/s (Feuchte, Temperatur)
+    double   cps_frac;      // Bruchteil einer Schwingung für Timer0
+#endif
+    uint8_t  ee_unlock;     // 55/AA-Folge: 1 = 55 gesehen, 2 = 55 AA
+    uint8_t  ee_busy;       // Schreibvorgang läuft
+    uint8_t  ee_addr, ee_data;
+    uint64_t ee_done_ns;
+
+    // Statistik
+    uint64_t frames;
+    uint64_t isr_calls;
+    uint64_t isr_cycles;    // Tcy in der ISR inkl. Ein-/Rücksprung
+    uint64_t isr_max;       // längster einzelner ISR-Aufruf [Tcy]
+    uint64_t mux_overlap;   // DICE_N > 1: mehrere Würfel zugleich gewählt
+    uint64_t sleeps;
+    uint64_t wdt_wakes;     // Weck-Ereignisse durch WDT-Timeout
+    uint64_t wdt_resets;    // WDT-Überlauf bei laufendem Kern (= Reset!)
+    uint64_t ee_writes;     // abgeschlossene EEPROM-Schreibvorgänge
+    uint64_t adc_convs;     // abgeschlossene ADC-Wandlungen (16F1825)
+
+    // Ablauf
+    uint8_t  in_isr;
+    uint8_t  asleep;
+    uint8_t  warp;          // 1 = NOP rückt bis zum nächsten Ereignis vor
+    void   (*isr)(void);
+    void   (*on_frame)(uint64_t t_ns, uint8_t leds);
+    void   (*on_clock)(void);   // vor jedem Takt- oder FVR/ADC-Wechsel (16F1825),
+                                // nach jeder Tasterflanke
+    void   (*on_sleep)(void);   // beim SLEEP-Befehl, vor der Weck-Prüfung
+    jmp_buf *jmp;
+
+    // Eingangs-Skript (zeitlich sortiert)
+    struct sim_edge *edges;
+    size_t   n_edges, cap_edges, next_edge;
+};
+
+extern struct sim_state sim;
+
+// ─── Daten-EEPROM (nicht flüchtig) ────────────────────────────────────
+struct sim_eeprom {
+    uint8_t  data[SIM_EE_SIZE];
+    uint64_t wear[SIM_EE_SIZE];    // Schreibzyklen je Byte
+    uint8_t  init;                 // 0 = noch nie gelöscht
+};
+
+extern struct sim_eeprom sim_ee;
+
+void sim_ee_erase(void);           // Auslieferungszustand: alles 0xFF
+
+void sim_reset(uint32_t fosc_hz);
+void sim_attach_isr(void (*isr)(void));
+void sim_button(uint64_t t_ns, uint8_t pressed);
+void sim_press(uint64_t t_ns, uint64_t hold_ns);
+int  sim_run(void (*entry)(void), uint64_t until_ns);
+
+// Von der xc.h-Attrappe benutzt
+volatile uint8_t *sim_reg(int idx);
+void sim_delay_cycles(uint64_t n);
+void sim_nop(void);
+void sim_sleep(void);
+void sim_clrwdt(void);
+
+#endif
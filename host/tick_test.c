@@ -0,0 +1,184 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  tick_test  ·  Tick-Uhr mit Rechenzeit in step()
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Die Simulation berechnet nur SFR-Zugriffe, der C-Code dazwischen
+ *  kostet nichts. Auf dem Chip braucht step() aber Zeit (Frame ausgeben,
+ *  anim_step(), rng_roll() mit bis zu 10 xorshift-Runden, vdd_check(),
+ *  touch_scan()) — läuft dabei ein Tick ab, muss wait_next() ihn
+ *  nachtragen, sonst geht now nach und jede Animation wird langsamer
+ *  und ungleichmäßig.
+ *
+ *  Hier kostet jeder Aufruf von step() zusätzlich n Tcy (gcc
+ *  -finstrument-functions: beim Eintritt sim_delay_cycles(n), Timer und
+ *  ISR laufen weiter). Je n: einschalten, nach 3 s würfeln (Profil voll),
+ *  jeden Termin anim_due() mitschreiben. Verglichen mit n = 0 muss jeder
+ *  Termin gleich oft und höchstens 2 × (n Tcy + 1 Tick) später kommen
+ *  (einmal beim Druck, einmal beim Termin); n Tcy beim langsamsten Takt
+ *  (16F84A -f, 16F1825 CLK_MF 500 kHz). Touch: ab dem Druck dazu
+ *  ein Scan-Raster, die Fläche wird erst beim nächsten Scan erkannt.
+ *  16F84A mit BOARD_RC_CAL: 1 kHz an RA4 (Prüfplatz) → kalibrierter
+ *  Tick, „Druck→fertig“ muss dann bei jedem RC-Takt gleich lang sein.
+ *
+ *  Build (16F1825 auch mit -DBOARD_TOUCH=1):
+ *    gcc -O2 -D_16F84A -Ihost -finstrument-functions \
+ *        -finstrument-functions-exclude-file-list=sim.c \
+ *        -o tick_test_84a host/tick_test.c host/sim.c
+ *    (16F1825: -D_16F1825, Ausgabe tick_test_1825)
+ *
+ *  Aufruf:
+ *    tick_test [-f rc_hz]      (16F84A: RC-Takt, Vorgabe 709000)
+ *
+ *  Rückgabe: 0 = alle Termine im Rahmen, 1 = Fehler, 2 = Aufruf
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "sim.h"
+
+#define main fw_main
+#if defined(_16F84A)
+#include "../main.c"
+#define FW_NAME    "PIC16F84A"
+#define FW_ARGS    " [-f rc_hz]"
+#define TCY_MAX_NS (4e9 / fosc)
+#else
+#include "../main_1825.c"
+#define FW_NAME    "PIC16F1825"
+#define FW_ARGS    ""
+#define TCY_MAX_NS 8000.0        // CLK_MF, 500 kHz
+#endif
+#undef main
+
+#define NO_INSTR  __attribute__((no_instrument_function))
+#define PRESS_MS  3000u
+#define END_MS    9000u
+#define MAX_DUE   160u
+#if BOARD_TOUCH
+#define SCAN_NS   SIM_MS(17)    // Druck erst beim nächsten Scan (WDT ~16 ms)
+#else
+#define SCAN_NS   0u
+#endif
+
+static const unsigned COST[] = { 0u, 100u, 200u, 400u, 800u };
+#define N_COST  (sizeof COST / sizeof COST[0])
+
+struct run {
+    uint64_t boot;              // startup_done()
+    uint64_t result, done;      // rng_roll(), finish_roll() ab dem Druck
+    uint64_t due[MAX_DUE];      // jeder anim_due()
+    unsigned n_due;
+};
+
+static struct run *runs, *cur;
+static unsigned    cost;
+#if defined(_16F84A)
+static uint32_t    fosc = 709000u;
+#else
+static uint32_t    fosc;         // 16F1825: Takt aus OSCCON
+#endif
+
+// ─── Rechenzeit und Termine ───────────────────────────────────────────
+NO_INSTR void __cyg_profile_func_enter(void *fn, void *site) {
+    (void)site;
+    if (fn == (void *)step) {
+        if (cost) sim_delay_cycles(cost);
+    } else if (fn == (void *)anim_due) {
+        if (cur->n_due < MAX_DUE) cur->due[cur->n_due++] = sim.now_ns;
+    } else if (fn == (void *)rng_roll) {
+        if (sim.now_ns >= SIM_MS(PRESS_MS) && !cur->result)
+            cur->result = sim.now_ns - SIM_MS(PRESS_MS);
+    }
+}
+
+NO_INSTR void __cyg_profile_func_exit(void *fn, void *site) {
+    (void)site;
+    if (fn == (void *)startup_done) {
+        if (!cur->boot) cur->boot = sim.now_ns;
+    } else if (fn == (void *)finish_roll) {
+        if (!cur->done) cur->done = sim.now_ns - SIM_MS(PRESS_MS);
+    }
+}
+
+// ─── Ein Lauf im Kind (Firmware-Variablen frisch) ────────────────────
+static NO_INSTR void run(unsigned k) {
+    pid_t pid;
+    int   st;
+
+    fflush(stdout);
+    pid = fork();
+    if (pid == 0) {
+        cur  = &runs[k];
+        cost = COST[k];
+        sim_reset(fosc);
+#if BOARD_RC_CAL
+        sim.ref_hz = CAL_HZ;         // Prüfplatz: kalibrierter Tick
+#endif
+        sim_attach_isr(isr);
+        sim.warp = 1;
+        sim_press(SIM_MS(PRESS_MS), SIM_MS(100));
+        sim_run(fw_main, SIM_MS(END_MS));
+        _exit(0);
+    }
+    if (pid > 0) waitpid(pid, &st, 0);
+}
+
+static NO_INSTR double ms(uint64_t ns) {
+    return ns / 1e6;
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+NO_INSTR int main(int argc, char **argv) {
+    const struct run *r0;
+    unsigned k, i, bad = 0;
+
+#if defined(_16F84A)
+    if (argc == 3 && !strcmp(argv[1], "-f")) fosc = (uint32_t)strtoul(argv[2], NULL, 10);
+    else if (argc != 1) goto usage;
+    if (fosc < 100000u || fosc > 2000000u) goto usage;
+#else
+    if (argc != 1) goto usage;
+#endif
+    runs = mmap(NULL, N_COST * sizeof *runs, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (runs == MAP_FAILED) { perror("mmap"); return 1; }
+    for (k = 0; k < N_COST; k++) run(k);
+
+    r0 = &runs[0];
+    printf("# %s  tick_test  Rechenzeit je step(), Wurf bei %u ms", FW_NAME, PRESS_MS);
+#if defined(_16F84A)
+    printf(", RC %lu Hz, %s", (unsigned long)fosc,
+           BOARD_RC_CAL ? "kalibriert" : "ohne Kalibrierung");
+#endif
+    printf("\n");
+    printf("Tcy/step  Einschalten  Druck→Ergebnis  Druck→fertig  Termine  Abw. max  Grenze\n");
+    for (k = 0; k < N_COST; k++) {
+        const struct run *r = &runs[k];
+        double lim = 2.0 * (COST[k] * TCY_MAX_NS + TICK_US * 1000.0) + 1e6;
+        double dev = 0.0, d;
+        int    ok  = r->boot && r->result && r->done && r->n_due == r0->n_due;
+
+        for (i = 0; i < r->n_due && i < r0->n_due; i++) {
+            d = (double)r->due[i] - (double)r0->due[i];
+            if (d < 0) d = -d;
+            if (r0->due[i] >= SIM_MS(PRESS_MS)) d -= SCAN_NS;
+            if (d > dev) dev = d;
+        }
+        if (dev > lim) ok = 0;
+        bad += !ok;
+        printf("%8u  %8.1f ms  %11.1f ms  %9.1f ms  %3u/%-3u  %5.2f ms  %5.2f ms  %s\n",
+               COST[k], ms(r->boot), ms(r->result), ms(r->done), r->n_due, r0->n_due,
+               ms((uint64_t)dev), lim / 1e6, ok ? "ok" : "FEHLER");
+    }
+    printf("%s\n", bad ? "FEHLER" : "ok");
+    return bad ? 1 : 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s" FW_ARGS "\n", argv[0]);
+    return 2;
+}
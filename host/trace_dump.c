@@ -0,0 +1,316 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  trace_dump  ·  Ereignis-Protokoll aus dem EEPROM lesen (PIC16F1825)
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Dekodiert den Protokoll-Ring der Firmware (dice_core.h, BOARD_TRACE):
+ *  Zeitleiste aller Einträge ab dem ältesten, dazu Latenz-Histogramme
+ *    Flanke → Druck      Entprellen (erste Flanke bis EV_PRESS)
+ *    Druck → 1. Frame    bis der Wurf sichtbar startet
+ *    Wake → Anzeige      nach dem SLEEP bis zur letzten Zahl
+ *  Die Uhr steht im Auto-Sleep: wie lange das Gerät schlief, steht
+ *  nicht im Protokoll (Zeile „Schlaf“), die Zeiten sind Wachzeit.
+ *
+ *  Quelle ist entweder ein EEPROM-Abbild vom Gerät oder die Simulation:
+ *  die Firmware läuft wie in dice_sim (host/sim.c), danach wird das
+ *  simulierte EEPROM dekodiert — nur was vor dem letzten SLEEP kopiert
+ *  wurde, wie beim echten Gerät.
+ *
+ *  Build:
+ *    gcc -O2 -D_16F1825 -Ihost -o trace_dump host/trace_dump.c host/sim.c
+ *
+ *  Aufruf:
+ *    trace_dump [-q] datei
+ *      datei  Intel-HEX (MPLAB IPE, EEPROM ab 0xF000 = Byte 0x1E000,
+ *             oder EEPROM-Export ab 0) bzw. 256 Byte binär
+ *    trace_dump [-t ms] [-p ms:halten_ms[:prellen]]... [-o datei] [-q]
+ *      -t   Simulationsdauer (Default 30000 ms)
+ *      -p   Tastendruck bei ms (aufsteigend), prellen = Zusatzflanken
+ *           je Druck und Loslassen im Abstand 0,3 ms (Default 0)
+ *      -o   simuliertes EEPROM binär speichern (256 Byte)
+ *      -q   keine Zeitleiste, nur Histogramme
+ *
+ *  Rückgabe: 0 = ok, 1 = Datei unlesbar, 2 = Aufruf
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim.h"
+
+// ─── Firmware einbinden (Codes, Ring-Lage, Tick) ─────────────────────
+#define main fw_main
+#include "../main_1825.c"
+#undef main
+
+#if !BOARD_TRACE
+#error "trace_dump braucht BOARD_TRACE = 1"
+#endif
+
+#define TICK_MS   (TICK_US / 1000.0)
+
+static const char *const TR_NAME[] = {
+    "Einschalten", "Flanke", "Druck", "Loslassen", "Störimpuls",
+    "lang gedrückt", "1. Frame", "Wurf", "Sleep", "Wake", "Anzeige",
+    "verloren", "Profil"
+};
+static const char *const PROF_NAME[] = { "voll", "kurz", "sofort" };
+
+static uint8_t ee[SIM_EE_SIZE];
+static int     quiet;
+
+// ─── EEPROM-Abbild laden ──────────────────────────────────────────────
+static int hex_byte(const char *s) {
+    unsigned v;
+    return sscanf(s, "%2x", &v) == 1 ? (int)v : -1;
+}
+
+// Intel-HEX: Typ 00 Daten, 02/04 Adress-Erweiterung, 01 Ende.
+// Daten-EEPROM im Geräte-Export: Wort 0xF000 … → Byte 0x1E000, je
+// EEPROM-Byte ein Wort (High-Byte 0); sonst EEPROM-Export ab Adresse 0.
+static int load_hex(FILE *f) {
+    char     line[600];
+    uint32_t base = 0, a;
+    uint8_t  low[SIM_EE_SIZE];
+    int      n, k, v, sum, type, dev = 0, any = 0;
+
+    memset(low, 0xFF, sizeof low);
+    while (fgets(line, sizeof line, f)) {
+        if (line[0] != ':') continue;
+        if ((n = hex_byte(line + 1)) < 0 || strlen(line) < 11u + 2u * (unsigned)n) return -1;
+        for (k = 0, sum = 0; k < n + 5; k++) {
+            if ((v = hex_byte(line + 1 + 2 * k)) < 0) return -1;
+            sum += v;
+        }
+        if (sum & 0xFF) return -1;                   // Prüfsumme
+        a    = (uint32_t)(hex_byte(line + 3) << 8 | hex_byte(line + 5));
+        type = hex_byte(line + 7);
+        if (type == 1) break;
+        if (type == 2) base = (uint32_t)(hex_byte(line + 9) << 8 | hex_byte(line + 11)) << 4;
+        if (type == 4) base = (uint32_t)(hex_byte(line + 9) << 8 | hex_byte(line + 11)) << 16;
+        if (type != 0) continue;
+        for (k = 0; k < n; k++, a++) {
+            v = hex_byte(line + 9 + 2 * k);
+            if (base + a >= 0x1E000u && base + a < 0x1E000u + 2u * SIM_EE_SIZE) {
+                if (!((base + a) & 1u)) ee[(base + a - 0x1E000u) / 2u] = (uint8_t)v;
+                dev = 1;
+            } else if (base + a < SIM_EE_SIZE) {
+                low[base + a] = (uint8_t)v;
+                any = 1;
+            }
+        }
+    }
+    if (!dev && !any) return -1;
+    if (!dev) memcpy(ee, low, sizeof ee);
+    return 0;
+}
+
+static int load_file(const char *name) {
+    FILE *f = fopen(name, "rb");
+    int   c, r;
+
+    if (!f) { perror(name); return -1; }
+    memset(ee, 0xFF, sizeof ee);
+    c = fgetc(f);
+    if (c == ':') {
+        rewind(f);
+        r = load_hex(f);
+    } else {
+        ungetc(c, f);
+        r = fread(ee, 1, sizeof ee, f) == sizeof ee ? 0 : -1;
+    }
+    fclose(f);
+    if (r) fprintf(stderr, "%s: kein EEPROM-Abbild (Intel-HEX oder %u Byte)\n",
+                   name, SIM_EE_SIZE);
+    return r;
+}
+
+// ─── Latenz-Histogramm ────────────────────────────────────────────────
+#define H_BINS  8
+static const double H_EDGE[H_BINS - 1] = { 1, 2, 5, 10, 20, 50, 100 };   // ms
+
+struct hist {
+    const char *name;
+    unsigned    bin[H_BINS], n;
+    double      sum, max;
+};
+
+static void hist_add(struct hist *h, double ms) {
+    int b = 0;
+    while (b < H_BINS - 1 && ms >= H_EDGE[b]) b++;
+    h->bin[b]++;
+    h->n++;
+    h->sum += ms;
+    if (ms > h->max) h->max = ms;
+}
+
+static void hist_print(const struct hist *h) {
+    unsigned most = 0, k;
+    int      b;
+
+    printf("%s: %u", h->name, h->n);
+    if (!h->n) { printf("\n"); return; }
+    printf("  Ø %.1f ms  max %.1f ms\n", h->sum / h->n, h->max);
+    for (b = 0; b < H_BINS; b++) if (h->bin[b] > most) most = h->bin[b];
+    for (b = 0; b < H_BINS; b++) {
+        if (b == 0)              printf("  %8s <%4.0f ms", "", H_EDGE[0]);
+        else if (b < H_BINS - 1) printf("  %4.0f … <%4.0f ms", H_EDGE[b - 1], H_EDGE[b]);
+        else                     printf("  %4s ≥%4.0f ms", "", H_EDGE[b - 1]);
+        printf("  %5u  ", h->bin[b]);
+        for (k = 0; k < (h->bin[b] * 40u + most - 1u) / most; k++) putchar('#');
+        putchar('\n');
+    }
+}
+
+// ─── Ring dekodieren ──────────────────────────────────────────────────
+// Kopf wie trace_load(): erster Platz mit anderer Runde als Platz 0
+static void decode(void) {
+    struct hist h_deb  = { "Flanke → Druck", {0}, 0, 0, 0 };
+    struct hist h_roll = { "Druck → 1. Frame", {0}, 0, 0, 0 };
+    struct hist h_wake = { "Wake → Anzeige", {0}, 0, 0, 0 };
+    unsigned    head, k, used = 0, n_rej = 0, n_lost = 0, n_sleep = 0, n_boot = 0;
+    uint8_t     lap0 = ee[EE_TRACE_AT] & TR_LAP, ev, code, arg;
+    uint16_t    t, prev = 0;
+    double      now = 0, dt, t_edge = -1, t_press = -1, t_wake = -1;
+    int         first = 1;
+    const uint8_t *p;
+
+    for (head = 1; head < TRACE_EE; head++)
+        if ((ee[EE_TRACE_AT + 3u * head] & TR_LAP) != lap0) break;
+    if (head == TRACE_EE) head = 0;
+    for (k = 0; k < TRACE_EE; k++)
+        if (((ee[EE_TRACE_AT + 3u * k] >> 3) & 0x0Fu) != 0x0Fu) used++;
+
+    printf("# Ereignis-Protokoll: %u Plätze ab Byte %u, %u belegt, Kopf %u, 1 Tick = %.3f ms\n",
+           (unsigned)TRACE_EE, (unsigned)EE_TRACE_AT, used, head, TICK_MS);
+    if (!quiet) printf("%12s  %10s  Ereignis\n", "Zeit [ms]", "+Δ [ms]");
+
+    for (k = 0; k < TRACE_EE; k++) {
+        p    = &ee[EE_TRACE_AT + 3u * ((head + k) % TRACE_EE)];
+        ev   = p[0];
+        code = (ev >> 3) & 0x0Fu;
+        arg  = ev & 0x07u;
+        t    = (uint16_t)(p[1] | p[2] << 8);
+        if (code == 0x0Fu) continue;                 // leer
+
+        // Uhr: 16 Bit, läuft über → Differenzen; Einschalten = neue Zählung
+        // (trace_t ab 0), ebenso der älteste Eintrag
+        dt = (uint16_t)(t - prev) * TICK_MS;
+        if (code == TR_BOOT || first) {
+            if (!quiet && !first) printf("%12s  %10s  ─── aus/ein ───\n", "", "");
+            now = t * TICK_MS;
+            t_edge = t_press = t_wake = -1;
+        } else {
+            now += dt;
+        }
+        if (code == TR_BOOT) n_boot++;
+        if (!quiet) {
+            printf("%12.1f  ", now);
+            if (code == TR_BOOT || first) printf("%10s  ", "");
+            else                          printf("%10.1f  ", dt);
+            printf("%s", code < sizeof TR_NAME / sizeof TR_NAME[0] ? TR_NAME[code] : "?");
+            switch (code) {
+            case TR_EDGE:    printf(arg ? " (LOW)" : " (HIGH)");                          break;
+            case TR_PRESS:
+            case TR_RELEASE:
+            case TR_REJECT:  if (arg) printf(" (%u%s IOC-Flanken)", arg, arg == 7u ? "+" : ""); break;
+            case TR_ROLL:
+            case TR_SHOW:    printf(" %u", arg + 1u);                                     break;
+            case TR_WAKE:    printf(arg ? " (Taster)" : " (ohne Flanke?)");               break;
+            case TR_LOST:    printf(" %u%s Einträge", arg, arg == 7u ? "+" : "");         break;
+            case TR_PROFILE: printf(" %s", arg < PROF_N ? PROF_NAME[arg] : "?");         break;
+            }
+            putchar('\n');
+            if (code == TR_SLEEP) printf("%12s  %10s  ─── Schlaf (Dauer unbekannt) ───\n", "", "");
+        }
+        prev  = t;
+        first = 0;
+
+        switch (code) {
+        case TR_EDGE:    if (arg) t_edge = now;                              break;
+        case TR_PRESS:   if (t_edge >= 0) hist_add(&h_deb, now - t_edge);
+                         t_edge = -1; t_press = now;                         break;
+        case TR_FRAME:   if (t_press >= 0) hist_add(&h_roll, now - t_press);
+                         t_press = -1;                                       break;
+        case TR_WAKE:    t_wake = now; t_press = -1;                         break;
+        case TR_SHOW:    if (t_wake >= 0) hist_add(&h_wake, now - t_wake);
+                         t_wake = -1;                                        break;
+        case TR_REJECT:  n_rej++; t_edge = -1;                               break;
+        case TR_SLEEP:   n_sleep++; t_press = -1;                            break;
+        case TR_LOST:    n_lost += arg;                                      break;
+        }
+    }
+
+    printf("# Einschalten %u, Sleep %u, Störimpulse %u, verloren %u%s\n",
+           n_boot, n_sleep, n_rej, n_lost, n_lost ? " (RAM-Ring zu klein?)" : "");
+    hist_print(&h_deb);
+    hist_print(&h_roll);
+    hist_print(&h_wake);
+}
+
+// ─── Simulation: Tastendruck mit Prellen ──────────────────────────────
+#define BOUNCE_NS  300000ull
+
+static void bouncy(uint64_t t, uint8_t pressed, unsigned bounces) {
+    unsigned k;
+
+    sim_button(t, pressed);
+    for (k = 0; k < bounces; k++) {
+        sim_button(t + (2u * k + 1u) * BOUNCE_NS, !pressed);
+        sim_button(t + (2u * k + 2u) * BOUNCE_NS, pressed);
+    }
+}
+
+// ─── MAIN ─────────────────────────────────────────────────────────────
+int main(int argc, char **argv) {
+    uint64_t    t_end = SIM_MS(30000);
+    const char *in = NULL, *out = NULL;
+    FILE       *f;
+    int         i;
+
+    sim_reset(0);
+    sim_ee_erase();
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+            t_end = SIM_MS(strtoull(argv[++i], NULL, 10));
+        } else if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+            unsigned long at, hold, b = 0;
+            if (sscanf(argv[++i], "%lu:%lu:%lu", &at, &hold, &b) < 2) goto usage;
+            bouncy(SIM_MS(at), 1u, (unsigned)b);
+            bouncy(SIM_MS(at + hold), 0u, (unsigned)b);
+        } else if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+            out = argv[++i];
+        } else if (!strcmp(argv[i], "-q")) {
+            quiet = 1;
+        } else if (argv[i][0] != '-' && !in) {
+            in = argv[i];
+        } else {
+            goto usage;
+        }
+    }
+
+    if (in) {
+        if (sim.n_edges || out) goto usage;
+        if (load_file(in)) return 1;
+    } else {
+        sim_attach_isr(isr);
+        sim_run(fw_main, t_end);
+        memcpy(ee, sim_ee.data, sizeof ee);
+        printf("# Simulation %.0f ms, %u Einträge noch im RAM (nach dem letzten Sleep)\n",
+               t_end / 1e6, (unsigned)trace_new);
+        if (out) {
+            if (!(f = fopen(out, "wb")) || fwrite(ee, 1, sizeof ee, f) != sizeof ee) {
+                perror(out);
+                return 1;
+            }
+            fclose(f);
+        }
+    }
+    decode();
+    return 0;
+
+usage:
+    fprintf(stderr, "Aufruf: %s [-q] datei | [-t ms] [-p ms:halten_ms[:prellen]]... [-o datei] [-q]\n",
+            argv[0]);
+    return 2;
+}
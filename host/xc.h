@@ -0,0 +1,196 @@
+/*
+ * ═══════════════════════════════════════════════════════════════════════
+ *  xc.h  ·  Host-Attrappe für den MPLAB-XC8-Header
+ * ═══════════════════════════════════════════════════════════════════════
+ *
+ *  Wird mit  -Ihost  statt des echten <xc.h> gefunden. Alle SFRs sind
+ *  Makros auf sim_reg() → jeder Zugriff läuft über die Simulation
+ *  (Zeit vorrücken, Eingänge einlesen, Interrupts auslösen).
+ *
+ *  Nur die Register/Bits, die die Firmware tatsächlich benutzt.
+ * ═══════════════════════════════════════════════════════════════════════
+ */
+#ifndef SIM_XC_H
+#define SIM_XC_H
+
+#include <stdint.h>
+#include "sim.h"
+
+// ─── Compiler-Erweiterungen ───────────────────────────────────────────
+#define __interrupt(...)
+#define __delay_ms(x)   sim_delay_cycles((uint64_t)((x) * (_XTAL_FREQ / 4000.0)))
+#define __delay_us(x)   sim_delay_cycles((uint64_t)((x) * (_XTAL_FREQ / 4000000.0)))
+#define _delay(n)       sim_delay_cycles((uint64_t)(n))
+#define SLEEP()         sim_sleep()
+#define NOP()           sim_nop()
+#define CLRWDT()        sim_clrwdt()
+
+#define SIM_SFR(idx)            (*sim_reg(idx))
+#define SIM_SFRBITS(type, idx)  (*(volatile type *)sim_reg(idx))
+
+// ─── Gemeinsam: STATUS ────────────────────────────────────────────────
+typedef struct {
+    uint8_t C:1, DC:1, Z:1, nPD:1, nTO:1, RP:2, IRP:1;
+} STATUSbits_t;
+
+#define STATUS      SIM_SFR(SIM_STATUS)
+#define STATUSbits  SIM_SFRBITS(STATUSbits_t, SIM_STATUS)
+#define TMR0        SIM_SFR(SIM_TMR0)
+
+#if defined(_16F84A)
+// ═══ PIC16F84A ════════════════════════════════════════════════════════
+typedef union {
+    struct { uint8_t RBIF:1, INTF:1, T0IF:1, RBIE:1, INTE:1, T0IE:1, EEIE:1, GIE:1; };
+    struct { uint8_t :2, TMR0IF:1, :2, TMR0IE:1, :2; };
+} INTCONbits_t;
+typedef struct {
+    uint8_t PS:3, PSA:1, T0SE:1, T0CS:1, INTEDG:1, nRBPU:1;
+} OPTION_REGbits_t;
+typedef struct {
+    uint8_t RD:1, WR:1, WREN:1, WRERR:1, EEIF:1, :3;
+} EECON1bits_t;
+typedef struct { uint8_t RA0:1, RA1:1, RA2:1, RA3:1, RA4:1, :3; } PORTAbits_t;
+typedef struct {
+    uint8_t RB0:1, RB1:1, RB2:1, RB3:1, RB4:1, RB5:1, RB6:1, RB7:1;
+} PORTBbits_t;
+
+#define INTCON          SIM_SFR(SIM_INTCON)
+#define INTCONbits      SIM_SFRBITS(INTCONbits_t, SIM_INTCON)
+#define OPTION_REG      SIM_SFR(SIM_OPTION_REG)
+#define OPTION_REGbits  SIM_SFRBITS(OPTION_REGbits_t, SIM_OPTION_REG)
+#define PORTA           SIM_SFR(SIM_PORTA)
+#define PORTAbits       SIM_SFRBITS(PORTAbits_t, SIM_PORTA)
+#define TRISA           SIM_SFR(SIM_TRISA)
+#define PORTB           SIM_SFR(SIM_PORTB)
+#define PORTBbits       SIM_SFRBITS(PORTBbits_t, SIM_PORTB)
+#define TRISB           SIM_SFR(SIM_TRISB)
+#define EEDATA          SIM_SFR(SIM_EEDATA)
+#define EEADR           SIM_SFR(SIM_EEADR)
+#define EECON1          SIM_SFR(SIM_EECON1)
+#define EECON1bits      SIM_SFRBITS(EECON1bits_t, SIM_EECON1)
+#define EECON2          SIM_SFR(SIM_EECON2)
+
+// Legacy-Bitnamen (XC8 stellt sie für den 16F84A bereit)
+#define GIE   INTCONbits.GIE
+#define T0IE  INTCONbits.T0IE
+#define T0IF  INTCONbits.T0IF
+#define RBIE  INTCONbits.RBIE
+#define RBIF  INTCONbits.RBIF
+#define INTE  INTCONbits.INTE
+#define INTF  INTCONbits.INTF
+
+#else
+// ═══ PIC16F1825 ═══════════════════════════════════════════════════════
+typedef union {
+    struct { uint8_t IOCIF:1, INTF:1, TMR0IF:1, IOCIE:1, INTE:1, TMR0IE:1, PEIE:1, GIE:1; };
+    struct { uint8_t :2, T0IF:1, :2, T0IE:1, :2; };
+} INTCONbits_t;
+typedef struct {
+    uint8_t PS:3, PSA:1, TMR0SE:1, TMR0CS:1, INTEDG:1, nWPUEN:1;
+} OPTION_REGbits_t;
+typedef struct {
+    uint8_t SCS:2, :1, IRCF:4, SPLLEN:1;
+} OSCCONbits_t;
+typedef struct {
+    uint8_t SWDTEN:1, WDTPS:5, :2;
+} WDTCONbits_t;
+typedef struct {
+    uint8_t TMR1IF:1, TMR2IF:1, CCP1IF:1, SSP1IF:1, TXIF:1, RCIF:1, ADIF:1, TMR1GIF:1;
+} PIR1bits_t;
+typedef struct {
+    uint8_t TMR1IE:1, TMR2IE:1, CCP1IE:1, SSP1IE:1, TXIE:1, RCIE:1, ADIE:1, TMR1GIE:1;
+} PIE1bits_t;
+typedef struct {
+    uint8_t T2CKPS:2, TMR2ON:1, T2OUTPS:4, :1;
+} T2CONbits_t;
+typedef struct {
+    uint8_t TMR1ON:1, :1, nT1SYNC:1, T1OSCEN:1, T1CKPS:2, TMR1CS:2;
+} T1CONbits_t;
+typedef struct {
+    uint8_t RD:1, WR:1, WREN:1, WRERR:1, FREE:1, LWLO:1, CFGS:1, EEPGD:1;
+} EECON1bits_t;
+typedef struct {
+    uint8_t ADFVR:2, CDAFVR:2, TSRNG:1, TSEN:1, FVRRDY:1, FVREN:1;
+} FVRCONbits_t;
+typedef struct {
+    uint8_t ADON:1, GO_nDONE:1, CHS:5, :1;
+} ADCON0bits_t;
+typedef struct {
+    uint8_t ADPREF:2, ADNREF:1, :1, ADCS:3, ADFM:1;
+} ADCON1bits_t;
+typedef struct { uint8_t RA0:1, RA1:1, RA2:1, RA3:1, RA4:1, RA5:1, :2; } PORTAbits_t;
+typedef struct { uint8_t RC0:1, RC1:1, RC2:1, RC3:1, RC4:1, RC5:1, :2; } PORTCbits_t;
+typedef struct {
+    uint8_t LATA0:1, LATA1:1, LATA2:1, :1, LATA4:1, LATA5:1, :2;
+} LATAbits_t;
+typedef struct {
+    uint8_t LATC0:1, LATC1:1, LATC2:1, LATC3:1, LATC4:1, LATC5:1, :2;
+} LATCbits_t;
+typedef struct {
+    uint8_t IOCAP0:1, IOCAP1:1, IOCAP2:1, IOCAP3:1, IOCAP4:1, IOCAP5:1, :2;
+} IOCAPbits_t;
+typedef struct {
+    uint8_t IOCAN0:1, IOCAN1:1, IOCAN2:1, IOCAN3:1, IOCAN4:1, IOCAN5:1, :2;
+} IOCANbits_t;
+typedef struct {
+    uint8_t IOCAF0:1, IOCAF1:1, IOCAF2:1, IOCAF3:1, IOCAF4:1, IOCAF5:1, :2;
+} IOCAFbits_t;
+
+#define INTCON          SIM_SFR(SIM_INTCON)
+#define INTCONbits      SIM_SFRBITS(INTCONbits_t, SIM_INTCON)
+#define OPTION_REG      SIM_SFR(SIM_OPTION_REG)
+#define OPTION_REGbits  SIM_SFRBITS(OPTION_REGbits_t, SIM_OPTION_REG)
+#define OSCCON          SIM_SFR(SIM_OSCCON)
+#define OSCCONbits      SIM_SFRBITS(OSCCONbits_t, SIM_OSCCON)
+#define PIR1            SIM_SFR(SIM_PIR1)
+#define PIR1bits        SIM_SFRBITS(PIR1bits_t, SIM_PIR1)
+#define PIE1            SIM_SFR(SIM_PIE1)
+#define PIE1bits        SIM_SFRBITS(PIE1bits_t, SIM_PIE1)
+#define T2CON           SIM_SFR(SIM_T2CON)
+#define T2CONbits       SIM_SFRBITS(T2CONbits_t, SIM_T2CON)
+#define PR2             SIM_SFR(SIM_PR2)
+#define T1CON           SIM_SFR(SIM_T1CON)
+#define T1CONbits       SIM_SFRBITS(T1CONbits_t, SIM_T1CON)
+#define TMR1L           SIM_SFR(SIM_TMR1L)
+#define TMR1H           SIM_SFR(SIM_TMR1H)
+#define TMR2            SIM_SFR(SIM_TMR2)
+#define FVRCON          SIM_SFR(SIM_FVRCON)
+#define FVRCONbits      SIM_SFRBITS(FVRCONbits_t, SIM_FVRCON)
+#define ADCON0          SIM_SFR(SIM_ADCON0)
+#define ADCON0bits      SIM_SFRBITS(ADCON0bits_t, SIM_ADCON0)
+#define ADCON1          SIM_SFR(SIM_ADCON1)
+#define ADCON1bits      SIM_SFRBITS(ADCON1bits_t, SIM_ADCON1)
+#define ADRESL          SIM_SFR(SIM_ADRESL)
+#define ADRESH          SIM_SFR(SIM_ADRESH)
+#define WDTCON          SIM_SFR(SIM_WDTCON)
+#define WDTCONbits      SIM_SFRBITS(WDTCONbits_t, SIM_WDTCON)
+#define CPSCON0         SIM_SFR(SIM_CPSCON0)
+#define CPSCON1         SIM_SFR(SIM_CPSCON1)
+#define PORTA           SIM_SFR(SIM_PORTA)
+#define PORTAbits       SIM_SFRBITS(PORTAbits_t, SIM_PORTA)
+#define PORTC           SIM_SFR(SIM_PORTC)
+#define PORTCbits       SIM_SFRBITS(PORTCbits_t, SIM_PORTC)
+#define LATA            SIM_SFR(SIM_LATA)
+#define LATAbits        SIM_SFRBITS(LATAbits_t, SIM_LATA)
+#define LATC            SIM_SFR(SIM_LATC)
+#define LATCbits        SIM_SFRBITS(LATCbits_t, SIM_LATC)
+#define TRISA           SIM_SFR(SIM_TRISA)
+#define TRISC           SIM_SFR(SIM_TRISC)
+#define ANSELA          SIM_SFR(SIM_ANSELA)
+#define ANSELC          SIM_SFR(SIM_ANSELC)
+#define WPUA            SIM_SFR(SIM_WPUA)
+#define WPUC            SIM_SFR(SIM_WPUC)
+#define IOCAP           SIM_SFR(SIM_IOCAP)
+#define IOCAPbits       SIM_SFRBITS(IOCAPbits_t, SIM_IOCAP)
+#define IOCAN           SIM_SFR(SIM_IOCAN)
+#define IOCANbits       SIM_SFRBITS(IOCANbits_t, SIM_IOCAN)
+#define IOCAF           SIM_SFR(SIM_IOCAF)
+#define IOCAFbits       SIM_SFRBITS(IOCAFbits_t, SIM_IOCAF)
+#define EEADRL          SIM_SFR(SIM_EEADR)
+#define EEDATL          SIM_SFR(SIM_EEDATA)
+#define EECON1          SIM_SFR(SIM_EECON1)
+#define EECON1bits      SIM_SFRBITS(EECON1bits_t, SIM_EECON1)
+#define EECON2          SIM_SFR(SIM_EECON2)
+#endif
+
+#endif
@@ -31,9 +31,28 @@
  *  Quarz        → RC-Modus  #pragma config FOSC = RC
  *  2× 22pF      → RC-Modus  (obige Zeile reicht)
  *  Taster-R     → OPTION_REG /RBPU = 0  (interne Pull-Ups RB7)
- *  HW-Entprell  → Software-Entprellung (25 ms + Flanke)
+ *  HW-Entprell  → Software-Entprellung (RB-Change-IRQ + Integrator)
  *  MCLR-Button  → WDT-Reset optional / nur MCLR-Pullup-R bleibt
  *
+ * ─── AUTO-SLEEP ──────────────────────────────────────────────────────
+ *
+ *  Nach 10 Sekunden ohne Tastendruck → LEDs aus, SLEEP (< 1 µA statt
+ *  ~2 mA Kernstrom). Tastendruck → Wake über RB-Port-Change (RB7),
+ *  letzte Zahl anzeigen, nächster Tastendruck würfelt.
+ *  Vor dem SLEEP: letzte Zahl, Zufallszustand und Wurfzähler ins
+ *  Daten-EEPROM (Ring, übersteht den Batteriewechsel).
+ *  Roll-Profil voll / sofort (BOARD_PROF_LITE, ohne „kurz“ und ohne
+ *  ANIM_PROFILE): während der Einschalt-Animation lang drücken (oder
+ *  beim Einschalten halten) → anderes Profil, 1 bzw. 2 Augen bleiben
+ *  stehen. Abschaltbar mit -DBOARD_PROFILES=0.
+ *
+ * ─── RC-KALIBRIERUNG ─────────────────────────────────────────────────
+ *
+ *  Der RC-Takt streut mit R2/C2 und dem Chip (±25 % lt. DS). Am
+ *  Prüfplatz liegt beim Einschalten 1 kHz (quarzgenau, über 1 kΩ) an
+ *  RA4 (Pin 3): der PIC misst seinen Takt daran, speichert Tcy je Tick
+ *  im EEPROM, und alle Zeiten stimmen danach auch ohne Prüfplatz.
+ *
  *  MINIMALES BOM (absolut):
  *   U1   PIC16F84A      ×1
  *   C1   10 µF / 10 V   ×1   (VDD-Bypass)
@@ -67,116 +86,247 @@
 //  R2=4,7kΩ + C2=100pF → f ≈  709 kHz  (empfohlen: sicherer Abstand!)
 //  R2=10kΩ  + C2=100pF → f ≈  333 kHz  (sicherste Option)
 //
-// WICHTIG: _XTAL_FREQ MUSS zur tatsächlichen RC-Frequenz passen,
-//          sonst sind alle __delay_ms() Werte falsch!
+// _XTAL_FREQ ist nur der Nennwert: ohne Kalibrierung (BOARD_RC_CAL)
+// gehen alle Zeiten so falsch wie der RC-Takt davon abweicht.
 #define _XTAL_FREQ  700000UL    // ~700 kHz (RC: 4,7kΩ + 100pF per DS40001440E)
                                 // Bei 3,3kΩ: 1000000UL verwenden
 
-// ─── LED-Bit-Definitionen ─────────────────────────────────────────────
-#define A  (1u<<0)   // RB0
-#define B  (1u<<1)   // RB1
-#define C  (1u<<2)   // RB2
-#define D  (1u<<3)   // RB3 – Zentrum
-#define E  (1u<<4)   // RB4
-#define F  (1u<<5)   // RB5
-#define G  (1u<<6)   // RB6
-
-// ─── Würfelmuster ─────────────────────────────────────────────────────
-//   Index 0 = Würfelzahl 1, Index 5 = Würfelzahl 6
-const uint8_t DICE[6] = {
-    D,                  // ⚀  1: Zentrum
-    B|F,                // ⚁  2: oben-rechts + unten-links
-    B|D|F,              // ⚂  3: Diagonale + Mitte
-    A|B|F|G,            // ⚃  4: vier Ecken
-    A|B|D|F|G,          // ⚄  5: vier Ecken + Mitte
-    A|B|C|E|F|G,        // ⚅  6: alle außer Zentrum
-};
-
-// ─── Zufallsquelle ────────────────────────────────────────────────────
-// TMR0 läuft seit Power-On frei durch.
-// Beim Tastendruck lesen wir den aktuellen Zählerstand →
-// Die menschliche Reaktionszeit variiert im µs-Bereich → effektiv zufällig.
-volatile uint8_t tmr0_count = 0;
+#include "board.h"
+
+// ─── Zeitbasis: Timer0-Tick, Länge in Tcy kalibriert ─────────────────
+// Timer0 @ Fosc/4 ohne Vorteiler (PSA = 1). Die ISR lädt je Überlauf
+// nach: TMR0 += t0_reload. Gezählt wird ab dem Überlauf, nicht ab dem
+// Schreiben → 1 Tick = genau t0_cyc Tcy, egal wie spät die ISR kommt;
+// Schreiben auf TMR0 sperrt den Zähler 2 Tcy (→ +2 im Nachladewert).
+//   t0_cyc = Fosc/4 · TICK_US      (1 ms: 175 Tcy @ 700 kHz, 250 @ 1 MHz)
+// Fosc misst rc_cal() gegen den Prüfplatz (nur mit BOARD_RC_CAL), sonst
+// gilt der Wert aus dem EEPROM, sonst der Nennwert aus _XTAL_FREQ.
+// MS() rechnet mit TICK_US.
+#if _XTAL_FREQ >= 512000UL
+#define TICK_US     1000u       // 128 … 255 Tcy je Tick
+#else
+#define TICK_US     2000u       // R2 = 10 kΩ: ~167 Tcy je Tick
+#endif
+#define T0_CYC_NOM  ((uint8_t)((_XTAL_FREQ / 4u * TICK_US + 500000UL) / 1000000UL))
+#if _XTAL_FREQ / 4u * TICK_US > 255500000UL || _XTAL_FREQ < 256000UL
+#error "_XTAL_FREQ: 256 kHz … 1 MHz (Tick = 128 … 255 Tcy ohne Vorteiler)"
+#endif
+#ifndef SLEEP_TIMEOUT                 // Varianten: -DSLEEP_TIMEOUT='MS(5000)'
+#define SLEEP_TIMEOUT  MS(10000)    // 10 Sekunden = 10000 Ticks
+#endif
+
+static uint8_t t0_reload = (uint8_t)(258u - T0_CYC_NOM);   // 256 − t0_cyc + 2
+
+// ─── Frame ausgeben: ohne PWM direkt auf PORTB ───────────────────────
+#define show(f)          led_out(f)
+#define show_die(k, f)   led_out(f)
+
+// ─── Gemeinsamer Kern: Taster, Zufall, Zustände, Animationen ─────────
+#include "dice_core.h"
 
+// ─── Interrupt: Timer0-Tick + RB-Port-Change (Taster RB7) ────────────
 void __interrupt() isr(void) {
+    uint8_t low;
+
     if (T0IF) {
-        tmr0_count++;   // ~15 Hz Overflow @ 4 MHz / 4 / 256
+        TMR0 += t0_reload;  // Überlauf + t0_cyc Tcy = nächster Tick
+        tmr0_count++;
         T0IF = 0;
+        low = BTN_IS_LOW();
+        // Rückfall: fällt das PORTB-Lesen hier genau auf die Flanke,
+        // kann RBIF ausbleiben → Pegel ≠ entprellter Zustand startet auch
+        if (btn_busy || low != btn_level) { btn_busy = 1; btn_sample(low); }
+    }
+    if (RBIF) {
+        low = BTN_IS_LOW();         // Lesen beendet den Mismatch …
+        RBIF = 0;                   // … erst dann lässt sich RBIF löschen
+        if (!btn_busy) {            // erste Flanke: Abtastung starten
+            btn_t0   = TMR0;        // Phase im Tick = Entropie
+            TMR0     = t0_reload;   // nächster Tick genau 1 Tick später
+            btn_busy = 1;
+            btn_sample(low);
+        }
     }
 }
 
-// ─── Variable Delay (XC8: __delay_ms() braucht Konstante) ────────────
-static void delay_ms(uint16_t ms) {
-    while (ms--) __delay_ms(1);
-}
+// ─── Sleep-Modus aktivieren ───────────────────────────────────────────
+// Weckquelle: RB-Port-Change an RB7 (RBIE bleibt an, GIE aus → nach dem
+// Wake geht es hinter SLEEP weiter, die ISR folgt mit GIE = 1).
+// Mismatch-Latch: RBIF entsteht, wenn RB7 vom Pegel beim LETZTEN
+// PORTB-Lesen abweicht. Deshalb direkt vor SLEEP lesen, dann RBIF
+// löschen; weicht der Pegel vom entprellten Zustand ab (Flanke seit dem
+// letzten Tick, evtl. ohne RBIF), nicht schlafen — die Timer-ISR
+// startet die Entprellung. Eine Flanke nach dem Lesen setzt RBIF,
+// SLEEP wirkt dann wie NOP. Ebenso wach bleiben, solange ein Druck aus
+// ee_save() noch entprellt wird oder sein Ereignis auf step() wartet.
+// Timer0 steht im SLEEP; ein T0IF kurz davor würde SLEEP ebenfalls zum
+// NOP machen → T0IE aus, nach dem Wake wieder an.
+// RC-Oszillator: kein Oscillator Start-up Timer (nur XT/LP/HS), der Kern
+// läuft nach dem Wake sofort weiter. Bis die Frequenz steht, vergehen
+// einige Takte; gemessen wird erst ab dem Neustart des Ticks in der ISR
+// über ≥ 1 Tick.
+static void enter_sleep(void) {
+    uint8_t low;
 
-// ─── Taster-Polling: Software-Entprellung + Flanken-Erkennung ────────
-static uint8_t button_pressed(void) {
-    if (!(PORTB & (1u<<7))) {           // RB7 = LOW → Taster gedrückt
-        delay_ms(25);                   // Entprell-Fenster
-        if (!(PORTB & (1u<<7))) {       // Bestätigung nach 25 ms
-            while (!(PORTB & (1u<<7))); // Warten bis Taster losgelassen
-            delay_ms(15);               // Nachprellen abwarten
-            return 1;
-        }
+    show(FACE_OFF);                  // LEDs aus
+    ee_save();                       // neue Würfe → EEPROM (~32 ms, GIE = 1)
+    GIE  = 0;
+    T0IE = 0;
+    T0IF = 0;
+    low  = BTN_IS_LOW();             // Latch := aktueller Pegel
+    RBIF = 0;
+    if (!btn_busy && !btn_events && low == btn_level) {   // [FIX-11]
+        SLEEP();                     // PIC schlafen legen (< 1 µA)
+        NOP();                       // Nach Wake-Up hier weitermachen
     }
-    return 0;
+    t_seen = tmr0_count;             // now steht im Auto-Sleep, auch beim Schreiben
+    T0IE = 1;
+    GIE  = 1;                        // Weck-Flanke → ISR startet Entprellung
 }
 
-// ─── Animationshelfer: ein Frame ausgeben ────────────────────────────
-static void show(uint8_t pattern) {
-    PORTB = (PORTB & 0x80u) | (pattern & 0x7Fu);
-    // RB7 (Taster-Eingang) bleibt unverändert!
+// ─── Ein Schritt der Ablaufsteuerung ──────────────────────────────────
+static void step(void) {
+    // Taster-Ereignisse aus der ISR
+    if (btn_events & EV_PRESS) {
+        btn_events &= (uint8_t)~EV_PRESS;
+        if (state == ST_WAKE)         state = ST_SHOW;    // Weck-Druck würfelt nicht
+#if BOARD_PROFILES
+        else if (state == ST_STARTUP) prof_sel = 1;       // lang → Profil, kurz → Wurf
+#endif
+        else start_roll(now);
+    }
+    if (btn_events & EV_RELEASE) {
+        btn_events &= (uint8_t)~EV_RELEASE;
+        rng_mix((uint8_t)(btn_t_release - btn_t_press));   // Druckdauer
+#if BOARD_PROFILES
+        if (prof_sel) { prof_sel = 0; start_roll(now); }
+#endif
+    }
+    if (btn_events & EV_LONG) {
+        btn_events &= (uint8_t)~EV_LONG;
+#if BOARD_PROFILES
+        if (prof_sel) { prof_sel = 0; prof_next(); }
+#endif
+    }
+
+    switch (state) {
+    case ST_IDLE:
+    case ST_SHOW:
+        if ((uint16_t)(now - idle_since) >= SLEEP_TIMEOUT)
+            state = ST_SLEEP;                // Timeout → nächster Schritt schläft
+        break;
+    case ST_SLEEP:
+        enter_sleep();
+
+        // Nach Wake-Up: letzte Zahl anzeigen, Weck-Druck entprellen
+        show_last();
+        idle_since = now;
+        state      = ST_WAKE;
+        break;
+    case ST_WAKE:                            // [FIX-10] Prellen ≠ Störimpuls
+        if (btn_busy) idle_since = now;
+        else if ((uint16_t)(now - idle_since) >= WAKE_QUIET)
+            state = ST_SHOW;                 // Störimpuls: kein Druck bestätigt
+        break;
+    default:                                 // STARTUP, ROLLING, BLINK
+        if ((int16_t)(now - due) >= 0) anim_due();
+        break;
+    }
 }
 
-// ─── Würfel-Roll-Animation ────────────────────────────────────────────
-// Simuliert rollendes Würfelgefühl: schnell → langsam
-static void roll_animation(uint8_t final_idx) {
-    uint8_t  i;
-    uint16_t pause;
+// ─── Auf den nächsten Tick warten ─────────────────────────────────────
+// Timer0 steht im SLEEP → der 16F84A wartet wach (geschlafen wird nur
+// in enter_sleep(), bis zum nächsten Tastendruck).
+// Gezählt wird ab t_seen, nicht ab dem Aufruf: Ticks, die schon während
+// step() vergangen sind (Wurf, Frame: ~1 Tick bei 700 kHz), trägt sie
+// sofort nach, ohne zu warten.
+static void wait_next(void) {
+    uint8_t d;
 
-    for (i = 0; i < 24u; i++) {
-        show(DICE[(tmr0_count + i) % 6u]);
+    while (!(d = (uint8_t)(tmr0_count - t_seen))) NOP();
+    t_seen += d;
+    now    += d;
+}
+
+#if BOARD_RC_CAL
+// ─── RC-Kalibrierung: Tcy je Tick gegen 1 kHz an RA4 ─────────────────
+// Beim Einschalten (GIE = 0), Timer0 zählt Tcy ohne Vorteiler, T0IF per
+// Abfrage. Gemessen werden CAL_PER Referenzperioden = 256 Ticks Soll:
+// die Zahl der Überläufe ist dann direkt Tcy je Tick, TMR0 ≥ 128 rundet
+// auf. Start und Ende erkennt dieselbe Abfrageschleife → deren Latenz
+// fällt heraus, Restfehler ±1 Schleifendurchlauf auf ~45 000 Tcy.
+// Ohne Prüfplatz ist RA4 offen: nach CAL_GAP Überläufen ohne Flanke
+// (> 1 Halbperiode) ist Schluss, ~3 ms. Eine Messung, gültig nur im
+// Bereich Nennwert ±30 %. Gespeichert: t0_cyc in einem Byte (32) —
+// leer (0xFF) liegt außerhalb, dann gilt der Nennwert; neu geschrieben
+// nur bei anderem Wert.
+#define CAL_HZ       1000u
+#define CAL_PER      ((uint16_t)(256UL * TICK_US / (1000000UL / CAL_HZ)))
+#define CAL_GAP      2u
+#define CAL_MIN      ((uint8_t)(T0_CYC_NOM * 7u / 10u))
+#define CAL_MAX      ((uint8_t)(T0_CYC_NOM * 13u / 10u < 255u ? T0_CYC_NOM * 13u / 10u : 255u))
+#define CAL_OK(v)    ((uint8_t)((v) - CAL_MIN) <= (uint8_t)(CAL_MAX - CAL_MIN))
+#define CAL_PIN()    ((PORTA >> 4) & 1u)
+#define EE_CAL_AT    EE_RING_END
 
-        if      (i <  8u) pause = 40;   // Phase 1: schnell
-        else if (i < 16u) pause = 90;   // Phase 2: mittel
-        else               pause = 160;  // Phase 3: langsam
+static uint8_t cal_ovf, cal_gap;
 
-        delay_ms(pause);
+// Auf Pegel lv an RA4 warten, Überläufe mitzählen; 0 = Zeitlimit oder
+// ≥ 256 Überläufe (RC zu schnell für den Tick)
+static uint8_t cal_wait(uint8_t lv) {
+    while (CAL_PIN() != lv) {
+        if (T0IF) {
+            T0IF = 0;
+            if (!++cal_ovf || ++cal_gap > CAL_GAP) return 0;
+        }
     }
-    // Finales Ergebnis einblenden
-    show(DICE[final_idx]);
+    cal_gap = 0;
+    return 1;
 }
 
-// ─── Ergebnis-Blinken (3× = Würfeln abgeschlossen) ────────────────────
-static void blink_result(uint8_t pattern) {
-    uint8_t i;
-    for (i = 0; i < 3u; i++) {
-        show(0x00);     delay_ms(100);
-        show(pattern);  delay_ms(200);
-    }
+// Tcy je Tick aus einer Messung über CAL_PER Perioden, 0 = keine Referenz
+static uint8_t rc_measure(void) {
+    uint16_t n = CAL_PER;
+    uint8_t  lo;
+
+    cal_gap = 0;
+    if (!cal_wait(0) || !cal_wait(1)) return 0;   // steigende Flanke
+    TMR0    = 2u;                                 // 2 Tcy Sperre nach Schreiben
+    T0IF    = 0;
+    cal_ovf = 0;
+    do {
+        if (!cal_wait(0) || !cal_wait(1)) return 0;
+    } while (--n);
+    lo = TMR0;
+    if (T0IF && !(lo & 0x80u)) cal_ovf++;          // Überlauf vor dem Lesen
+    return (uint8_t)(cal_ovf + (lo >> 7));         // runden; 256 → 0 = keine
 }
 
-// ─── Einschalt-Animation (zeigt alle 6 Seiten) ────────────────────────
-static void startup_seq(void) {
-    uint8_t i;
-    for (i = 0; i < 6u; i++) {
-        show(DICE[i]);
-        delay_ms(140);
+// Tcy je Tick → t0_reload; Rückgabe: neuer Wert fürs EEPROM, 0 = keiner
+static uint8_t rc_cal(void) {
+    uint8_t a, e;
+
+    TRISA = 0x10u;                   // RA4 = Eingang, nur für die Messung
+    a = rc_measure();
+    TRISA = 0x00u;
+    e = ee_read(EE_CAL_AT);
+    if (!CAL_OK(a)) {                // keine Referenz: gespeichert, sonst Nennwert
+        a = CAL_OK(e) ? e : T0_CYC_NOM;
+        e = a;                       // nichts zu schreiben
     }
-    show(DICE[0]);  // Bereit-Anzeige: "1"
-    delay_ms(400);
-    show(0x00);
-    delay_ms(200);
-    show(DICE[0]);
+    t0_reload = (uint8_t)(258u - a);
+    return a != e ? a : 0u;
 }
+#endif
 
 // ─── MAIN ─────────────────────────────────────────────────────────────
 void main(void) {
-    uint8_t result;
+#if BOARD_RC_CAL
+    uint8_t cal_new;
+#endif
 
     // Port-Konfiguration
-    TRISA = 0xFFu;           // Port A: alle Eingänge (N/C)
+    TRISA = 0x00u;           // Port A: N/C → Ausgänge LOW (kein offener Eingang im SLEEP)
     TRISB = 0x80u;           // RB7 = Eingang (Taster), RB0..6 = Ausgang
 
     PORTA = 0x00u;
@@ -187,29 +337,36 @@ void main(void) {
     //  Bit6  INTEDG = 0  → (egal, INT nicht benutzt)
     //  Bit5  T0CS   = 0  → Timer0 Takt = intern (Fosc/4)
     //  Bit4  T0SE   = 0  → (egal)
-    //  Bit3  PSA    = 0  → Prescaler → Timer0
-    //  Bit2:0 PS    = 111 → 1:256
-    OPTION_REG = 0b00000111;
+    //  Bit3  PSA    = 1  → Prescaler → WDT, Timer0 1:1
+    //  Bit2:0 PS    = 000 → (WDT aus)
+    OPTION_REG = 0b00001000;
 
-    // Timer0 Interrupt aktivieren (Zufallsquelle)
+#if BOARD_RC_CAL
+    cal_new = rc_cal();      // Prüfplatz: 1 kHz an RA4 → Tcy je Tick
+#endif
+
+    // Timer0 (Tick + Entropie) und RB-Port-Change (Taster RB7)
+    TMR0 = t0_reload;
+    T0IF = 0;
+    (void)PORTB;             // Mismatch-Latch auf aktuellen Pegel setzen
+    RBIF = 0;
     T0IE = 1;
+    RBIE = 1;
     GIE  = 1;
 
-    // Startup
-    startup_seq();
+#if BOARD_RC_CAL
+    if (cal_new) ee_write(EE_CAL_AT, cal_new);   // nur am Prüfplatz, ~4 ms
+#endif
 
-    // ─── Hauptschleife ───────────────────────────────────────────────
-    while (1) {
-        if (button_pressed()) {
-            // Zufallswert: TMR0-Wert im Moment des Tastendrucks
-            result = tmr0_count % 6u;
+    // Gespeicherter Stand: letzte Zahl, Zufallszustand, Wurfzähler
+    ee_load();
 
-            // Animation + Ergebnis anzeigen
-            roll_animation(result);
+    // Startup: Einschalt-Animation läuft über step()
+    startup_seq();
 
-            // Kurze Pause, dann dreimal blinken
-            delay_ms(500);
-            blink_result(DICE[result]);
-        }
+    // ─── Hauptschleife: ein Schritt je Tick ──────────────────────────
+    while (1) {
+        step();
+        wait_next();
     }
 }
@@ -5,7 +5,8 @@
  *
  *  Compiler:     MPLAB XC8 v2.x
  *  Ziel-IC:      PIC16F1825 (DIP-14)  ← NICHT PIC16F84A (DIP-18)!
- *  Takt:         INTERNER Oszillator 4 MHz  (KEIN externer RC, KEIN Quarz!)
+ *  Takt:         INTERNER Oszillator 4 MHz / 500 kHz je nach Zustand
+ *                (KEIN externer RC, KEIN Quarz!)
  *  Versorgung:   2× AAA = 3,0 V  direkt an VDD (kompatibel zum Original!)
  *
  * ─── WICHTIGE UNTERSCHIEDE PIC16F84A vs. PIC16F1825 ─────────────────
@@ -41,7 +42,26 @@
  *
  *  Nach 10 Sekunden Inaktivität → SLEEP-Modus (~1 µA Stromaufnahme!)
  *  Tastendruck → Wake-Up via Interrupt-on-Change (IOC) auf RA4
- *  Nach Wake-Up: letzte Zahl kurz anzeigen (800ms), dann neu würfeln
+ *  Nach Wake-Up: letzte Zahl anzeigen, nächster Tastendruck würfelt
+ *  Vor dem SLEEP: letzte Zahl, Zufallszustand, Wurfzähler → EEPROM-Ring
+ *  Ereignis-Protokoll (Taster, Sleep/Wake, Würfe) → EEPROM, host/trace_dump
+ *  Ablauf als Zustandsautomat im 1-ms-Tick: nichts blockiert, neuer
+ *  Tastendruck startet jederzeit neu, dazwischen schläft der Kern
+ *  Pausen: ein SLEEP bis zum nächsten Termin, Timer1 (LFINTOSC) weckt
+ *  Roll-Profil voll / kurz / sofort: während der Einschalt-Animation
+ *  lang drücken (oder beim Einschalten halten) → nächstes Profil
+ *  -DBOARD_TOUCH=1: Touch-Fläche an RA2 statt Taster (CPS-Modul, Scan
+ *  im Tick bzw. nach WDT-Wake, dieselben Taster-Ereignisse)
+ *
+ * ─── LED-HELLIGKEIT ───────────────────────────────────────────────────
+ *
+ *  Software-PWM über Timer2-Interrupt (2 je Periode, 16 Stufen → 244 Hz):
+ *   - Roll-Frames gedimmt (2/16 → 3/16 → 4/16, schnell → langsam)
+ *   - Ergebnis + Blinken volle Helligkeit (statisch, Timer2 aus)
+ *   - Idle-Anzeige blendet bis zum Auto-Sleep auf 2/16 aus
+ *   - Kern wach nur für die PWM → 500 kHz statt 4 MHz (Taktprofile)
+ *   - VDD je Wake über FVR + ADC: Tastgrad hält die Helligkeit bei
+ *     frischen Zellen konstant, nahe Brown-Out Warnmuster ─ ─
  *
  *  Batterie-Laufzeit (2×AAA, 1200mAh):
  *   - Aktiv (6 LEDs):  ~48mA → 25h Dauerbetrieb
@@ -61,6 +81,7 @@
  *         └────────────────┘
  *
  *  RA4 ← TASTER SW1       (WPUA = intern Pull-Up, kein R!)
+ *  RA2 ← Touch-Fläche     (nur -DBOARD_TOUCH=1, dann ohne SW1)
  *  RC0 → LED a (oben-links)     RC3 → LED d (Zentrum)
  *  RC1 → LED b (oben-rechts)    RC4 → LED e (mitte-rechts)
  *  RC2 → LED c (mitte-links)    RC5 → LED f (unten-links)
@@ -88,25 +109,38 @@
  *
  *  [FIX-1] LATx statt PORTx für alle Ausgaben (kein RMW-Problem)
  *  [FIX-2] Atomare 16-Bit-Zugriffe auf sleep_counter (GIE-Klammer)
+ *          → entfallen: die Tick-Uhr gehört allein der Hauptschleife
  *  [FIX-3] IOCIF ist read-only → Zeile entfernt, Kommentar ergänzt
  *  [FIX-4] Timeout in button_pressed() und nach Wake-Up
+ *          → entfallen: Taster läuft über IOC + Entprellung in der ISR
  *  [FIX-5] Makro-Namen LED_x statt A–G (Kollisionssicher)
  *  [FIX-6] _XTAL_FREQ vor #include <xc.h>
  *  [FIX-7] Startup endet jetzt mit LEDs AUS (Stromsparen)
  *  [FIX-8] Unbenutzte Pins RA0–RA2 als Ausgänge (definierter Zustand)
  *  [FIX-9] BOM: 100nF Keramik-C als Bypass empfohlen
+ *  [FIX-10] Prellender Weck-Druck würfelte (ST_WAKE hielt das erste
+ *          verworfene Prellen für einen Störimpuls) → WAKE_QUIET
+ *  [FIX-11] Druck während ee_save()/Protokoll: SLEEP trotz laufender
+ *          Entprellung → Taster hing bis zur nächsten Flanke
+ *  [FIX-12] Touch-Scan: TMR0 = t + Fenster lief über 255 → Tick fehlte;
+ *          jetzt TMR0IF nachgeholt
  *
  * ═══════════════════════════════════════════════════════════════════════
  */
 
 // ─── [FIX-6] _XTAL_FREQ VOR xc.h definieren ──────────────────────────
 // Damit __delay_ms() bei der Makro-Expansion die Frequenz kennt.
+// Gilt für Profil CLK_HF; die Firmware selbst nutzt keine __delay_ms().
 #define _XTAL_FREQ  4000000UL
 
 // ─── CONFIG BITS (PIC16F1825) ─────────────────────────────────────────
 // CONFIG1
 #pragma config FOSC     = INTOSC  // Interner Oszillator ← kein externer Takt!
-#pragma config WDTE     = OFF     // Watchdog Timer aus
+#if defined(BOARD_TOUCH) && BOARD_TOUCH
+#pragma config WDTE     = SWDTEN  // Watchdog nur per SWDTEN: weckt zum Touch-Scan
+#else
+#pragma config WDTE     = OFF     // Watchdog aus (Weck-Timer ist Timer1)
+#endif
 #pragma config PWRTE    = ON      // Power-Up Timer an
 #pragma config MCLRE    = OFF     // RA3/MCLR → digitaler I/O (kein Pullup-R!)
 #pragma config CP       = OFF     // Kein Code-Schutz
@@ -126,177 +160,652 @@
 #include <xc.h>
 #include <stdint.h>
 
-// ─── [FIX-5] LED-Bit-Definitionen (kollisionssichere Namen) ──────────
-// Originale Makros A–G können mit Standard-Headern kollidieren!
-// Bits 0–5 = LATC (RC0–RC5), Bit 6 = LATA5
-#define LED_A  (1u<<0)   // RC0 – oben links
-#define LED_B  (1u<<1)   // RC1 – oben rechts
-#define LED_C  (1u<<2)   // RC2 – mitte links
-#define LED_D  (1u<<3)   // RC3 – Zentrum (Auge)
-#define LED_E  (1u<<4)   // RC4 – mitte rechts
-#define LED_F  (1u<<5)   // RC5 – unten links
-#define LED_G  (1u<<6)   // RA5 – unten rechts  ← anderer Port!
-
-// ─── Würfelmuster ─────────────────────────────────────────────────────
-//  LED-Layout:     Würfel-Augen:
-//  [A] [B]         ● ●
-//  [C] [D] [E]     ● ● ●
-//  [F]     [G]     ●   ●
-static const uint8_t DICE[6] = {
-    LED_D,                                           // ⚀  1: Zentrum
-    LED_B | LED_F,                                   // ⚁  2: oben-rechts + unten-links
-    LED_B | LED_D | LED_F,                           // ⚂  3: Diagonale + Mitte
-    LED_A | LED_B | LED_F | LED_G,                   // ⚃  4: vier Ecken
-    LED_A | LED_B | LED_D | LED_F | LED_G,           // ⚄  5: Ecken + Mitte
-    LED_A | LED_B | LED_C | LED_E | LED_F | LED_G,   // ⚅  6: alle außer Mitte
+// ─── Board-Profil: LATC + LATA5, Port-Tabellen je Seite ──────────────
+// [FIX-5] LED-Makros heißen LED_x statt A–G (kollisionssicher)
+#include "board.h"
+
+// ─── Zeitbasis: Timer0-Tick ───────────────────────────────────────────
+// Timer0 @ 4MHz/4 mit Prescaler 1:4 → 1,024 ms Overflow = 1 Tick
+// (500 kHz: ohne Prescaler 2,048 ms = 2 Ticks, siehe Taktprofile).
+// Alle Zeiten der Ablaufsteuerung sind Ticks (MS() rechnet um).
+// tmr0_count zählt Overflows nur, solange der Kern läuft; now zählt
+// zusätzlich die verschlafenen Ticks mit.
+#define TICK_US        1024u
+#ifndef SLEEP_TIMEOUT                 // Varianten: -DSLEEP_TIMEOUT='MS(5000)', max. MS(32000)
+#define SLEEP_TIMEOUT  MS(10000)    // 10 Sekunden = 9766 Ticks
+#endif
+
+// ─── LED-Helligkeit: Software-PWM über Timer2 ────────────────────────
+// Ein Interrupt je Phase: Timer2 läuft bis PR2, die ISR schaltet um und
+// lädt PR2 für die nächste Phase. Je Periode (16 Einheiten) zuerst
+// Würfel 0 … DICE_N−1 je „Stufe“ Einheiten an, dann der Rest aus.
+// Periode 4,096 ms → jeder Würfel 244 Hz (flimmerfrei) in jedem
+// Taktprofil; ein Würfel: 488 statt 4000 Interrupts/s.
+// Stufe 16 = statisch an: Timer2 aus → der Kern darf schlafen.
+// Multiplex (DICE_N > 1): je Würfel höchstens 16/DICE_N Einheiten
+// (MUX_MAX), Timer2 läuft, solange ein Würfel leuchtet. Gedimmte Frames
+// (≤ MUX_MAX) leuchten je Würfel genau wie auf einem eigenen Gerät, volle
+// Helligkeit wird zu 1/DICE_N — LED-Energie nie mehr als DICE_N Geräte.
+// ISR je Phase: feste Folge ohne Schleife (PR2, LATA, LATC, LATA).
+#define PWM_STEPS     16u
+#define MUX_MAX       (PWM_STEPS / DICE_N)   // 16, 8, 5 Einheiten
+#define BRIGHT_FULL   16u    // Ergebnis, Blinken, Startup, Wake-Anzeige
+#define BRIGHT_FAST    2u    // Roll-Phase 1 (40-ms-Frames)
+#define BRIGHT_MID     3u    // Roll-Phase 2 (90-ms-Frames)
+#define BRIGHT_SLOW    4u    // Roll-Phase 3 (160-ms-Frames)
+#define BRIGHT_IDLE    2u    // Ergebnis kurz vor Auto-Sleep
+
+// Ausblenden im Idle: FADE_START voll, dann alle FADE_STEP eine Stufe
+// dunkler bis BRIGHT_IDLE
+#define FADE_START    MS(2000)
+#define FADE_STEP     MS(500)
+
+volatile uint8_t led_frame[DICE_N] = { FACE_OFF };   // Seite je Würfel
+volatile uint8_t pwm_level  = BRIGHT_FULL;
+volatile uint8_t mux_k      = 0;           // Phase: Würfel 0 … DICE_N−1, DICE_N = aus
+volatile uint8_t pwm_pr_on  = 0;           // PR2 für An-/Aus-Phase
+volatile uint8_t pwm_pr_off = 0;
+volatile uint8_t pwm_off    = 0;           // 1 = Aus-Phase je Periode
+#define LED_SCALE_1   128u
+static uint8_t   led_scale  = LED_SCALE_1; // Tastgrad aus VDD (vdd_check)
+
+// ─── Taktprofile: Kern wach nur so schnell wie nötig ─────────────────
+// wait_next() wählt je Wartezustand ein Profil; Timer0-Vorteiler und
+// Timer2 wechseln mit, damit Tick (1,024 ms) und PWM-Periode (4,096 ms)
+// gleich bleiben:
+//   CLK_HF  4 MHz    Entprellen (Tick-Abtastung), Arbeit nach jedem Wake
+//   CLK_MF  500 kHz  nur PWM hält den Kern wach (Roll-Frames, Ausblenden)
+// 31 kHz (LFINTOSC) reicht nicht für die PWM-ISR, 32 MHz (PLL) braucht
+// ~2 ms zum Einrasten (länger als jede Arbeitsphase) und VDD ≥ 2,5 V
+// → beide ohne Profil; im SLEEP ist der Takt ohnehin aus.
+// Ein Wechsel verschiebt die Tick-Phase um höchstens einen Tick.
+#define CLK_HF  0u
+#define CLK_MF  1u
+
+struct clk_profile {
+    uint8_t osccon;     // SPLLEN, IRCF<3:0>, SCS<1:0>
+    uint8_t option;     // OPTION_REG<3:0>: PSA, PS<2:0>
+    uint8_t ticks;      // Ticks je Timer0-Überlauf
+    uint8_t t2ckps;     // T2CON<1:0>: Timer2-Vorteiler
+    uint8_t shift;      // PWM-Einheit = 2^shift Timer2-Schritte
 };
 
-// ─── Zufallsquelle + Sleep-Timer ──────────────────────────────────────
-volatile uint8_t  tmr0_count   = 0;
-volatile uint16_t sleep_counter = 0;   // Zählt TMR0-Interrupts bis Sleep
-
-// Timer0 @ 4MHz/4 mit Prescaler 1:256 → ~61 Hz Overflow
-// 10 Sekunden = ~610 Interrupts
-#define SLEEP_TIMEOUT  610u
-
-// ─── [FIX-4] Timeout-Konstante für Taster-Warteschleifen ─────────────
-// Verhindert Endlosschleife bei verklemmtem/falsch verlötetem Taster.
-// 60000 × ca. 1 µs Schleifenzeit ≈ 60–120 ms max. Wartezeit
-#define BUTTON_TIMEOUT  60000u
-
-// ─── [FIX-2] Atomarer 16-Bit-Lesezugriff ─────────────────────────────
-// Auf einem 8-Bit-PIC wird uint16_t in ZWEI Schritten gelesen.
-// Die ISR kann genau dazwischen feuern → inkonsistenter Wert!
-static uint16_t read_sleep_counter(void) {
-    uint16_t val;
-    INTCONbits.GIE = 0;   // Interrupts sperren
-    val = sleep_counter;  // Atomar (kein ISR dazwischen)
-    INTCONbits.GIE = 1;   // Interrupts freigeben
-    return val;
+static const struct clk_profile CLK[2] = {
+    { 0x6Au, 0x01u, 1u, 0x02u, 4u },    // IRCF 1101, Timer0 1:4,  Timer2 1:16 × 256
+    { 0x3Au, 0x08u, 2u, 0x01u, 3u },    // IRCF 0111 (MFINTOSC), Timer0 1:1, Timer2 1:4 × 128
+};
+
+static uint8_t   clk = 0xFFu;             // aktives Profil (0xFF = noch keins)
+volatile uint8_t clk_ticks = 1u;          // für die ISR: Ticks je Überlauf
+
+// PR2-Werte der aktuellen Stufe für das aktive Profil. Die An-Phase
+// wird in Timer2-Schritten (256 bzw. 128 je Periode) mit led_scale
+// verkürzt, die Aus-Phase nimmt den Rest; led_scale = 128 ergibt genau
+// die Einheiten der Stufe.
+static void pwm_load(void) {
+    uint8_t  sh  = CLK[clk].shift;
+    uint8_t  on  = pwm_level < MUX_MAX ? pwm_level : MUX_MAX;
+    uint16_t t   = (uint16_t)(((uint16_t)on << sh) * led_scale) >> 7u;
+    uint16_t off;
+
+    if (!t) t = 1u;
+    off        = (uint16_t)((PWM_STEPS << sh) - DICE_N * t);
+    pwm_pr_on  = (uint8_t)(t - 1u);
+    pwm_pr_off = (uint8_t)(off - 1u);
+    pwm_off    = off != 0u;
 }
 
-// ─── [FIX-2] Atomarer 16-Bit-Schreibzugriff ──────────────────────────
-static void reset_sleep_counter(void) {
-    INTCONbits.GIE = 0;
-    sleep_counter = 0;
-    INTCONbits.GIE = 1;
+// Laufende PWM: Position in der Phase (in PWM-Einheiten) mitnehmen,
+// sonst verlängert der Wechsel die Phase um bis zu 3,6 ms.
+static void clk_set(uint8_t p) {
+    uint8_t u = 0;
+
+    if (p == clk) return;
+    if (T2CONbits.TMR2ON) u = TMR2 >> CLK[clk].shift;
+    clk        = p;
+    OSCCON     = CLK[p].osccon;
+    OPTION_REG = (OPTION_REG & 0xC0u) | CLK[p].option;   // [FIX-7] Bits 7+6 behalten
+    T2CON      = (T2CON & 0x04u) | CLK[p].t2ckps;        // TMR2ON behalten
+    clk_ticks  = CLK[p].ticks;
+    if (T2CONbits.TMR2ON) {
+        pwm_load();
+        PR2  = mux_k < DICE_N ? pwm_pr_on : pwm_pr_off;
+        TMR2 = (uint8_t)(u << CLK[p].shift);
+    }
+}
+
+// ─── PWM starten: An-Phase von Würfel 0 zuerst ────────────────────────
+static void pwm_start(void) {
+    mux_k = 0;
+    TMR2  = 0;
+    PR2   = pwm_pr_on;
+    PIR1bits.TMR2IF = 0;
+    led_die(0, led_frame[0]);
+    T2CONbits.TMR2ON = 1;
 }
 
+// ─── Frame setzen (Würfel k: Seite 0 … 5 oder FACE_OFF) ───────────────
+// Bei laufender PWM übernimmt die ISR die Seite mit der nächsten Phase
+// des Würfels (≤ 4 ms) → kein Wettlauf zwischen LATC/LATA-Zugriffen.
+// Multiplex: Timer2 läuft genau dann, wenn ein Würfel leuchtet.
+static void show_die(uint8_t k, uint8_t f) {
+#if DICE_N > 1
+    uint8_t j;
+
+    led_frame[k] = f;
+    for (j = 0; j < DICE_N; j++)
+        if (led_frame[j] != FACE_OFF) {
+            if (!T2CONbits.TMR2ON) pwm_start();
+            return;
+        }
+    T2CONbits.TMR2ON = 0;
+    led_out(FACE_OFF);               // alle abgewählt
+#else
+    led_frame[k] = f;
+    if (!T2CONbits.TMR2ON || f == FACE_OFF) led_out(f);   // aus: sofort
+#endif                                                     // (SLEEP danach)
+}
+
+static void show(uint8_t f) {
+    uint8_t k;
+    for (k = 0; k < DICE_N; k++) show_die(k, f);
+}
+
+// ─── Helligkeit umschalten ────────────────────────────────────────────
+// Läuft die PWM schon, gilt die neue Stufe ab der nächsten Phase.
+// Multiplex: show_die() hat Timer2 evtl. gerade mit der alten Stufe
+// gestartet → laufende An-Phase mit der neuen Länge neu beginnen.
+static void set_brightness(uint8_t level) {
+    pwm_level = level < BRIGHT_FULL ? level : BRIGHT_FULL;
+    pwm_load();
+#if DICE_N > 1
+    if (T2CONbits.TMR2ON) {
+        INTCONbits.GIE = 0;
+        if (mux_k < DICE_N) { TMR2 = 0; PR2 = pwm_pr_on; }
+        INTCONbits.GIE = 1;
+    }
+#else
+    if (pwm_level >= BRIGHT_FULL && led_scale >= LED_SCALE_1) {
+        T2CONbits.TMR2ON = 0;
+        led_out(led_frame[0]);       // statisch an
+    } else if (!T2CONbits.TMR2ON) {
+        pwm_start();
+    }
+#endif
+}
+
+// ─── Batterie: VDD über FVR + ADC, LED-Tastgrad nachführen ───────────
+// Der ADC misst die FVR (1,024 V) gegen VDD als Referenz:
+// ADC = 1023 · 1,024 V / VDD → VDD = 1 047 552 / ADC [mV].
+// Nur nach dem Einschalten und nach jedem Wake aus dem Auto-Sleep (nie
+// während eines Wurfs), danach FVR und ADC wieder aus. ADC-Takt FRC:
+// unabhängig vom Taktprofil; die erste Wandlung dient nur als
+// Einschwingzeit der FVR, gilt erst die zweite (~50 µs zusammen).
+// LED-Strom ≈ (VDD − LED_V0) / R, LED_V0 = Vf + Abfall am Port-Pin
+// (README_1825: 1,8 V + 0,7 V). Über VDD_REF wird die An-Phase so weit
+// gekürzt, dass der mittlere Strom dem bei VDD_REF entspricht:
+// led_scale = 128 · (VDD_REF − LED_V0) / (VDD − LED_V0). Darunter 128 =
+// wie bisher (volle Helligkeit statisch, Timer2 aus).
+// Unter VDD_LOW (BORV = LO: Brown-Out bei ~1,9 V) zeigt der Wake das
+// Warnmuster FACE_LOW statt der letzten Zahl.
+#define LED_V0_MV     2500u
+#define VDD_REF_MV    2800u
+#define VDD_LOW_MV    2100u
+
+static uint8_t vdd_low;              // 1 = Batterie fast leer
+
+static uint16_t adc_read(void) {
+    ADCON0bits.GO_nDONE = 1;
+    while (ADCON0bits.GO_nDONE) continue;
+    return (uint16_t)((uint16_t)ADRESH << 8u) | ADRESL;
+}
+
+static void vdd_check(void) {
+    uint16_t adc, mv;
+
+    FVRCON = 0x81u;                  // FVREN, ADFVR = 01 → 1,024 V
+    ADCON1 = 0xF0u;                  // ADFM rechtsbündig, ADCS = FRC, VREF+ = VDD
+    ADCON0 = 0x7Du;                  // CHS = 11111 (FVR), ADON
+    (void)adc_read();                // FVR einschwingen lassen
+    adc    = adc_read();
+    ADCON0 = 0x00u;
+    FVRCON = 0x00u;
+
+    mv = adc >= 16u ? (uint16_t)(1047552UL / adc) : 0xFFFFu;   // < 16: Überlauf
+    vdd_low   = mv < VDD_LOW_MV;
+    led_scale = mv <= VDD_REF_MV ? LED_SCALE_1 :
+                (uint8_t)((uint16_t)(LED_SCALE_1 * (VDD_REF_MV - LED_V0_MV)) /
+                          (uint16_t)(mv - LED_V0_MV));
+    set_brightness(pwm_level);       // Timer2 an/aus nach neuem Tastgrad
+}
+
+// ─── Idle-Ausblendung: Stufe aus der Inaktivitätszeit ────────────────
+static uint8_t fade_level(uint16_t idle) {
+    uint16_t steps;
+    if (idle <= FADE_START) return BRIGHT_FULL;
+    steps = (idle - FADE_START) / FADE_STEP;
+    if (steps >= BRIGHT_FULL - BRIGHT_IDLE) return BRIGHT_IDLE;
+    return (uint8_t)(BRIGHT_FULL - steps);
+}
+
+// ─── Gemeinsamer Kern: Taster, Zufall, Zustände, Animationen ─────────
+#include "dice_core.h"
+
+#if BOARD_TOUCH
+// ─── Touch-Taste: CPS-Modul statt Taster (-DBOARD_TOUCH=1) ───────────
+// Kupferfläche (~10 pF, unter der Frontplatte) an RA2 = CPS2 statt des
+// Tasters an RA4: nichts prellt, nichts verschleißt. Der CPS-Oszillator
+// lädt die Fläche mit 18 µA (hoher Bereich), ein Finger (~+2,5 pF) macht
+// ihn ~20 % langsamer. Timer0 zählt ihn (TMR0CS = 1, T0XCS) über ein
+// festes Fenster TOUCH_GATE_US: ~77 frei, ~61 berührt (600 kHz). Timer0
+// ist dafür kurz ausgeliehen, die Tick-Phase danach um das Fenster
+// weitergestellt. Kein Interrupt meldet eine Berührung, also Scans:
+//   Kern wach (Tick läuft)   jeden TOUCH_EVERY. Überlauf, während der
+//                            Entprellung jeden Tick (ISR)
+//   SLEEP bis zum Termin     WDT weckt alle ~16 ms (TOUCH_WDT_RUN)
+//   Auto-Sleep               WDT weckt alle ~64 ms (TOUCH_WDT_SLEEP),
+//                            Scan mit 500 kHz
+// Detektor mit Grundlinie (gleitendes Mittel 1/16, nur unberührt →
+// folgt Feuchte und Temperatur): berührt unter Grundlinie − 1/8, frei
+// wieder ab Grundlinie − 1/16 (Hysterese). Klebt die Berührung
+// TOUCH_STUCK Scans nach der Entprellung (Wassertropfen, ~4 … 16 s),
+// gilt der Stand als neue Grundlinie.
+// touch_on ersetzt den Pin (BTN_IS_LOW): ein Wechsel gegenüber btn_level
+// startet dieselbe Abtastung wie eine IOC-Flanke → EV_PRESS, EV_RELEASE,
+// EV_LONG unverändert.
+#define TOUCH_GATE_US    128u            // Zählfenster (< 256 Schwingungen)
+#define TOUCH_EVERY      16u             // Überläufe je Scan (Zweierpotenz)
+#define TOUCH_STUCK      255u
+#define TOUCH_CH         2u              // CPSCON1: CPS2 = RA2
+#define TOUCH_CPS        0x8Du           // CPSON, CPSRNG = 11 (18 µA), T0XCS
+#define TOUCH_WDT_RUN    0x09u           // WDTPS 1:512  ≈ 16 ms, SWDTEN
+#define TOUCH_WDT_SLEEP  0x0Du           // WDTPS 1:2048 ≈ 64 ms, SWDTEN (kurzer Tipp ~100 ms)
+
+static uint8_t  touch_on;            // 1 = berührt (Detektor)
+static uint8_t  touch_n;             // letzter Zählerstand
+static uint16_t touch_base;          // Grundlinie · 16 (0 = noch keine)
+static uint8_t  touch_hold;          // Scans berührt nach der Entprellung
+static uint8_t  touch_div;           // Überläufe bis zum nächsten Scan
+
+// Aus ISR oder mit GIE = 0 (Timer0 gehört so lange dem Scan)
+static uint8_t touch_scan(void) {
+    uint8_t t = TMR0, n;
+    uint8_t g = clk == CLK_HF ? TOUCH_GATE_US / 4u : TOUCH_GATE_US / 8u;   // Fenster in Timer0-Schritten
+    uint8_t b;
+
+    OPTION_REG = (OPTION_REG & 0xC0u) | 0x28u;   // TMR0CS → CPS, PSA: 1:1
+    CPSCON0    = TOUCH_CPS;
+    TMR0       = 0;
+    if (clk == CLK_HF) _delay(TOUCH_GATE_US);           // 1 Tcy = 1 µs
+    else               _delay(TOUCH_GATE_US / 8u);      // 500 kHz: 8 µs
+    n          = TMR0;
+    CPSCON0    = 0x00u;                                 // Oszillator aus
+    OPTION_REG = (OPTION_REG & 0xC0u) | CLK[clk].option;
+    // [FIX-12] Phase um das Fenster weiter. Läuft sie dabei über (Scan
+    // nach dem SLEEP, t beliebig), fehlte sonst ein Tick: TMR0IF selbst
+    // setzen, der Rest bleibt in TMR0 (ISR bzw. nach GIE = 1).
+    if ((uint8_t)(t + g) < t) INTCONbits.TMR0IF = 1;
+    TMR0       = (uint8_t)(t + g);
+
+    touch_n = n;
+    b = (uint8_t)(touch_base >> 4u);
+    if (!touch_base) {
+        touch_base = (uint16_t)n << 4u;                 // erster Scan
+    } else if (!touch_on) {
+        if ((uint16_t)n + (b >> 3u) < b) {
+            touch_on   = 1;
+            touch_hold = 0;
+        } else {
+            touch_base = (uint16_t)(touch_base - b + n);
+        }
+    } else if ((uint16_t)n + (b >> 4u) >= b) {
+        touch_on = 0;
+    } else if (!btn_busy && ++touch_hold == TOUCH_STUCK) {
+        touch_base = (uint16_t)n << 4u;                 // klebt: neue Grundlinie
+        touch_on   = 0;
+    }
+    return touch_on;
+}
+
+// Zustand weicht vom entprellten ab: Abtastung starten wie die erste
+// IOC-Flanke (Zählerstand + LFINTOSC = Entropie)
+static void touch_edge(uint8_t k) {
+    btn_t0   = touch_n ^ TMR1L;
+    TMR0     = 0;
+    btn_busy = 1;
+    TRACE_EDGE(k);
+    btn_sample(k);
+}
+
+static void touch_check(void) {
+    uint8_t k = touch_scan();
+    if (k != btn_level) touch_edge(k);
+}
+#endif
+
 // ─── Interrupt Service Routine ────────────────────────────────────────
 void __interrupt() isr(void) {
-    // Timer0: Zufallsquelle + Sleep-Counter
+    uint8_t k;
+
+    // Timer2: Ende einer PWM-Phase → nächster Würfel bzw. Aus-Phase.
+    // PR2 zuerst: Timer2 zählt schon weiter, bei 500 kHz ist eine
+    // Einheit nur 32 Tcy.
+    if (PIR1bits.TMR2IF) {
+        PIR1bits.TMR2IF = 0;
+        k = mux_k + 1u;
+        if (k == DICE_N && pwm_off) {
+            PR2 = pwm_pr_off;
+            led_out(FACE_OFF);
+        } else {
+            if (k >= DICE_N) k = 0;
+            PR2 = pwm_pr_on;
+            led_die(k, led_frame[k]);
+        }
+        mux_k = k;
+    }
+    // Timer0: Tick für Ablaufsteuerung, Entprellung
     if (INTCONbits.TMR0IF) {
-        tmr0_count++;
-        sleep_counter++;
+        tmr0_count += clk_ticks;
+        TRACE_TICK(clk_ticks);
         INTCONbits.TMR0IF = 0;
+#if BOARD_TOUCH
+        if (btn_busy)                                 btn_sample(touch_scan());
+        else if (!(++touch_div & (TOUCH_EVERY - 1u))) touch_check();
+#else
+        if (btn_busy) btn_sample(BTN_IS_LOW());
+#endif
     }
-    // Interrupt-on-Change RA4: Wake-Up vom Sleep
+#if !BOARD_TOUCH
+    // Interrupt-on-Change RA4: beide Flanken, weckt aus jedem SLEEP
     // [FIX-3] IOCIF ist READ-ONLY auf PIC16F1825!
     // Es wird automatisch gelöscht, sobald alle IOCxFy-Flags = 0.
     // Manuelles Löschen von IOCIF hat KEINE Wirkung → nur IOCAF4 löschen!
     if (INTCONbits.IOCIF) {
         if (IOCAFbits.IOCAF4) {        // RA4 hat Flanke ausgelöst
             IOCAFbits.IOCAF4 = 0;     // Sub-Flag löschen → IOCIF geht auto auf 0
-            sleep_counter = 0;        // Sleep-Timer zurücksetzen (in ISR atomar OK)
+            if (!btn_busy) {          // erste Flanke: Abtastung starten
+                btn_t0   = TMR0 ^ TMR1L;   // Phase im Tick + LFINTOSC = Entropie
+                TMR0     = 0;         // nächster Überlauf genau 1 Tick-Periode später
+                btn_busy = 1;
+                k        = BTN_IS_LOW();
+                TRACE_EDGE(k);
+                btn_sample(k);
+            } else {
+                TRACE_BOUNCE();       // Prellen: zählt zum nächsten Taster-Ereignis
+            }
         }
     }
+#endif
 }
 
-// ─── Variable Delay ───────────────────────────────────────────────────
-static void delay_ms(uint16_t ms) {
-    while (ms--) __delay_ms(1);
-}
-
-// ─── [FIX-1] LED-Ausgabe: LATx statt PORTx (kein RMW!) ───────────────
-// Der PIC16F1825 hat LAT-Register → immer LATx für Ausgaben verwenden!
-// PORTx schreibt über Read-Modify-Write und kann bei schnellen
-// aufeinanderfolgenden Zugriffen falsche Pin-Zustände erzeugen.
-// (PIC16F84A hatte KEINE LAT-Register — dort gab es das RMW-Problem!)
-static void show(uint8_t pattern) {
-    LATC = pattern & 0x3Fu;                    // RC0–RC5 via LATC
-    LATAbits.LATA5 = (pattern >> 6u) & 1u;    // RA5 via LATA5
+// ─── Sleep-Modus aktivieren ───────────────────────────────────────────
+// IOC auf RA4 ist dauerhaft scharf → hier nur LEDs aus und den Stand
+// sichern (nur nach neuen Würfen), dazu das Ereignis-Protokoll.
+static void enter_sleep(void) {
+    show(FACE_OFF);                  // LEDs aus
+    set_brightness(BRIGHT_FULL);     // Timer2 aus; gedrosselter Tastgrad: läuft weiter
+    ee_save();                       // neue Würfe → EEPROM (~32 ms)
+    TRACE(TR_SLEEP, 0u);
+    TRACE_FLUSH();                   // neue Ereignisse → EEPROM (~4 ms je Byte)
+
+    T1CONbits.TMR1ON = 0;            // Timer1 aus (nur IOC bzw. WDT weckt)
+#if BOARD_TOUCH
+    // Scan je WDT-Wake, bis die Fläche ihren Zustand wechselt; 500 kHz:
+    // weniger Ladung je Scan als 4 MHz (Fenster gleich lang). Nur der
+    // WDT weckt: TMR0IE und PEIE aus, sonst machte ein Timer0-Überlauf
+    // oder eine PWM-Periode (gedrosselter Tastgrad, Timer2 läuft) zwischen
+    // den Scans jedes weitere SLEEP zum NOP (GIE = 0, Flag bleibt stehen).
+    clk_set(CLK_MF);
+    INTCONbits.GIE = 0;
+    if (!btn_busy) {                 // Abtastung läuft schon: SLEEP entfällt
+        INTCONbits.TMR0IE = 0;
+        INTCONbits.PEIE   = 0;
+        do {
+            WDTCON = TOUCH_WDT_SLEEP;
+            SLEEP();                 // ~1,5 µA mit WDT
+            NOP();
+            WDTCON = 0x00u;
+        } while (touch_scan() == btn_level);
+        INTCONbits.PEIE   = 1;
+        INTCONbits.TMR0IE = 1;       // anstehende Flags → ISR nach GIE = 1
+        touch_edge(touch_on);
+    }
+    INTCONbits.GIE = 1;
+#else
+    // [FIX-11] Druck während des Schreibens: Entprellung läuft (Timer0
+    // stünde im SLEEP) oder ist schon fertig (EV_PRESS wartet auf step())
+    // → wach bleiben. Spätere Flanke: IOCAF4 bleibt stehen (GIE = 0),
+    // SLEEP wirkt wie NOP. Nur IOC weckt: TMR0IE und PEIE aus wie beim
+    // Touch — ein Timer0-Überlauf oder (gedrosselter Tastgrad, Timer2
+    // läuft weiter) eine PWM-Periode direkt vor SLEEP hielte den Würfel
+    // sonst einen ganzen Timeout lang wach.
+    INTCONbits.GIE = 0;
+    if (!btn_busy && !btn_events) {
+        INTCONbits.TMR0IE = 0;
+        INTCONbits.PEIE   = 0;
+        SLEEP();                     // PIC schlafen legen (~1 µA)
+        NOP();                       // Nach Wake-Up hier weitermachen
+        INTCONbits.PEIE   = 1;
+        INTCONbits.TMR0IE = 1;       // anstehende Flags → ISR nach GIE = 1
+    }
+    INTCONbits.GIE = 1;              // Weck-Flanke → ISR startet Entprellung
+#endif
+    t_seen = tmr0_count;             // now steht im Auto-Sleep, auch beim Schreiben
+    T1CONbits.TMR1ON = 1;
+    TRACE(TR_WAKE, btn_busy);        // ISR (IOC bzw. Touch) lief schon
+    vdd_check();                     // Batterie: Tastgrad, Warnung
 }
 
-// ─── [FIX-4] Taster auf RA4: mit Timeout-Absicherung ─────────────────
-static uint8_t button_pressed(void) {
-    uint16_t timeout;
-    if (!PORTAbits.RA4) {            // Erste Abfrage: gedrückt?
-        delay_ms(25);                // Entprellung (25 ms)
-        if (!PORTAbits.RA4) {        // Immer noch gedrückt?
-            timeout = BUTTON_TIMEOUT;
-            while (!PORTAbits.RA4 && --timeout);
-            delay_ms(15);            // Loslassen entprellen
-            return 1;
+// ─── Ein Schritt der Ablaufsteuerung ──────────────────────────────────
+static void step(void) {
+    uint16_t idle;
+    uint8_t  level;
+
+    // Taster-Ereignisse aus der ISR; Zeitstempel → Tick-Uhr der Schleife
+    if (btn_events & EV_PRESS) {
+        btn_events &= (uint8_t)~EV_PRESS;
+        if (state == ST_WAKE)         state = ST_SHOW;    // Weck-Druck würfelt nicht
+#if BOARD_PROFILES
+        else if (state == ST_STARTUP) prof_sel = 1;       // lang → Profil, kurz → Wurf
+#endif
+        else start_roll(now - (int8_t)(t_seen - btn_t_press));
+    }
+    if (btn_events & EV_RELEASE) {
+        btn_events &= (uint8_t)~EV_RELEASE;
+        rng_mix((uint8_t)(btn_t_release - btn_t_press));   // Druckdauer
+#if BOARD_PROFILES
+        if (prof_sel) {
+            prof_sel = 0;
+            start_roll(now - (int8_t)(t_seen - btn_t_release));
         }
+#endif
     }
-    return 0;
-}
-
-// ─── Würfel-Roll-Animation ────────────────────────────────────────────
-static void roll_animation(uint8_t final_idx) {
-    uint8_t  i;
-    uint16_t pause;
-
-    for (i = 0; i < 24u; i++) {
-        show(DICE[(tmr0_count + i) % 6u]);
-        if      (i <  8u) pause = 40;    // Schnell (erste 8 Bilder)
-        else if (i < 16u) pause = 90;    // Mittel
-        else               pause = 160;  // Langsam (letzte 8)
-        delay_ms(pause);
+    if (btn_events & EV_LONG) {
+        btn_events &= (uint8_t)~EV_LONG;
+#if BOARD_PROFILES
+        if (prof_sel) { prof_sel = 0; prof_next(); }
+#endif
     }
-    show(DICE[final_idx]);   // Endergebnis anzeigen
-}
 
-// ─── Ergebnis-Blinken ─────────────────────────────────────────────────
-static void blink_result(uint8_t pattern) {
-    uint8_t i;
-    for (i = 0; i < 3u; i++) {
-        show(0x00);     delay_ms(100);  // Aus
-        show(pattern);  delay_ms(200);  // An
+    switch (state) {
+    case ST_IDLE:
+    case ST_SHOW:
+        idle = now - idle_since;
+        if (idle >= SLEEP_TIMEOUT) {
+            state = ST_SLEEP;                // Timeout → nächster Schritt schläft
+        } else if (state == ST_SHOW) {
+            // Ergebnis-Anzeige bis zum Auto-Sleep langsam ausblenden
+            level = fade_level(idle);
+            if (led_frame[0] != FACE_OFF && level != pwm_level) set_brightness(level);
+        }
+        break;
+    case ST_SLEEP:
+        enter_sleep();
+
+        // Nach Wake-Up: letzte Zahl anzeigen (Batterie fast leer: ─ ─),
+        // Weck-Druck entprellen
+        if (vdd_low) show(FACE_LOW);
+        else         show_last();
+        TRACE(TR_SHOW, last_result[0]);
+        idle_since = now;
+        state      = ST_WAKE;
+        break;
+    case ST_WAKE:                            // [FIX-10] Prellen ≠ Störimpuls
+        if (btn_busy) idle_since = now;
+        else if ((uint16_t)(now - idle_since) >= WAKE_QUIET)
+            state = ST_SHOW;                 // Störimpuls: kein Druck bestätigt
+        break;
+    case ST_STARTUP:
+    case ST_ROLLING:
+    case ST_BLINK:
+        if ((int16_t)(now - due) >= 0) anim_due();
+        break;
     }
 }
 
-// ─── [FIX-7] Startup endet mit LEDs AUS ──────────────────────────────
-// Original ließ DICE[0] dauerhaft leuchten → unnötiger Stromverbrauch
-// bis zum ersten Tastendruck.
-static void startup_seq(void) {
-    uint8_t i;
-    for (i = 0; i < 6u; i++) { show(DICE[i]); delay_ms(140); }
-    show(DICE[0]); delay_ms(400);
-    show(0x00);    delay_ms(200);   // LEDs aus → bereit
+// ─── Bis zum nächsten Termin warten ──────────────────────────────────
+// Gedimmte LEDs oder Entprellung läuft: Kern wach bis zum nächsten
+// Timer0-Überlauf — nur PWM mit 500 kHz, Entprellen mit 4 MHz.
+// Vor jedem SLEEP zurück auf 4 MHz: die Arbeit nach dem Wake ist kurz.
+// Sonst tickless: EIN SLEEP bis zum Termin (Frame, Ausblenden oder
+// Auto-Sleep), Timer1 weckt mit dem Überlauf, jede Tasterflanke früher
+// über IOC. Timer1 zählt LFINTOSC/8 asynchron, auch im SLEEP, und läuft
+// danach frei weiter → die verschlafene Zeit steht nach jedem Wake fest
+// (auch beim frühen IOC-Wake), TMR1L dient nebenbei als Entropie.
+// Schritt = 8/LFINTOSC ≈ 258 µs ≈ t1_k/512 Tick (Rest in t1_rest),
+// Termin in Schritten = Ticks · t1_r/64 → eher knapp zu früh als zu spät.
+// Beide Faktoren misst lf_cal() beim Einschalten (Nennwert 31 kHz: 129
+// bzw. 254 = 4 − 1/32).
+// 10 s bis zum Auto-Sleep: 1 Wake statt ~300 mit WDT-Abschnitten.
+#define T1_RUN       0xF5u           // TMR1CS = LFINTOSC, 1:8, nT1SYNC, TMR1ON
+#define T1_MAX       12000           // Ticks je SLEEP (< 65536 Schritte bis t1_k = 100)
+
+static uint16_t t1_rest;             // 1/512-Ticks aus Timer1-Schritten
+
+// ─── LFINTOSC gegen HFINTOSC messen (einmal beim Einschalten) ────────
+// LFINTOSC streut ±15 % (DS41440E), HFINTOSC ist ab Werk auf ±2 %
+// abgeglichen. Gemessen werden 256 Timer1-Schritte in Timer0-Ticks
+// (4 MHz, 1 Tick = 1024 Tcy, GIE = 0, TMR0IF per Abfrage), ~66 ms:
+//   t1_k = (Ticks · 512 + TMR0 · 2) / 256 = 2 · Ticks + TMR0 / 128
+//   t1_r = 32768 / t1_k                    (abgerundet → eher zu früh)
+// Start und Ende an einer Schrittgrenze derselben Abfrageschleife.
+// Steht Timer1 oder liegt t1_k außerhalb 100 … 170, bleibt der Nennwert.
+#define T1_K_NOM     129u
+#define T1_CAL_TMO   200u            // Ticks ohne 256 Schritte → Abbruch
+
+static uint8_t  t1_k = T1_K_NOM;     // 1/512 Tick je Timer1-Schritt
+static uint16_t t1_r = 32768u / T1_K_NOM;   // 1/64 Schritt je Tick
+
+static void lf_cal(void) {
+    uint8_t  l, lo, n = 0, ticks = 0;
+    uint16_t k;
+
+    l = TMR1L;
+    for (;;) {
+        if (INTCONbits.TMR0IF) {
+            INTCONbits.TMR0IF = 0;
+            if (++ticks > T1_CAL_TMO) return;       // Timer1 steht
+        }
+        if (TMR1L == l) continue;
+        l = TMR1L;
+        if (!n++) {                                 // erste Schrittgrenze: Start
+            TMR0  = 0;
+            INTCONbits.TMR0IF = 0;
+            ticks = 0;
+        } else if (!n) {
+            break;                                  // 256 Schritte später
+        }
+    }
+    lo = TMR0;
+    if (INTCONbits.TMR0IF && !(lo & 0x80u)) ticks++;   // Überlauf vor dem Lesen
+    INTCONbits.TMR0IF = 0;
+    k = (uint16_t)(2u * ticks) + (((uint16_t)lo + 64u) >> 7u);
+    if (k < 100u || k > 170u) return;
+    t1_k = (uint8_t)k;
+    t1_r = (uint16_t)(32768u / k);
 }
 
-// ─── Sleep-Modus aktivieren ───────────────────────────────────────────
-static void enter_sleep(void) {
-    show(0x00);                      // LEDs aus
-
-    // Interrupt-on-Change für RA4 aktivieren (negative Flanke = Tastendruck)
-    IOCAPbits.IOCAP4 = 0;            // Positive Edge disabled
-    IOCANbits.IOCAN4 = 1;            // Negative Edge enabled (Taster drücken)
-    IOCAFbits.IOCAF4 = 0;            // Altes Flag löschen VOR Aktivierung!
-    INTCONbits.IOCIE = 1;            // IOC Interrupt aktivieren
-
-    // Sleep-Counter zurücksetzen
-    sleep_counter = 0;               // Kein Interrupt-Risiko (schlafen gleich)
+// Asynchron: High-Byte vor und nach dem Low-Byte gleich → Stand konsistent
+static uint16_t t1_read(void) {
+    uint8_t h, l;
 
-    SLEEP();                         // PIC schlafen legen (~1 µA)
-    NOP();                           // Nach Wake-Up hier weitermachen
+    do {
+        h = TMR1H;
+        l = TMR1L;
+    } while (h != TMR1H);
+    return (uint16_t)((uint16_t)h << 8u) | l;
+}
 
-    // Nach Wake-Up: IOC deaktivieren (nur TMR0 + Button-Polling)
-    INTCONbits.IOCIE = 0;
-    IOCANbits.IOCAN4 = 0;
+static void wait_next(void) {
+    uint8_t  d;
+    int16_t  left;
+    uint16_t n, t1;
+    uint32_t q;
+
+    if ((T2CONbits.TMR2ON && led_frame[0] != FACE_OFF) || btn_busy) {
+        clk_set(btn_busy ? CLK_HF : CLK_MF);
+        while (tmr0_count == t_seen) NOP();
+    } else {
+        clk_set(CLK_HF);
+        if (ANIMATING())
+            left = (int16_t)(due - now);
+        else if (state == ST_SHOW && led_frame[0] != FACE_OFF)     // noch voll
+            left = (int16_t)(idle_since + FADE_START + FADE_STEP - now);   // 1. Stufe
+        else if (state == ST_WAKE)
+            left = (int16_t)(idle_since + WAKE_QUIET - now);
+        else
+            left = (int16_t)(idle_since + SLEEP_TIMEOUT - now);
+        if (left < 0) left = 0;             // Termin fällig: nicht schlafen
+        if (left > T1_MAX) left = T1_MAX;
+        n = (uint16_t)(((uint32_t)(uint16_t)left * t1_r) >> 6u);        // Schritte
+
+        // Ticks aus step() noch offen (Wurf, Frame, VDD-Messung): erst
+        // nachtragen, der Termin liegt dann evtl. schon zurück
+        INTCONbits.GIE = 0;                 // Flanke zwischen Prüfen und SLEEP
+        if (left && !btn_busy && tmr0_count == t_seen) {   // → IOCAF4 steht, SLEEP = NOP
+            t1 = (uint16_t)(0u - n);        // Überlauf nach n Schritten
+            T1CONbits.TMR1ON = 0;           // asynchron: nur gestoppt schreiben
+            TMR1H = (uint8_t)(t1 >> 8u);
+            TMR1L = (uint8_t)t1;
+            T1CON = T1_RUN;
+            PIR1bits.TMR1IF = 0;
+            PIE1bits.TMR1IE = 1;            // weckt nur (GIE = 0, keine ISR)
+#if BOARD_TOUCH
+            WDTCON = TOUCH_WDT_RUN;         // … ebenso der WDT zum Scan
+#endif
+            SLEEP();
+            NOP();
+#if BOARD_TOUCH
+            WDTCON = 0x00u;
+#endif
+            PIE1bits.TMR1IE = 0;
+            PIR1bits.TMR1IF = 0;
+            q       = (uint32_t)(uint16_t)(t1_read() - t1) * t1_k + t1_rest;
+            n       = (uint16_t)(q >> 9u);
+            t1_rest = (uint16_t)q & 0x1FFu;
+            now    += n;
+            TRACE_TICK(n);                  // GIE = 0: trace_t gehört uns
+#if BOARD_TOUCH
+            touch_check();                  // nach jedem Wake (WDT, Termin)
+#endif
+        }
+        INTCONbits.GIE = 1;
+    }
+    d       = (uint8_t)(tmr0_count - t_seen);   // ab t_seen: auch die aus step()
+    t_seen += d;
+    now    += d;
 }
 
 // ─── MAIN ─────────────────────────────────────────────────────────────
 void main(void) {
-    uint8_t  result;
-    uint8_t  last_result = 0;   // Letzte gewürfelte Zahl merken
-    uint16_t timeout;           // [FIX-4] Für Wake-Up-Taster-Timeout
+#if BOARD_TOUCH
+    uint8_t k;
+#endif
 
-    // ── Interner Oszillator auf 4 MHz ─────────────────────────────────
-    // OSCCON: IRCF<3:0> = 1101 → 4 MHz (Datasheet DS41440E, Table 5-1)
-    OSCCONbits.IRCF = 0b1101;   // 4 MHz
-    OSCCONbits.SCS  = 0b10;     // Interner Oszillator als Taktquelle
+    // ── Interner Oszillator: Profil CLK_HF (4 MHz) ───────────────────
+    // OSCCON: IRCF<3:0> = 1101 → 4 MHz (Datasheet DS41440E, Table 5-1),
+    // SCS = 10 interner Oszillator; dazu Timer0 1:4, Timer2 1:16
+    clk_set(CLK_HF);
 
     // ── ANALOG-DISABLE: PFLICHT auf PIC16F1825! ───────────────────────
     // Ohne diese Zeilen funktioniert digitale I/O NICHT!
@@ -309,55 +818,69 @@ void main(void) {
     // RA4 = 1 (Taster-Eingang)
     // RA5 = 0 (LED g Ausgang)
     // [FIX-8] RA0–RA2 = 0 (Ausgang, LOW) → definierter Zustand!
+#if BOARD_TOUCH
+    // Touch: RA2 analoger Eingang (CPS2), RA4 ohne Taster → LOW-Ausgang
+    ANSELA = 0b00000100;
+    TRISA  = 0b00001100;
+#else
     TRISA = 0b00011000;
+#endif
     TRISC = 0b00000000;   // Port C: alle Ausgänge (LEDs a–f)
 
     // [FIX-1] LAT-Register für Ausgangszustand initialisieren
     LATA = 0x00;
     LATC = 0x00;
+#if DICE_N > 1
+    show(FACE_OFF);              // Würfel 1 … DICE_N−1: Frame „aus“
+#endif
 
     // ── Interne Pull-Ups aktivieren ───────────────────────────────────
     OPTION_REGbits.nWPUEN = 0;   // Pull-Ups global aktivieren
+#if BOARD_TOUCH
+    WPUA = 0b00000000;            // kein Taster, Pull-Up würde die Fläche laden
+#else
     WPUA = 0b00010000;            // WPUA4 = 1 → Pull-Up auf RA4 (Taster)
+#endif
     WPUC = 0b00000000;            // Port C: keine Pull-Ups (Ausgänge)
 
-    // ── Timer0: freilaufend für Zufallsgenerator ──────────────────────
-    // [FIX-7] Bits 7+6 (nWPUEN + INTEDG) korrekt beibehalten!
-    OPTION_REG = (OPTION_REG & 0xC0u) | 0b00000111u;
+    // ── Timer0: Tick 1,024 ms (Prescaler aus clk_set) ─────────────────
+    // ── Timer2: PWM (startet erst bei gedimmten LEDs, PR2 je Phase) ───
+    PIE1bits.TMR2IE   = 1;
+    // ── Timer1: Weck-Termin, läuft frei mit (LFINTOSC/8, asynchron) ──
+    T1CON = T1_RUN;
+    lf_cal();                 // Schrittlänge gegen HFINTOSC (~66 ms, GIE = 0)
+
+#if BOARD_TOUCH
+    // ── Touch-Fläche: Kanal wählen, Grundlinie aus den ersten Scans ──
+    CPSCON1 = TOUCH_CH;
+    for (k = 0; k < 8u; k++) (void)touch_scan();
+#else
+    // ── Interrupt-on-Change RA4: beide Flanken → Entprellung + Wake ──
+    IOCAPbits.IOCAP4 = 1;     // Positive Edge (Taster loslassen)
+    IOCANbits.IOCAN4 = 1;     // Negative Edge (Taster drücken)
+    IOCAFbits.IOCAF4 = 0;     // Altes Flag löschen VOR Aktivierung!
+    INTCONbits.IOCIE = 1;
+#endif
 
     INTCONbits.TMR0IE = 1;   // Timer0 Interrupt aktivieren
+    INTCONbits.PEIE   = 1;   // Peripherie-Interrupts (Timer2)
     INTCONbits.GIE    = 1;   // Global Interrupt Enable
 
-    // ── Startup ───────────────────────────────────────────────────────
+    // ── Gespeicherter Stand: letzte Zahl, Zufallszustand, Wurfzähler ─
+    ee_load();
+    TRACE_LOAD();                // Kopf des Protokolls im EEPROM
+    TRACE(TR_BOOT, 0u);
+    vdd_check();                 // Batterie: LED-Tastgrad vor dem ersten Frame
+#if BOARD_PROFILES
+    if (BTN_IS_LOW()) btn_busy = 1;   // beim Einschalten gedrückt (keine IOC-Flanke)
+#endif
+
+    // ── Startup: läuft über step(), schläft zwischen den Frames ───────
     startup_seq();               // [FIX-7] Endet mit LEDs aus
-    reset_sleep_counter();       // [FIX-2] Atomarer Reset
 
-    // ── Hauptschleife mit Auto-Sleep ──────────────────────────────────
+    // ── Hauptschleife: ein Schritt, dann schlafen bis zum Termin ──────
     while (1) {
-        // [FIX-2] Atomarer 16-Bit-Vergleich (sleep_counter ist uint16_t!)
-        if (read_sleep_counter() >= SLEEP_TIMEOUT) {
-            enter_sleep();
-
-            // Nach Wake-Up: letzte Zahl kurz anzeigen
-            show(DICE[last_result]);
-            delay_ms(800);
-
-            // [FIX-4] Warten bis Taster losgelassen MIT Timeout
-            timeout = BUTTON_TIMEOUT;
-            while (!PORTAbits.RA4 && --timeout);
-            delay_ms(25);
-
-            reset_sleep_counter();    // [FIX-2] Atomar zurücksetzen
-        }
-
-        // Normal: auf Tastendruck warten
-        if (button_pressed()) {
-            reset_sleep_counter();    // [FIX-2] Activity → Sleep-Timer zurück
-            result = tmr0_count % 6u;
-            roll_animation(result);
-            delay_ms(500);
-            blink_result(DICE[result]);
-            last_result = result;     // Ergebnis merken für Wake-Up
-        }
+        step();
+        wait_next();
     }
 }